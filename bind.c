@@ -253,6 +253,7 @@ MYLOG(DETAIL_LOG_LEVEL, "Bind column 0 is type %d not of type SQL_C_BOOKMARK\n",
 
 	/* Reset for SQLGetData */
 	GETDATA_RESET(gdata_info->gdata[icol]);
+	ARD_bindings_changed(opts);
 
 	if (rgbValue == NULL)
 	{
@@ -464,7 +465,7 @@ MYLOG(DETAIL_LOG_LEVEL, "num_params=%d,%d\n", stmt->num_params, stmt->proc_retur
 		po_ind_t multi = FALSE, proc_return = 0;
 
 		stmt->proc_return = 0;
-		SC_scanQueryAndCountParams(stmt->statement, SC_get_conn(stmt), NULL, pcpar, &multi, &proc_return);
+		SC_countQueryParams(stmt, pcpar, &multi, &proc_return);
 		stmt->num_params = *pcpar;
 		stmt->proc_return = proc_return;
 		stmt->multi_statement = multi;
@@ -762,6 +763,7 @@ extend_column_bindings(ARDFields *self, int num_columns)
 
 		self->bindings = new_bindings;
 		self->allocated = num_columns;
+		ARD_bindings_changed(self);
 	}
 
 	/*
@@ -787,6 +789,7 @@ reset_a_column_binding(ARDFields *self, int icol)
 	if (icol > self->allocated)
 		return;
 
+	ARD_bindings_changed(self);
 	/* use zero based col numbers from here out */
 	if (0 == icol)
 	{
@@ -823,6 +826,7 @@ MYLOG(DETAIL_LOG_LEVEL, "freeall=%d allocated=%d bindings=%p\n", freeall, self->
 			free(self->bindings);
 		self->bindings = NULL;
 		self->allocated = 0;
+		ARD_bindings_changed(self);
 	}
 }
 void	GDATA_unbind_cols(GetDataInfo *self, BOOL freeall)
@@ -953,6 +957,7 @@ void PutDataInfoInitialize(PutDataInfo *pdata_info)
 {
 	pdata_info->allocated = 0;
 	pdata_info->pdata = NULL;
+	pdata_info->stream_trans = FALSE;
 }
 void
 extend_putdata_info(PutDataInfo *self, int num_params, BOOL shrink)
@@ -1019,6 +1024,7 @@ void	reset_a_putdata_info(PutDataInfo *pdata_info, int ipar)
 		pdata_info->pdata[ipar].EXEC_buffer = NULL;
 	}
 	pdata_info->pdata[ipar].lobj_oid = 0;
+	pdata_info->pdata[ipar].streamed = FALSE;
 }
 
 void SC_param_next(const StatementClass *stmt, int *param_number, ParameterInfoClass **apara, ParameterImplClass **ipara)
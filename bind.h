@@ -68,6 +68,7 @@ typedef struct
 	SQLLEN	*EXEC_used;	/* amount of data */
 	char	*EXEC_buffer; 	/* the data */
 	OID	lobj_oid;
+	char	streamed;	/* lobj_oid is a temporary copy of a bytea value */
 }	PutDataClass;
 
 /*
@@ -95,6 +96,7 @@ typedef struct
 {
 	SQLSMALLINT	allocated;
 	PutDataClass	*pdata;
+	char		stream_trans;	/* a transaction was begun for streamed values */
 }	PutDataInfo;
 
 #define	PARSE_PARAM_CAST	FALSE
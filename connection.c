@@ -26,6 +26,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
 
 /* for htonl */
 #ifdef WIN32
@@ -331,12 +332,19 @@ CC_initialize(ConnectionClass *rv, BOOL lockinit)
 	pg_memset(rv->stmts, 0, sizeof(StatementClass *) * STMT_INCREMENT);
 
 	rv->num_stmts = STMT_INCREMENT;
+	if (!HS_reserve(&rv->free_stmts, STMT_INCREMENT))
+		goto cleanup;
+	HS_put_range(&rv->free_stmts, 0, STMT_INCREMENT);
 	rv->descs = (DescriptorClass **) malloc(sizeof(DescriptorClass *) * STMT_INCREMENT);
 	if (!rv->descs)
 		goto cleanup;
 	pg_memset(rv->descs, 0, sizeof(DescriptorClass *) * STMT_INCREMENT);
 
 	rv->num_descs = STMT_INCREMENT;
+	if (!HS_reserve(&rv->free_descs, STMT_INCREMENT))
+		goto cleanup;
+	HS_put_range(&rv->free_descs, 0, STMT_INCREMENT);
+	rv->env_slot = -1;
 
 	rv->lobj_type = PG_TYPE_LO_UNDEFINED;
 	if (isMsAccess())
@@ -384,6 +392,7 @@ CC_Destructor(ConnectionClass *self)
 	if (self->status == CONN_EXECUTING)
 		return 0;
 
+	MYLOG(MIN_LOG_LEVEL, "connection lock waits=%u total=" FORMATI64 "us\n", self->cs_waits, self->cs_wait_usec);
 	CC_cleanup(self, FALSE);			/* cleanup socket and statements */
 
 	MYLOG(MIN_LOG_LEVEL, "after CC_Cleanup\n");
@@ -399,6 +408,8 @@ CC_Destructor(ConnectionClass *self)
 		free(self->descs);
 		self->descs = NULL;
 	}
+	HS_free(&self->free_stmts);
+	HS_free(&self->free_descs);
 	MYLOG(MIN_LOG_LEVEL, "after free statement holders\n");
 
 	NULL_THE_NAME(self->schemaIns);
@@ -670,6 +681,127 @@ CC_send_client_encoding(ConnectionClass *self, const char * encoding)
 	return SQL_SUCCESS;
 }
 
+#ifdef	USE_CONN_HEAP
+/*
+ *	Heaps of the connections released by another thread than the owner.
+ *	Only the owner thread may destroy a heap, so it's queued here until
+ *	the owner calls CC_malloc() or releases a heap itself. If the owner
+ *	exits first, mimalloc deletes the heap and the entry is never used.
+ */
+typedef struct OrphanHeap
+{
+	struct OrphanHeap	*next;
+	mi_heap_t	*heap;
+	UInt4		owner;
+} OrphanHeap;
+
+static OrphanHeap	*orphan_heaps = NULL;
+static volatile int	num_orphan_heaps = 0;
+
+static void
+destroy_orphan_heaps(UInt4 serial)
+{
+	OrphanHeap	*orphan, **prev, *mine = NULL;
+
+	if (0 == num_orphan_heaps)
+		return;
+	shortterm_common_lock();
+	for (prev = &orphan_heaps; NULL != (orphan = *prev);)
+	{
+		if (orphan->owner == serial)
+		{
+			*prev = orphan->next;
+			orphan->next = mine;
+			mine = orphan;
+			num_orphan_heaps--;
+		}
+		else
+			prev = &orphan->next;
+	}
+	shortterm_common_unlock();
+	while (NULL != (orphan = mine))
+	{
+		mine = orphan->next;
+		MYLOG(DETAIL_LOG_LEVEL, "destroying the queued heap %p\n", orphan->heap);
+		mi_heap_destroy(orphan->heap);
+		free(orphan);
+	}
+}
+
+/*
+ *	Allocate result values from the mimalloc heap of the connection, so
+ *	that the values of one connection share their pages instead of being
+ *	scattered among those of the others.
+ *
+ *	A mimalloc heap can allocate only in the thread which created it, and
+ *	mimalloc deletes it when that thread exits. So the heap is used only by
+ *	the thread which created it; other threads allocate from their default
+ *	heap. free() releases a block of any heap in any thread.
+ */
+void *
+CC_malloc(ConnectionClass *self, size_t size)
+{
+	UInt4	serial;
+
+	if (NULL == self || 0 == (serial = thread_serial()))
+		return malloc(size);
+	destroy_orphan_heaps(serial);
+	if (NULL == self->heap)
+	{
+		CONNLOCK_ACQUIRE(self);
+		if (NULL == self->heap &&
+		    NULL != (self->heap = mi_heap_new()))
+			self->heap_owner = serial;
+		CONNLOCK_RELEASE(self);
+		if (NULL == self->heap)
+			return malloc(size);
+	}
+	if (self->heap_owner != serial)
+		return malloc(size);
+	return mi_heap_malloc(self->heap, size);
+}
+
+/*
+ *	Give back the heap of the connection at the disconnection.
+ *
+ *	The statements and the column info cache of the connection are gone
+ *	by now. The results which may be kept longer, the SQLColumns results
+ *	of the column info (built by PGAPI_Columns()) and the copies in the
+ *	process-wide metadata cache (QR_duplicate()), hold strdup'ed values
+ *	of their own. So no block of the heap is in use any more, and the
+ *	heap is destroyed at once rather than deleted, which would move the
+ *	blocks to the default heap one page at a time.
+ *	Only the owner thread may destroy it; any other thread queues it for
+ *	the owner.
+ */
+static void
+CC_release_heap(ConnectionClass *self)
+{
+	UInt4		serial = thread_serial();
+	OrphanHeap	*orphan;
+
+	if (NULL == self->heap)
+		return;
+	if (self->heap_owner == serial)
+	{
+		mi_heap_destroy(self->heap);
+		destroy_orphan_heaps(serial);
+	}
+	else if (NULL != (orphan = (OrphanHeap *) malloc(sizeof(OrphanHeap))))
+	{
+		orphan->heap = self->heap;
+		orphan->owner = self->heap_owner;
+		shortterm_common_lock();
+		orphan->next = orphan_heaps;
+		orphan_heaps = orphan;
+		num_orphan_heaps++;
+		shortterm_common_unlock();
+	}
+	self->heap = NULL;
+	self->heap_owner = 0;
+}
+#endif /* USE_CONN_HEAP */
+
 /* This is called by SQLDisconnect also */
 char
 CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
@@ -718,6 +850,7 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 			SC_Destructor(stmt);
 
 			self->stmts[i] = NULL;
+			HS_put(&self->free_stmts, i);
 		}
 	}
 	/* Free all the descs on this connection */
@@ -728,8 +861,9 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 		{
 			DC_get_conn(desc) = NULL;	/* prevent any more dbase interactions */
 			DC_Destructor(desc);
-			free(desc);
+			OP_put(OP_DESCRIPTOR, desc);
 			self->descs[i] = NULL;
+			HS_put(&self->free_descs, i);
 		}
 	}
 
@@ -770,6 +904,11 @@ CC_cleanup(ConnectionClass *self, BOOL keepCommunication)
 	}
 	/* Free cached table info */
 	CC_clear_col_info(self, TRUE);
+	CC_clear_stmt_rewrites(self);
+#ifdef	USE_CONN_HEAP
+	if (!keepCommunication)
+		CC_release_heap(self);
+#endif /* USE_CONN_HEAP */
 	if (self->num_discardp > 0 && self->discardp)
 	{
 		for (i = 0; i < self->num_discardp; i++)
@@ -1538,24 +1677,15 @@ CC_add_statement(ConnectionClass *self, StatementClass *stmt)
 	MYLOG(MIN_LOG_LEVEL, "self=%p, stmt=%p\n", self, stmt);
 
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
-	{
-		if (!self->stmts[i])
-		{
-			stmt->hdbc = self;
-			self->stmts[i] = stmt;
-			break;
-		}
-	}
-
-	if (i >= self->num_stmts) /* no more room -- allocate more memory */
+	if (i = HS_get(&self->free_stmts), i < 0) /* no more room -- allocate more memory */
 	{
 		StatementClass **newstmts;
 		Int2 new_num_stmts;
 
 		new_num_stmts = STMT_INCREMENT + self->num_stmts;
 
-		if (new_num_stmts > 0)
+		if (new_num_stmts > 0 &&
+		    HS_reserve(&self->free_stmts, new_num_stmts))
 			newstmts = (StatementClass **)
 				realloc(self->stmts, sizeof(StatementClass *) * new_num_stmts);
 		else
@@ -1566,13 +1696,18 @@ CC_add_statement(ConnectionClass *self, StatementClass *stmt)
 		{
 			self->stmts = newstmts;
 			pg_memset(&self->stmts[self->num_stmts], 0, sizeof(StatementClass *) * STMT_INCREMENT);
-
-			stmt->hdbc = self;
-			self->stmts[self->num_stmts] = stmt;
+			HS_put_range(&self->free_stmts, self->num_stmts, new_num_stmts);
 
 			self->num_stmts = new_num_stmts;
+			i = HS_get(&self->free_stmts);
 		}
 	}
+	if (ret)
+	{
+		stmt->hdbc = self;
+		stmt->conn_slot = i;
+		self->stmts[i] = stmt;
+	}
 	CONNLOCK_RELEASE(self);
 
 	return ret;
@@ -1600,20 +1735,76 @@ CC_remove_statement(ConnectionClass *self, StatementClass *stmt)
 	char	ret = FALSE;
 
 	CONNLOCK_ACQUIRE(self);
-	for (i = 0; i < self->num_stmts; i++)
+	i = stmt->conn_slot;
+	if (i >= 0 && i < self->num_stmts &&
+	    self->stmts[i] == stmt && stmt->status != STMT_EXECUTING)
 	{
-		if (self->stmts[i] == stmt && stmt->status != STMT_EXECUTING)
-		{
-			self->stmts[i] = NULL;
-			ret = TRUE;
-			break;
-		}
+		self->stmts[i] = NULL;
+		HS_put(&self->free_stmts, i);
+		ret = TRUE;
 	}
 	CONNLOCK_RELEASE(self);
 
 	return ret;
 }
 
+#if defined(WIN_MULTITHREAD_SUPPORT) || defined(POSIX_THREADMUTEX_SUPPORT)
+static Int8
+cs_clock_usec(void)
+{
+#ifdef	WIN32
+	static LARGE_INTEGER	freq = {0};
+	LARGE_INTEGER	count;
+
+	/* GetTickCount64() has a resolution of 10 to 16 ms */
+	if (0 == freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (Int8) (count.QuadPart / freq.QuadPart * 1000000
+		+ count.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart);
+#else
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (Int8) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif /* WIN32 */
+}
+
+/*
+ *	ENTER_CONN_CS() found the connection lock held by another thread.
+ *	Wait for it and account the wait to the connection, so that the
+ *	contention can be seen (SQL_ATTR_PGOPT_CONN_LOCK_WAITS).
+ *	The counters are updated under CONNLOCK, so that they can be read
+ *	without the connection lock (PGAPI_GetConnectAttr()).
+ *	Returns FALSE, without the lock, only if the mutex is unusable.
+ */
+BOOL
+CC_wait_conn_cs(ConnectionClass *self)
+{
+	Int8	start = cs_clock_usec();
+
+#if defined(WIN_MULTITHREAD_SUPPORT)
+	EnterCriticalSection(&self->cs);
+#else
+	int	err;
+
+	/* EAGAIN: too many recursive locks held by the other threads */
+	while (EAGAIN == (err = pthread_mutex_lock(&self->cs)))
+		;
+	if (0 != err)
+	{
+		MYLOG(0, "couldn't lock the connection %p error=%d\n", self, err);
+		return FALSE;
+	}
+#endif /* WIN_MULTITHREAD_SUPPORT */
+	CONNLOCK_ACQUIRE(self);
+	self->cs_waits++;
+	self->cs_wait_usec += cs_clock_usec() - start;
+	CONNLOCK_RELEASE(self);
+	return TRUE;
+}
+#endif /* WIN_MULTITHREAD_SUPPORT || POSIX_THREADMUTEX_SUPPORT */
+
 char CC_get_escape(const ConnectionClass *self)
 {
 	const char	   *scf;
@@ -2393,7 +2584,9 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 				 */
 				else if (strnicmp(cmdbuffer, "DROP TABLE", 10) == 0 ||
 						 strnicmp(cmdbuffer, "ALTER TABLE", 11) == 0)
+				{
 					CC_clear_col_info(self, FALSE);
+				}
 				else
 				{
 					ptr = strrchr(cmdbuffer, ' ');
@@ -2483,6 +2676,8 @@ CC_send_query_append(ConnectionClass *self, const char *query, QueryInfo *qi, UD
 						if (cursor && cursor[0])
 							QR_set_synchronize_keys(res);
 					}
+					else if (!read_only && NULL != stmt && stmt->external)
+						QR_set_app_rows(res);
 					if (CC_from_PGresult(res, stmt, self, cursor, &pgres))
 						query_completed = TRUE;
 					else
@@ -2834,6 +3029,164 @@ cleanup:
 	return ret;
 }
 
+#ifdef	LIBPQ_HAS_PIPELINING
+#define	LO_PIPELINE_DEPTH	4
+/*
+ *	Move len bytes of a large object between buf and the descriptor fd
+ *	in chunk_size pieces. Up to LO_PIPELINE_DEPTH loread or lowrite calls
+ *	are sent in pipeline mode before their results are collected, so the
+ *	transfer costs one round trip per LO_PIPELINE_DEPTH chunks. Read data
+ *	is copied from the result straight into buf.
+ *
+ *	Returns the count of the bytes moved, -1 on error or -2 when the
+ *	connection can't enter pipeline mode.
+ */
+Int8
+CC_send_lo_pipeline(ConnectionClass *self, int fd, char *buf, Int8 len, Int4 chunk_size, BOOL is_write)
+{
+	CSTR	func = "CC_send_lo_pipeline";
+	Int8		ret = -1, done = 0, sent;
+	int			i, nsent, nread, func_cs_count = 0;
+	BOOL		eof = FALSE, failed = FALSE, in_pipeline = FALSE, sync_pending = FALSE;
+	PGresult   *pgres;
+	const char *sqlbuffer = is_write ? "SELECT pg_catalog.lowrite($1, $2)" : "SELECT pg_catalog.loread($1, $2)";
+	Oid			paramTypes[2] = {PG_TYPE_INT4, 0};
+	const char *paramValues[2];
+	int			paramLengths[2] = {4, 0};
+	int			paramFormats[2] = {1, 1};
+	Int4		fdParamBuf = htonl(fd), lenParamBufs[LO_PIPELINE_DEPTH], chunk_len[LO_PIPELINE_DEPTH];
+
+	MYLOG(MIN_LOG_LEVEL, "conn=%p, fd=%d, len=" FORMATI64 ", chunk_size=%d, is_write=%d\n", self, fd, len, chunk_size, is_write);
+	if (!is_write)
+		paramTypes[1] = PG_TYPE_INT4;
+	paramValues[0] = (const char *) &fdParamBuf;
+
+#define	return DONT_CALL_RETURN_FROM_HERE???
+	ENTER_INNER_CONN_CS(self, func_cs_count);
+	if (!PQenterPipelineMode(self->pqconn))
+	{
+		/* the caller falls back to one call at a time */
+		ret = -2;
+		goto cleanup;
+	}
+	in_pipeline = TRUE;
+	while (done < len && !eof && !failed)
+	{
+		/* send the calls for the next chunks */
+		for (nsent = 0, sent = done; nsent < LO_PIPELINE_DEPTH && sent < len; nsent++)
+		{
+			chunk_len[nsent] = (Int4) (len - sent > chunk_size ? chunk_size : len - sent);
+			if (is_write)
+			{
+				paramValues[1] = buf + sent;
+				paramLengths[1] = chunk_len[nsent];
+			}
+			else
+			{
+				lenParamBufs[nsent] = htonl(chunk_len[nsent]);
+				paramValues[1] = (const char *) &lenParamBufs[nsent];
+				paramLengths[1] = 4;
+			}
+			QLOG(MIN_LOG_LEVEL, "PQsendQueryParams: %p '%s' len=%d\n", self->pqconn, sqlbuffer, chunk_len[nsent]);
+			if (!PQsendQueryParams(self->pqconn, sqlbuffer, 2,
+								   paramTypes, paramValues,
+								   paramLengths, paramFormats, 1))
+			{
+				CC_set_errormsg(self, "could not send large object function");
+				failed = TRUE;
+				break;
+			}
+			sent += chunk_len[nsent];
+		}
+		if (!PQpipelineSync(self->pqconn))
+		{
+			/* the calls sent can't be completed, give up the connection */
+			CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, "could not send pipeline sync for large object transfer", func);
+			CC_on_abort(self, CONN_DEAD);
+			in_pipeline = FALSE;
+			goto cleanup;
+		}
+		sync_pending = TRUE;
+		/* collect the results in order */
+		for (i = 0; i < nsent; i++)
+		{
+			pgres = PQgetResult(self->pqconn);
+			if (PGRES_TUPLES_OK == PQresultStatus(pgres) &&
+				1 == PQnfields(pgres) && 1 == PQntuples(pgres))
+			{
+				if (!failed && !eof)
+				{
+					if (is_write)
+					{
+						Int4	int4val;
+
+						memcpy(&int4val, PQgetvalue(pgres, 0, 0), sizeof(Int4));
+						nread = ntohl(int4val);
+					}
+					else
+					{
+						nread = PQgetlength(pgres, 0, 0);
+						memcpy(buf + done, PQgetvalue(pgres, 0, 0), nread);
+					}
+					done += nread;
+					/* a short read means the end of the large object */
+					if (nread < chunk_len[i])
+						eof = TRUE;
+				}
+			}
+			else if (!failed)
+			{
+				handle_pgres_error(self, pgres, func, NULL, TRUE);
+				failed = TRUE;
+			}
+			if (pgres)
+				PQclear(pgres);
+			/* a NULL terminates the results of each call */
+			if (pgres = PQgetResult(self->pqconn), NULL != pgres)
+				PQclear(pgres);
+		}
+		pgres = PQgetResult(self->pqconn);
+		if (PGRES_PIPELINE_SYNC == PQresultStatus(pgres))
+			sync_pending = FALSE;
+		else
+			failed = TRUE;
+		if (pgres)
+			PQclear(pgres);
+	}
+	QLOG(MIN_LOG_LEVEL, "\tmoved " FORMATI64 " bytes of large object\n", done);
+	if (!failed)
+		ret = done;
+
+cleanup:
+#undef	return
+	if (in_pipeline)
+	{
+		/* drain the results left up to the sync point */
+		while (sync_pending)
+		{
+			if (pgres = PQgetResult(self->pqconn), NULL == pgres)
+			{
+				if (CONNECTION_OK != PQstatus(self->pqconn))
+					break;
+				continue;
+			}
+			if (PGRES_PIPELINE_SYNC == PQresultStatus(pgres))
+				sync_pending = FALSE;
+			PQclear(pgres);
+		}
+		if (!PQexitPipelineMode(self->pqconn))
+		{
+			/* the connection is in an unknown state */
+			CC_set_error(self, CONNECTION_COMMUNICATION_ERROR, "could not exit pipeline mode after large object transfer", func);
+			CC_on_abort(self, CONN_DEAD);
+			ret = -1;
+		}
+	}
+	CLEANUP_FUNC_CONN_CS(func_cs_count, self);
+	return ret;
+}
+#endif /* LIBPQ_HAS_PIPELINING */
+
 
 char
 CC_send_settings(ConnectionClass *self, const char *set_query)
@@ -3871,6 +4224,7 @@ PgDtc_isolate(void *self, DWORD option)
 	if (0 == (useAnotherRoom & option))
 	{
 		HENV	henv = sconn->henv;
+		int	env_slot = sconn->env_slot;
 
 		CC_cleanup(sconn, TRUE);
 		if (newconn = CC_Copy(sconn), NULL == newconn)
@@ -3881,7 +4235,9 @@ PgDtc_isolate(void *self, DWORD option)
 			CC_copy_conninfo(&sconn->connInfo, &newconn->connInfo);
 		CC_initialize_pg_version(sconn);
 		sconn->henv = henv;
+		sconn->env_slot = env_slot;
 		newconn->henv = NULL;
+		newconn->env_slot = -1;
 		SYNC_AUTOCOMMIT(sconn);
 		return newconn;
 	}
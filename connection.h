@@ -138,16 +138,28 @@ do { \
 	t = tmp; \
 } while (0)
 
+/*
+ *	With mimalloc each connection keeps the values of its results in a
+ *	heap of its own. The memory debugging build has to see them instead.
+ */
+#if defined(_MIMALLOC_) && !defined(_MEMORY_DEBUG_)
+#define	USE_CONN_HEAP
+#endif /* _MIMALLOC_ */
+
 /* For Multi-thread */
 #if defined(WIN_MULTITHREAD_SUPPORT)
 #define INIT_CONN_CS(x)		InitializeCriticalSection(&((x)->cs))
 #define INIT_CONNLOCK(x)	InitializeCriticalSection(&((x)->slock))
-#define ENTER_CONN_CS(x)	EnterCriticalSection(&((x)->cs))
+#define ENTER_CONN_CS(x) \
+do { \
+	if (!TryEnterCriticalSection(&((x)->cs))) \
+		CC_wait_conn_cs(x); \
+} while (0)
 #define CONNLOCK_ACQUIRE(x)	EnterCriticalSection(&((x)->slock))
 #define TRY_ENTER_CONN_CS(x)	TryEnterCriticalSection(&((x)->cs))
 #define ENTER_INNER_CONN_CS(x, entered) \
 do { \
-	EnterCriticalSection(&((x)->cs)); \
+	ENTER_CONN_CS(x); \
 	entered++; \
 } while (0)
 #define LEAVE_CONN_CS(x)	LeaveCriticalSection(&((x)->cs))
@@ -157,14 +169,24 @@ do { \
 #elif defined(POSIX_THREADMUTEX_SUPPORT)
 #define INIT_CONN_CS(x)		pthread_mutex_init(&((x)->cs), getMutexAttr())
 #define INIT_CONNLOCK(x)	pthread_mutex_init(&((x)->slock), getMutexAttr())
-#define ENTER_CONN_CS(x)	pthread_mutex_lock(&((x)->cs))
+/*
+ *	The callers can't fail. CC_wait_conn_cs() retries the transient
+ *	errors, so it fails only with an unusable mutex, which is logged.
+ */
+#define ENTER_CONN_CS(x) \
+do { \
+	if (0 != pthread_mutex_trylock(&((x)->cs)) && \
+	    !CC_wait_conn_cs(x)) \
+		MYLOG(0, "going on without the lock of the connection %p\n", (x)); \
+} while (0)
 #define CONNLOCK_ACQUIRE(x)		pthread_mutex_lock(&((x)->slock))
 #define TRY_ENTER_CONN_CS(x)	(0 == pthread_mutex_trylock(&((x)->cs)))
 #define ENTER_INNER_CONN_CS(x, entered) \
 do { \
 	if (getMutexAttr()) \
 	{ \
-		if (pthread_mutex_lock(&((x)->cs)) == 0) \
+		if (0 == pthread_mutex_trylock(&((x)->cs)) || \
+		    CC_wait_conn_cs(x)) \
 			entered++; \
 	} \
 } while (0)
@@ -294,12 +316,16 @@ struct ConnectionClass_
 	ConnInfo	connInfo;
 	StatementClass	**stmts;
 	Int2		num_stmts;
+	HandleSlots	free_stmts;	/* free slots of stmts */
 	Int2		ncursors;
 	PGconn	   *pqconn;
 	Int4		lobj_type;
 	Int2		coli_allocated;
 	Int2		ntables;
 	COL_INFO	**col_info;
+	Int2		num_rewrites;
+	UInt4		rewrite_seq;	/* access sequence of the rewrite cache */
+	StmtRewrite	**rewrites;	/* cache of the rewritten statements */
 	long		translation_option;
 	HINSTANCE	translation_handle;
 	DataSourceToDriverProc DataSourceToDriver;
@@ -342,6 +368,15 @@ struct ConnectionClass_
 	int		num_descs;
 	SQLUINTEGER	default_isolation;	/* server's default isolation initially unknown */
 	DescriptorClass	**descs;
+	HandleSlots	free_descs;	/* free slots of descs */
+	int		env_slot;	/* index in the environment's connection list */
+	UInt4		cs_waits;	/* times ENTER_CONN_CS() had to wait */
+	Int8		cs_wait_usec;	/* and how long in total */
+	Int8		spilled_bytes;	/* values written to temporary files past ResultMemoryLimit */
+#ifdef	USE_CONN_HEAP
+	mi_heap_t	*heap;		/* storage of the result values, see CC_malloc() */
+	UInt4		heap_owner;	/* thread_serial() of the thread owning the heap */
+#endif /* USE_CONN_HEAP */
 	pgNAME		schemaIns;
 	pgNAME		tableIns;
 	SQLULEN		stmt_timeout_in_effect;
@@ -418,7 +453,14 @@ char		CC_add_statement(ConnectionClass *self, StatementClass *stmt);
 char		CC_remove_statement(ConnectionClass *self, StatementClass *stmt)
 ;
 char		CC_add_descriptor(ConnectionClass *self, DescriptorClass *desc);
+void		CC_clear_stmt_rewrites(ConnectionClass *self);
 char		CC_remove_descriptor(ConnectionClass *self, DescriptorClass *desc);
+BOOL		CC_wait_conn_cs(ConnectionClass *self);
+#ifdef	USE_CONN_HEAP
+void		*CC_malloc(ConnectionClass *self, size_t size);
+#else
+#define	CC_malloc(self, size)	malloc(size)
+#endif /* USE_CONN_HEAP */
 void		CC_set_error(ConnectionClass *self, int number, const char *message, const char *func);
 void		CC_set_errormsg(ConnectionClass *self, const char *message);
 char		CC_get_error(ConnectionClass *self, int *number, char **message);
@@ -429,6 +471,9 @@ void		handle_pgres_error(ConnectionClass *self, const PGresult *pgres,
 				   QResultClass *res, BOOL error_not_a_notice);
 void		CC_clear_error(ConnectionClass *self);
 int		CC_send_function(ConnectionClass *conn, const char *fn_name, void *result_buf, int *actual_result_len, int result_is_int, LO_ARG *argv, int nargs);
+#ifdef	LIBPQ_HAS_PIPELINING
+Int8		CC_send_lo_pipeline(ConnectionClass *conn, int fd, char *buf, Int8 len, Int4 chunk_size, BOOL is_write);
+#endif /* LIBPQ_HAS_PIPELINING */
 char		CC_send_settings(ConnectionClass *self, const char *set_query);
 void		CC_initialize_pg_version(ConnectionClass *conn);
 void		CC_log_error(const char *func, const char *desc, const ConnectionClass *self);
@@ -281,6 +281,156 @@ static void parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL
  *		precision support since 7.2.
  *		time zone support is unavailable(the stuff is unreliable)
  */
+/*
+ *	Convert the time with the time zone offset zone(hours) to the local time.
+ */
+static void
+zone2localtime(SIMPLE_TIME *st, BOOL withZone, BOOL *bZone, int zone)
+{
+#ifdef	TIMEZONE_GLOBAL
+	long		timediff;
+#endif
+
+	if (!withZone || !*bZone || st->y < 1970)
+		return;
+#ifdef	TIMEZONE_GLOBAL
+	if (!TZNAME_GLOBAL[0] || !TZNAME_GLOBAL[0][0])
+	{
+		*bZone = FALSE;
+		return;
+	}
+	timediff = TIMEZONE_GLOBAL + zone * 3600;
+	if (!DAYLIGHT_GLOBAL && timediff == 0)		/* the same timezone */
+		return;
+	else
+	{
+		struct tm	tm,
+				   *tm2;
+		time_t		time0;
+
+		*bZone = FALSE;
+		tm.tm_year = st->y - 1900;
+		tm.tm_mon = st->m - 1;
+		tm.tm_mday = st->d;
+		tm.tm_hour = st->hh;
+		tm.tm_min = st->mm;
+		tm.tm_sec = st->ss;
+		tm.tm_isdst = -1;
+		time0 = mktime(&tm);
+		if (time0 < 0)
+			return;
+		if (tm.tm_isdst > 0)
+			timediff -= 3600;
+		if (timediff == 0)		/* the same time zone */
+			return;
+		time0 -= timediff;
+#ifdef	HAVE_LOCALTIME_R
+		if (time0 >= 0 && (tm2 = localtime_r(&time0, &tm)) != NULL)
+#else
+		if (time0 >= 0 && (tm2 = localtime(&time0)) != NULL)
+#endif /* HAVE_LOCALTIME_R */
+		{
+			st->y = tm2->tm_year + 1900;
+			st->m = tm2->tm_mon + 1;
+			st->d = tm2->tm_mday;
+			st->hh = tm2->tm_hour;
+			st->mm = tm2->tm_min;
+			st->ss = tm2->tm_sec;
+			*bZone = TRUE;
+		}
+	}
+#endif /* TIMEZONE_GLOBAL */
+}
+
+#define	ISO_IS_DIGIT2(s)	(isdigit((s)[0]) && isdigit((s)[1]))
+#define	ISO_DIGIT2(s)	(((s)[0] - '0') * 10 + ((s)[1] - '0'))
+
+/*
+ *	Parse the output of date, time and timestamp types in DateStyle ISO
+ *	i.e. YYYY-MM-DD[ HH:MM:SS[.f...][{+|-}HH[:MM[:SS]]]] or
+ *	HH:MM:SS[.f...][{+|-}HH[:MM[:SS]]] without scanning it repeatedly.
+ *	FALSE is returned and st is kept untouched for other formats.
+ */
+static BOOL
+parse_iso_timestamp(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
+{
+	const UCHAR	*p = (const UCHAR *) str;
+	int		y = 0, m = 0, d = 0, hh, mm, ss, fr = 0, i;
+	BOOL		hasdate = FALSE, haszone = FALSE;
+	int		zonehh = 0;
+
+	if (ISO_IS_DIGIT2(p) && ISO_IS_DIGIT2(p + 2) && '-' == p[4])
+	{
+		if (!ISO_IS_DIGIT2(p + 5) || '-' != p[7] || !ISO_IS_DIGIT2(p + 8))
+			return FALSE;
+		y = ISO_DIGIT2(p) * 100 + ISO_DIGIT2(p + 2);
+		m = ISO_DIGIT2(p + 5);
+		d = ISO_DIGIT2(p + 8);
+		p += 10;
+		if ('\0' == *p) /* date */
+		{
+			st->y = y;
+			st->m = m;
+			st->d = d;
+			st->hh = st->mm = st->ss = 0;
+			return TRUE;
+		}
+		if (' ' != *p)
+			return FALSE;
+		p++;
+		hasdate = TRUE;
+	}
+	if (!ISO_IS_DIGIT2(p) || ':' != p[2] ||
+	    !ISO_IS_DIGIT2(p + 3) || ':' != p[5] ||
+	    !ISO_IS_DIGIT2(p + 6))
+		return FALSE;
+	hh = ISO_DIGIT2(p);
+	mm = ISO_DIGIT2(p + 3);
+	ss = ISO_DIGIT2(p + 6);
+	p += 8;
+	if ('.' == *p)
+	{
+		/* nanoseconds, the digits after the 9th are ignored */
+		for (p++, i = 0; isdigit(*p); p++, i++)
+		{
+			if (i < 9)
+				fr = fr * 10 + (*p - '0');
+		}
+		if (0 == i)
+			return FALSE;
+		for (; i < 9; i++)
+			fr *= 10;
+	}
+	if ('+' == *p || '-' == *p)
+	{
+		if (!ISO_IS_DIGIT2(p + 1))
+			return FALSE;
+		/* only the hour part of the offset is used */
+		zonehh = ISO_DIGIT2(p + 1);
+		if ('-' == *p)
+			zonehh = -zonehh;
+		haszone = TRUE;
+		for (p += 3; ':' == *p && ISO_IS_DIGIT2(p + 1); p += 3)
+			;
+	}
+	if ('\0' != *p)
+		return FALSE;
+
+	if (hasdate)
+	{
+		st->y = y;
+		st->m = m;
+		st->d = d;
+	}
+	st->hh = hh;
+	st->mm = mm;
+	st->ss = ss;
+	st->fr = fr;
+	*bZone = haszone;
+	*zone = zonehh;
+	return TRUE;
+}
+
 static BOOL
 timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 {
@@ -290,15 +440,18 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 				status,
 				i;
 	int			y, m, d, hh, mm, ss;
-#ifdef	TIMEZONE_GLOBAL
-	long		timediff;
-#endif
 	BOOL		withZone = *bZone;
 
 	*bZone = FALSE;
 	*zone = 0;
 	st->fr = 0;
 	st->infinity = 0;
+	/* the usual output of the server */
+	if (parse_iso_timestamp(str, st, bZone, zone))
+	{
+		zone2localtime(st, withZone, bZone, *zone);
+		return TRUE;
+	}
 	rest[0] = '\0';
 	bc[0] = '\0';
 	if ((scnt = secure_sscanf(str, &status, "%4d-%2d-%2d %2d:%2d:%2d%31s %15s",
@@ -384,58 +537,55 @@ timestamp2stime(const char *str, SIMPLE_TIME *st, BOOL *bZone, int *zone)
 	{
 		st->y *= -1;
 	}
-	if (!withZone || !*bZone || st->y < 1970)
-		return TRUE;
-#ifdef	TIMEZONE_GLOBAL
-	if (!TZNAME_GLOBAL[0] || !TZNAME_GLOBAL[0][0])
-	{
-		*bZone = FALSE;
-		return TRUE;
-	}
-	timediff = TIMEZONE_GLOBAL + (*zone) * 3600;
-	if (!DAYLIGHT_GLOBAL && timediff == 0)		/* the same timezone */
-		return TRUE;
-	else
-	{
-		struct tm	tm,
-				   *tm2;
-		time_t		time0;
-
-		*bZone = FALSE;
-		tm.tm_year = st->y - 1900;
-		tm.tm_mon = st->m - 1;
-		tm.tm_mday = st->d;
-		tm.tm_hour = st->hh;
-		tm.tm_min = st->mm;
-		tm.tm_sec = st->ss;
-		tm.tm_isdst = -1;
-		time0 = mktime(&tm);
-		if (time0 < 0)
-			return TRUE;
-		if (tm.tm_isdst > 0)
-			timediff -= 3600;
-		if (timediff == 0)		/* the same time zone */
-			return TRUE;
-		time0 -= timediff;
-#ifdef	HAVE_LOCALTIME_R
-		if (time0 >= 0 && (tm2 = localtime_r(&time0, &tm)) != NULL)
-#else
-		if (time0 >= 0 && (tm2 = localtime(&time0)) != NULL)
-#endif /* HAVE_LOCALTIME_R */
-		{
-			st->y = tm2->tm_year + 1900;
-			st->m = tm2->tm_mon + 1;
-			st->d = tm2->tm_mday;
-			st->hh = tm2->tm_hour;
-			st->mm = tm2->tm_min;
-			st->ss = tm2->tm_sec;
-			*bZone = TRUE;
-		}
-	}
-#endif /* TIMEZONE_GLOBAL */
+	zone2localtime(st, withZone, bZone, *zone);
 	return TRUE;
 }
 
+#define	ISO_IN_2DIGITS(v)	((v) >= 0 && (v) < 100)
+#define	ISO_STIME_IS_FIXED(st) \
+	((st)->y >= 0 && (st)->y < 10000 && \
+	 ISO_IN_2DIGITS((st)->m) && ISO_IN_2DIGITS((st)->d) && \
+	 ISO_IN_2DIGITS((st)->hh) && ISO_IN_2DIGITS((st)->mm) && \
+	 ISO_IN_2DIGITS((st)->ss))
+#define	ISO_PUT_2DIGITS(p, v)	((p)[0] = '0' + (v) / 10, (p)[1] = '0' + (v) % 10)
+
+/*
+ *	The same as snprintf(str, bufsize, "%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s%s", ...)
+ *	for the fields satisfying ISO_STIME_IS_FIXED().
+ */
+static int
+format_iso_timestamp(const SIMPLE_TIME *st, const char *precstr, const char *zonestr, char *str, size_t bufsize)
+{
+	char	buf[64], *p = buf;
+	size_t	len, cpylen;
+
+	ISO_PUT_2DIGITS(p, st->y / 100);
+	ISO_PUT_2DIGITS(p + 2, st->y % 100);
+	p[4] = '-';
+	ISO_PUT_2DIGITS(p + 5, st->m);
+	p[7] = '-';
+	ISO_PUT_2DIGITS(p + 8, st->d);
+	p[10] = ' ';
+	ISO_PUT_2DIGITS(p + 11, st->hh);
+	p[13] = ':';
+	ISO_PUT_2DIGITS(p + 14, st->mm);
+	p[16] = ':';
+	ISO_PUT_2DIGITS(p + 17, st->ss);
+	p += 19;
+	while (*precstr)
+		*p++ = *precstr++;
+	while (*zonestr)
+		*p++ = *zonestr++;
+	len = p - buf;
+	if (bufsize > 0)
+	{
+		cpylen = len < bufsize ? len : bufsize - 1;
+		memcpy(str, buf, cpylen);
+		str[cpylen] = '\0';
+	}
+	return (int) len;
+}
+
 static int
 stime2timestamp(const SIMPLE_TIME *st, char *str, size_t bufsize, BOOL bZone,
 				int precision)
@@ -455,7 +605,17 @@ stime2timestamp(const SIMPLE_TIME *st, char *str, size_t bufsize, BOOL bZone,
 	}
 	if (precision > 0 && st->fr)
 	{
-		SPRINTF_FIXED(precstr, ".%09d", st->fr);
+		if (st->fr > 0 && st->fr < 1000000000)
+		{
+			int	fr = st->fr;
+
+			precstr[0] = '.';
+			for (i = 9; i > 0; i--, fr /= 10)
+				precstr[i] = '0' + fr % 10;
+			precstr[10] = '\0';
+		}
+		else
+			SPRINTF_FIXED(precstr, ".%09d", st->fr);
 		if (precision < 9)
 			precstr[precision + 1] = '\0';
 		else if (precision > 9)
@@ -497,6 +657,8 @@ stime2timestamp(const SIMPLE_TIME *st, char *str, size_t bufsize, BOOL bZone,
 			SPRINTF_FIXED(zonestr, "+%02d", -(int) zoneint / 3600);
 	}
 #endif /* TIMEZONE_GLOBAL */
+	if (ISO_STIME_IS_FIXED(st))
+		return format_iso_timestamp(st, precstr, zonestr, str, bufsize);
 	if (st->y < 0)
 		return snprintf(str, bufsize, "%.4d-%.2d-%.2d %.2d:%.2d:%.2d%s%s BC", -st->y, st->m, st->d, st->hh, st->mm, st->ss, precstr, zonestr);
 	else
@@ -941,11 +1103,20 @@ get_adjust_len(SQLSMALLINT fCType, SQLLEN len)
 #define	BYTEA_PROCESS_ESCAPE	1
 #define	BYTEA_PROCESS_BINARY	2
 
+/*
+ *	When rgbValueBindRow is available, SQL_C_CHAR/SQL_C_WCHAR values are
+ *	converted directly into it in a single pass where possible and
+ *	*copied_return is set to TRUE. ttlbuf is used only when the result
+ *	is truncated and the rest must be kept for subsequent SQLGetData
+ *	calls (keep_rest).
+ */
 static int
 setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
-	int *needbuflen_return, GetDataClass * const pgdc, const char *neut_str,
+	int *needbuflen_return, BOOL * const copied_return,
+	GetDataClass * const pgdc, const char *neut_str,
 	const OID field_type, const SQLSMALLINT fCType,
-	const SQLLEN cbValueMax, const ConnectionClass * const conn)
+	char * const rgbValueBindRow, const SQLLEN cbValueMax,
+	const BOOL keep_rest, const ConnectionClass * const conn)
 {
 	SQLLEN len = (-2);
 	const char *ptr = NULL;
@@ -956,6 +1127,7 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 	int	bytea_process_kind = 0;
 	BOOL	already_processed = FALSE;
 	BOOL	changed = FALSE;
+	BOOL	direct = FALSE;	/* converted into rgbValueBindRow already */
 	int	len_for_wcs_term = 0;
 
 #ifdef	UNICODE_SUPPORT
@@ -1014,6 +1186,12 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 				goto cleanup;
 			}
 		}
+		else if (NULL != rgbValueBindRow && cbValueMax >= WCLEN)
+		{
+			/* normally, convert into the application buffer at once */
+			unicode_count = utf8_to_ucs2_lf(neut_str, SQL_NTS, lf_conv, (SQLWCHAR *) rgbValueBindRow, cbValueMax / WCLEN, FALSE);
+			direct = TRUE;
+		}
 		else	/* normally */
 		{
 			unicode_count = utf8_to_ucs2_lf(neut_str, SQL_NTS, lf_conv, NULL, 0, FALSE);
@@ -1041,6 +1219,13 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 			len *= 2;
 		changed = TRUE;
 	}
+	else if (lf_conv && SQL_C_CHAR == fCType &&
+		 NULL != rgbValueBindRow && cbValueMax > 0)
+	{
+		/* convert linefeeds into the application buffer at once */
+		len = convert_linefeeds(neut_str, rgbValueBindRow, cbValueMax, lf_conv, &changed);
+		direct = TRUE;
+	}
 	else
 		/* convert linefeeds to carriage-return/linefeed */
 		len = convert_linefeeds(neut_str, NULL, 0, lf_conv, &changed);
@@ -1064,7 +1249,53 @@ setup_getdataclass(SQLLEN * const length_return, const char ** const ptr_return,
 		 */
 		len_for_wcs_term = 1;
 	}
-	if (changed || needbuflen > cbValueMax)
+	if (direct && (needbuflen <= cbValueMax || !keep_rest))
+	{
+		/*
+		 * The (possibly truncated) result is in the application buffer
+		 * and nothing is left for subsequent calls.
+		 */
+#ifdef	UNICODE_SUPPORT
+		if (SQL_C_WCHAR == fCType && needbuflen > cbValueMax)
+			((SQLWCHAR *) rgbValueBindRow)[cbValueMax / WCLEN - 1] = 0;
+#endif /* UNICODE_SUPPORT */
+		if (pgdc->ttlbuf)
+		{
+			free(pgdc->ttlbuf);
+			pgdc->ttlbuf = NULL;
+		}
+		ptr = rgbValueBindRow;
+		*copied_return = TRUE;
+	}
+#ifdef	UNICODE_SUPPORT
+	else if ((hybrid || (localize_needed && SQL_C_CHAR == fCType)) &&
+		 NULL != rgbValueBindRow && needbuflen <= cbValueMax)
+	{
+		/* The result fits, so convert into the application buffer */
+		if (hybrid)
+		{
+			MYLOG(MIN_LOG_LEVEL, "hybrid convert directly\n");
+			if (bindcol_hybrid_exec((SQLWCHAR *) rgbValueBindRow, neut_str, unicode_count + 1, lf_conv, &allocbuf) < 0)
+			{
+				result = COPY_INVALID_STRING_CONVERSION;
+				goto cleanup;
+			}
+		}
+		else if (bindcol_localize_exec(rgbValueBindRow, len + 1, lf_conv, &allocbuf) < 0)
+		{
+			result = COPY_INVALID_STRING_CONVERSION;
+			goto cleanup;
+		}
+		if (pgdc->ttlbuf)
+		{
+			free(pgdc->ttlbuf);
+			pgdc->ttlbuf = NULL;
+		}
+		ptr = rgbValueBindRow;
+		*copied_return = TRUE;
+	}
+#endif /* UNICODE_SUPPORT */
+	else if (changed || needbuflen > cbValueMax)
 	{
 		if (needbuflen > (SQLLEN) pgdc->ttlbuflen)
 		{
@@ -1165,6 +1396,7 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 	GetDataClass *pgdc;
 	int	copy_len = 0, needbuflen = 0, i;
 	const char	*ptr;
+	BOOL	already_copied = FALSE;
 
 	MYLOG(MIN_LOG_LEVEL, "field_type=%u type=%d\n", field_type, fCType);
 
@@ -1187,8 +1419,9 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 	if (pgdc->data_left < 0)
 	{
 		if (COPY_OK != (result = setup_getdataclass(&len, &ptr,
-				&needbuflen, pgdc, neut_str, field_type,
-				fCType, cbValueMax, conn)))
+				&needbuflen, &already_copied, pgdc, neut_str,
+				field_type, fCType, rgbValueBindRow, cbValueMax,
+				current_col >= 0, conn)))
 			goto cleanup;
 	}
 	else
@@ -1213,7 +1446,6 @@ convert_text_field_to_sql_c(GetDataInfo * const gdata, const int current_col,
 
 	if (cbValueMax > 0)
 	{
-		BOOL	already_copied = FALSE;
 		int		terminatorlen;
 
 		terminatorlen = get_terminator_len(fCType);
@@ -1269,6 +1501,238 @@ cleanup:
 	return result;
 }
 
+/*
+ *	Specialized converters for the conversion plan.
+ *	Each of them stores one fixed length C type.
+ */
+#define	def_plan_converter(name, ctype, conv) \
+static SQLLEN name(char *value, void *rgbValue) \
+{ \
+	*((ctype *) rgbValue) = (ctype) conv(value); \
+	return sizeof(ctype); \
+}
+def_plan_converter(plan_cvt_stinyint, SCHAR, pg_atoi)
+def_plan_converter(plan_cvt_utinyint, UCHAR, pg_atoi)
+def_plan_converter(plan_cvt_sshort, SQLSMALLINT, pg_atoi)
+def_plan_converter(plan_cvt_ushort, SQLUSMALLINT, pg_atoi)
+def_plan_converter(plan_cvt_slong, SQLINTEGER, pg_atol)
+def_plan_converter(plan_cvt_ulong, SQLUINTEGER, ATOI32U)
+#ifdef	ODBCINT64
+def_plan_converter(plan_cvt_sbigint, SQLBIGINT, ATOI64)
+def_plan_converter(plan_cvt_ubigint, SQLUBIGINT, ATOI64U)
+#endif /* ODBCINT64 */
+
+static SQLLEN plan_cvt_float(char *value, void *rgbValue)
+{
+	set_client_decimal_point(value);
+	*((SFLOAT *) rgbValue) = (float) get_double_value(value);
+	return sizeof(SFLOAT);
+}
+
+static SQLLEN plan_cvt_double(char *value, void *rgbValue)
+{
+	set_client_decimal_point(value);
+	*((SDOUBLE *) rgbValue) = get_double_value(value);
+	return sizeof(SDOUBLE);
+}
+
+/*
+ *	Choose the converter for (field_type, fCType) or NULL if the
+ *	conversion needs copy_and_convert_field().
+ */
+static COLUMN_CONVERT_FUNC
+plan_converter(OID field_type, SQLSMALLINT fCType, SQLSMALLINT *elemsize)
+{
+	COLUMN_CONVERT_FUNC	cvt;
+
+	/* numeric types whose text needs no preprocessing */
+	switch (field_type)
+	{
+		case PG_TYPE_INT2:
+		case PG_TYPE_INT4:
+		case PG_TYPE_INT8:
+		case PG_TYPE_OID:
+		case PG_TYPE_XID:
+		case PG_TYPE_FLOAT4:
+		case PG_TYPE_FLOAT8:
+		case PG_TYPE_NUMERIC:
+			break;
+		default:
+			return NULL;
+	}
+	switch (fCType)
+	{
+		case SQL_C_STINYINT:
+		case SQL_C_TINYINT:
+			cvt = plan_cvt_stinyint;
+			*elemsize = sizeof(SCHAR);
+			break;
+		case SQL_C_BIT:
+		case SQL_C_UTINYINT:
+			cvt = plan_cvt_utinyint;
+			*elemsize = sizeof(UCHAR);
+			break;
+		case SQL_C_SSHORT:
+		case SQL_C_SHORT:
+			cvt = plan_cvt_sshort;
+			*elemsize = sizeof(SQLSMALLINT);
+			break;
+		case SQL_C_USHORT:
+			cvt = plan_cvt_ushort;
+			*elemsize = sizeof(SQLUSMALLINT);
+			break;
+		case SQL_C_SLONG:
+		case SQL_C_LONG:
+			cvt = plan_cvt_slong;
+			*elemsize = sizeof(SQLINTEGER);
+			break;
+		case SQL_C_ULONG:
+			cvt = plan_cvt_ulong;
+			*elemsize = sizeof(SQLUINTEGER);
+			break;
+#ifdef	ODBCINT64
+		case SQL_C_SBIGINT:
+			cvt = plan_cvt_sbigint;
+			*elemsize = sizeof(SQLBIGINT);
+			break;
+		case SQL_C_UBIGINT:
+			cvt = plan_cvt_ubigint;
+			*elemsize = sizeof(SQLUBIGINT);
+			break;
+#endif /* ODBCINT64 */
+		case SQL_C_FLOAT:
+			cvt = plan_cvt_float;
+			*elemsize = sizeof(SFLOAT);
+			break;
+		case SQL_C_DOUBLE:
+			cvt = plan_cvt_double;
+			*elemsize = sizeof(SDOUBLE);
+			break;
+		default:
+			cvt = NULL;
+			*elemsize = 0;
+	}
+
+	return cvt;
+}
+
+/*
+ *	Get the conversion plan of the result for the current ARD, building
+ *	it if the plan doesn't exist yet or the bindings have changed since.
+ *	NULL is returned when all the columns need the general path.
+ */
+ColumnConverter	*
+SC_get_conversion_plan(StatementClass *stmt, QResultClass *res)
+{
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ColumnInfoClass	*coli = QR_get_fields(res);
+	ColumnConverter	*plan;
+	int		num_cols, i;
+
+	/* the translation dll may rewrite the values */
+	if (NULL != conn->DataSourceToDriver)
+		return NULL;
+	if (NULL != res->cvt_plan &&
+	    opts == res->cvt_plan_ard &&
+	    opts->generation == res->cvt_plan_generation)
+		return res->cvt_plan;
+
+	QR_clear_conversion_plan(res);
+	num_cols = QR_NumPublicResultCols(res);
+	if (num_cols > opts->allocated)
+		num_cols = opts->allocated;
+	if (num_cols <= 0 || NULL == opts->bindings)
+		return NULL;
+	if (plan = (ColumnConverter *) malloc(sizeof(ColumnConverter) * num_cols), NULL == plan)
+		return NULL;
+	for (i = 0; i < num_cols; i++)
+	{
+		OID		field_type = CI_get_oid(coli, i);
+		SQLSMALLINT	fCType = opts->bindings[i].returntype;
+
+		plan[i].returntype = fCType;
+		if (SQL_C_DEFAULT == fCType)
+			fCType = pgtype_attr_to_ctype(conn, field_type, CI_get_atttypmod(coli, i));
+		plan[i].convert = plan_converter(field_type, fCType, &plan[i].elemsize);
+	}
+	res->cvt_plan = plan;
+	res->cvt_plan_count = num_cols;
+	res->cvt_plan_ard = opts;
+	res->cvt_plan_generation = opts->generation;
+	MYLOG(DETAIL_LOG_LEVEL, "built the conversion plan of %d columns for %p\n", num_cols, res);
+
+	return plan;
+}
+
+/*
+ *	This is called by SC_fetch() instead of copy_and_convert_field_bindinfo()
+ *	for non-null values when CVT_PLAN_applicable() holds.
+ */
+int
+copy_and_convert_field_plan(StatementClass *stmt, const ColumnConverter *cvt, char *value, int col)
+{
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	const BindInfoClass *bic = &(opts->bindings[col]);
+	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	SQLSETPOSIROW	bind_row = stmt->bind_row;
+	SQLLEN		pcbValueOffset, len;
+	char		*rgbValueBindRow;
+	SQLLEN		*pcbValue, *pIndicator;
+
+	SC_set_current_col(stmt, -1);
+	if (opts->bind_size > 0)
+	{
+		pcbValueOffset = opts->bind_size * bind_row;
+		rgbValueBindRow = bic->buffer + offset + pcbValueOffset;
+	}
+	else
+	{
+		pcbValueOffset = bind_row * sizeof(SQLLEN);
+		rgbValueBindRow = bic->buffer + offset + bind_row * cvt->elemsize;
+	}
+	len = cvt->convert(value, rgbValueBindRow);
+	if (pIndicator = LENADDR_SHIFT(bic->indicator, offset), NULL != pIndicator)
+		*LENADDR_SHIFT(pIndicator, pcbValueOffset) = 0;
+	if (pcbValue = LENADDR_SHIFT(bic->used, offset), NULL != pcbValue)
+		*LENADDR_SHIFT(pcbValue, pcbValueOffset) = len;
+
+	return COPY_OK;
+}
+
+/*
+ *	Convert a column of the rowset at once in case of column-wise binding.
+ *	rows[] holds the cache index of each row or -1 for the rows to skip.
+ *	Null values were already handled by SC_fetch().
+ */
+void
+copy_and_convert_column_plan(StatementClass *stmt, const ColumnConverter *cvt, int col, const SQLLEN *rows, SQLLEN nrows)
+{
+	QResultClass	*res = SC_get_Curres(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	const BindInfoClass *bic = &(opts->bindings[col]);
+	SQLULEN	offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	COLUMN_CONVERT_FUNC	convert = cvt->convert;
+	SQLLEN		elemsize = cvt->elemsize, irow, len;
+	char		*rgbValue = bic->buffer + offset, *value;
+	SQLLEN		*pcbValue = LENADDR_SHIFT(bic->used, offset);
+	SQLLEN		*pIndicator = LENADDR_SHIFT(bic->indicator, offset);
+
+	SC_set_current_col(stmt, -1);
+	for (irow = 0; irow < nrows; irow++, rgbValue += elemsize)
+	{
+		if (rows[irow] < 0)
+			continue;
+		if (value = QR_get_value_backend_row(res, rows[irow], col), NULL == value)
+			continue;
+		len = convert(value, rgbValue);
+		if (NULL != pIndicator)
+			pIndicator[irow] = 0;
+		if (NULL != pcbValue)
+			pcbValue[irow] = len;
+	}
+}
+
 /*	This is called by SQLGetData() */
 int
 copy_and_convert_field(StatementClass *stmt,
@@ -2138,6 +2602,7 @@ typedef enum
 #define	FLGB_LITERAL_EXTENSION	(1L << 10)
 #define	FLGB_HEX_BIN_FORMAT	(1L << 11)
 #define	FLGB_PARAM_CAST		(1L << 12)
+#define	FLGB_CONN_STATE		(1L << 13)	/* depends on the connection state */
 typedef struct _QueryBuild {
 	char   *query_statement;
 	size_t	str_alsize;
@@ -2166,6 +2631,24 @@ typedef struct _QueryBuild {
 	StatementClass	*stmt; /* needed to set error info in ENLARGE_.. */
 }	QueryBuild;
 
+/*
+ *	The QueryBuild flags which come from the connection settings.
+ */
+static UInt4
+conn_build_flags(const ConnectionClass *conn)
+{
+	UInt4	flags = 0;
+
+	if (conn->connInfo.lf_conversion)
+		flags |= FLGB_CONVERT_LF;
+	if (CC_get_escape(conn) &&
+	    PG_VERSION_GE(conn, 8.1))
+		flags |= FLGB_LITERAL_EXTENSION;
+	if (PG_VERSION_GE(conn, 9.0))
+		flags |= FLGB_HEX_BIN_FORMAT;
+	return flags;
+}
+
 #define INIT_MIN_ALLOC	4096
 static ssize_t
 QB_initialize(QueryBuild *qb, size_t size, StatementClass *stmt, ResolveParamMode param_mode)
@@ -2202,14 +2685,8 @@ QB_initialize(QueryBuild *qb, size_t size, StatementClass *stmt, ResolveParamMod
 		qb->num_discard_params = qb->proc_return;
 
 	/* Copy options from connection */
-	if (qb->conn->connInfo.lf_conversion)
-		qb->flags |= FLGB_CONVERT_LF;
+	qb->flags |= conn_build_flags(qb->conn);
 	qb->ccsc = qb->conn->ccsc;
-	if (CC_get_escape(qb->conn) &&
-	    PG_VERSION_GE(qb->conn, 8.1))
-		qb->flags |= FLGB_LITERAL_EXTENSION;
-	if (PG_VERSION_GE(qb->conn, 9.0))
-		qb->flags |= FLGB_HEX_BIN_FORMAT;
 
 	newsize = INIT_MIN_ALLOC;
 	while (newsize <= size)
@@ -2636,102 +3113,411 @@ check_join(StatementClass *stmt, const char *curptr, size_t curpos)
 	const int	backstep = 4;
 	BOOL	outerj = TRUE;
 
-	for (endpos = curpos, wstmt = curptr; endpos >= 0 && isspace((UCHAR) *wstmt); endpos--, wstmt--)
-		;
-	if (endpos < 0)
-		return FALSE;
-	for (endpos -= backstep, wstmt -= backstep; endpos >= 0 && isspace((UCHAR) *wstmt); endpos--, wstmt--)
-		;
-	if (endpos < 0)
-		return FALSE;
-	for (stapos = endpos; stapos >= 0 && IS_NOT_SPACE(*wstmt); stapos--, wstmt--)
-		;
-	if (stapos < 0 || 0 == *wstmt)
-		return FALSE;
-	wstmt++;
-	switch (tokenwd = endpos - stapos)
+	for (endpos = curpos, wstmt = curptr; endpos >= 0 && isspace((UCHAR) *wstmt); endpos--, wstmt--)
+		;
+	if (endpos < 0)
+		return FALSE;
+	for (endpos -= backstep, wstmt -= backstep; endpos >= 0 && isspace((UCHAR) *wstmt); endpos--, wstmt--)
+		;
+	if (endpos < 0)
+		return FALSE;
+	for (stapos = endpos; stapos >= 0 && IS_NOT_SPACE(*wstmt); stapos--, wstmt--)
+		;
+	if (stapos < 0 || 0 == *wstmt)
+		return FALSE;
+	wstmt++;
+	switch (tokenwd = endpos - stapos)
+	{
+		case 4:
+			if (strnicmp(wstmt, "FULL", tokenwd) == 0 ||
+			    strnicmp(wstmt, "LEFT", tokenwd) == 0)
+				break;
+			return FALSE;
+		case 5:
+			if (strnicmp(wstmt, "OUTER", tokenwd) == 0 ||
+			    strnicmp(wstmt, "RIGHT", tokenwd) == 0)
+				break;
+			if (strnicmp(wstmt, "INNER", tokenwd) == 0 ||
+			    strnicmp(wstmt, "CROSS", tokenwd) == 0)
+			{
+				outerj = FALSE;
+				break;
+			}
+			return FALSE;
+		default:
+			return FALSE;
+	}
+	if (stmt)
+	{
+		if (outerj)
+			SC_set_outer_join(stmt);
+		else
+			SC_set_inner_join(stmt);
+	}
+	return TRUE;
+}
+
+/*----------
+ *	Check if the statement is
+ *	INSERT INTO ... () VALUES ()
+ *	This isn't really a strict check but ...
+ *----------
+ */
+static BOOL
+insert_without_target(const char *stmt, size_t *endpos)
+{
+	const char *wstmt = stmt;
+
+	while (isspace((UCHAR) *wstmt)) wstmt++;
+	if (!*wstmt)
+		return FALSE;
+	if (strnicmp(wstmt, "VALUES", 6))
+		return FALSE;
+	wstmt += 6;
+	if (!wstmt[0] || IS_NOT_SPACE(wstmt[0]))
+		return FALSE;
+	while (isspace((UCHAR) *wstmt)) wstmt++;
+	if (*wstmt != '(' || *(++wstmt) != ')')
+		return FALSE;
+	wstmt++;
+	*endpos = wstmt - stmt;
+	return !wstmt[0] || isspace((UCHAR) wstmt[0])
+		|| ';' == wstmt[0];
+}
+
+static ProcessedStmt *
+buildProcessedStmt(const char *srvquery, ssize_t endp, int num_params)
+{
+	ProcessedStmt *pstmt;
+	size_t		qlen;
+
+	qlen = (endp == SQL_NTS) ? strlen(srvquery) : endp;
+
+	pstmt = malloc(sizeof(ProcessedStmt));
+	if (!pstmt)
+		return NULL;
+
+	pstmt->next = NULL;
+	pstmt->query = malloc(qlen + 1);
+	if (!pstmt->query)
+	{
+		free(pstmt);
+		return NULL;
+	}
+	memcpy(pstmt->query, srvquery, qlen);
+	pstmt->query[qlen] = '\0';
+	pstmt->num_params = num_params;
+
+	return pstmt;
+}
+
+static void
+freeProcessedStmts(ProcessedStmt *pstmt)
+{
+	ProcessedStmt *next_pstmt;
+
+	for (; pstmt; pstmt = next_pstmt)
+	{
+		next_pstmt = pstmt->next;
+		if (pstmt->query)
+			free(pstmt->query);
+		free(pstmt);
+	}
+}
+
+static ProcessedStmt *
+copyProcessedStmts(const ProcessedStmt *src)
+{
+	ProcessedStmt *first = NULL, *last = NULL, *pstmt;
+
+	for (; src; src = src->next)
+	{
+		if (pstmt = buildProcessedStmt(src->query, SQL_NTS, src->num_params), NULL == pstmt)
+		{
+			freeProcessedStmts(first);
+			return NULL;
+		}
+		if (last)
+			last->next = pstmt;
+		else
+			first = pstmt;
+		last = pstmt;
+	}
+	return first;
+}
+
+/*
+ *	Cache of the rewritten statements.
+ *
+ *	An entry is keyed by the original statement and the connection
+ *	settings which affect the scanning and the rewriting (the QueryBuild
+ *	flags and the client encoding). It keeps the result of
+ *	SC_scanQueryAndCountParams() and, once the statement was prepared
+ *	at the server, the ProcessedStmt list built by prepareParametersNoDesc()
+ *	together with the parameter SQL types the casts were derived from.
+ *	All the accesses are done holding the connection lock.
+ */
+struct StmtRewrite_
+{
+	char		*statement;	/* the original statement */
+	UInt4		hash;
+	UInt4		flags;		/* conn_build_flags() */
+	Int2		ccsc;
+	/* results of SC_scanQueryAndCountParams() */
+	SQLSMALLINT	num_params;
+	po_ind_t	multi_statement;
+	po_ind_t	proc_return;
+	/* result of prepareParametersNoDesc() */
+	ProcessedStmt	*pstmt;
+	BOOL		param_cast;
+	SQLSMALLINT	num_param_types;
+	SQLSMALLINT	*param_types;	/* SQL types of the parameters */
+	UInt4		join_info;	/* join_info the rewrite has set */
+	UInt4		acc_seq;	/* for the LRU replacement */
+};
+
+static UInt4
+stmt_rewrite_hash(const char *str)
+{
+	UInt4	hash = 2166136261U;	/* FNV-1a */
+
+	for (; *str; str++)
+		hash = (hash ^ (UCHAR) *str) * 16777619U;
+	return hash;
+}
+
+static void
+free_stmt_rewrite_pstmt(StmtRewrite *rw)
+{
+	freeProcessedStmts(rw->pstmt);
+	rw->pstmt = NULL;
+	if (rw->param_types)
+		free(rw->param_types);
+	rw->param_types = NULL;
+	rw->num_param_types = 0;
+}
+
+static void
+free_stmt_rewrite(StmtRewrite *rw)
+{
+	free_stmt_rewrite_pstmt(rw);
+	free(rw->statement);
+	free(rw);
+}
+
+void
+CC_clear_stmt_rewrites(ConnectionClass *conn)
+{
+	int	i;
+
+	CONNLOCK_ACQUIRE(conn);
+	for (i = 0; i < conn->num_rewrites; i++)
+		free_stmt_rewrite(conn->rewrites[i]);
+	if (conn->rewrites)
+		free(conn->rewrites);
+	conn->rewrites = NULL;
+	conn->num_rewrites = 0;
+	CONNLOCK_RELEASE(conn);
+}
+
+/*
+ *	Find the entry for the statement or create one if create is TRUE.
+ *	The caller must hold the connection lock.
+ */
+static StmtRewrite *
+find_stmt_rewrite(ConnectionClass *conn, const char *statement, BOOL create)
+{
+	UInt4		hash, flags;
+	StmtRewrite	*rw;
+	int		i, lru;
+
+	if (NULL == statement || strlen(statement) > STMT_REWRITE_MAX_LENGTH)
+		return NULL;
+	hash = stmt_rewrite_hash(statement);
+	flags = conn_build_flags(conn);
+	for (i = 0; i < conn->num_rewrites; i++)
+	{
+		rw = conn->rewrites[i];
+		if (rw->hash == hash &&
+		    rw->flags == flags &&
+		    rw->ccsc == conn->ccsc &&
+		    strcmp(rw->statement, statement) == 0)
+		{
+			rw->acc_seq = ++conn->rewrite_seq;
+			return rw;
+		}
+	}
+	if (!create)
+		return NULL;
+
+	if (NULL == conn->rewrites)
+	{
+		conn->rewrites = (StmtRewrite **) malloc(sizeof(StmtRewrite *) * STMT_REWRITE_CACHE_SIZE);
+		if (NULL == conn->rewrites)
+			return NULL;
+	}
+	if (conn->num_rewrites < STMT_REWRITE_CACHE_SIZE)
+		i = conn->num_rewrites++;
+	else
+	{
+		/* replace the least recently used one */
+		for (i = 1, lru = 0; i < conn->num_rewrites; i++)
+		{
+			if (conn->rewrites[i]->acc_seq < conn->rewrites[lru]->acc_seq)
+				lru = i;
+		}
+		free_stmt_rewrite(conn->rewrites[lru]);
+		i = lru;
+	}
+	if (rw = (StmtRewrite *) calloc(1, sizeof(StmtRewrite)), NULL != rw)
+		rw->statement = strdup(statement);
+	if (NULL == rw || NULL == rw->statement)
+	{
+		if (rw)
+			free(rw);
+		conn->rewrites[i] = conn->rewrites[--conn->num_rewrites];
+		return NULL;
+	}
+	rw->hash = hash;
+	rw->flags = flags;
+	rw->ccsc = conn->ccsc;
+	rw->num_params = -1;
+	rw->acc_seq = ++conn->rewrite_seq;
+	conn->rewrites[i] = rw;
+
+	return rw;
+}
+
+/*
+ *	SC_scanQueryAndCountParams() for the whole statement using the cache.
+ */
+void
+SC_countQueryParams(StatementClass *stmt, SQLSMALLINT *pcpar, po_ind_t *multi_st, po_ind_t *proc_return)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	StmtRewrite	*rw;
+
+	CONNLOCK_ACQUIRE(conn);
+	if (rw = find_stmt_rewrite(conn, stmt->statement, FALSE), NULL != rw &&
+	    rw->num_params >= 0)
 	{
-		case 4:
-			if (strnicmp(wstmt, "FULL", tokenwd) == 0 ||
-			    strnicmp(wstmt, "LEFT", tokenwd) == 0)
-				break;
-			return FALSE;
-		case 5:
-			if (strnicmp(wstmt, "OUTER", tokenwd) == 0 ||
-			    strnicmp(wstmt, "RIGHT", tokenwd) == 0)
-				break;
-			if (strnicmp(wstmt, "INNER", tokenwd) == 0 ||
-			    strnicmp(wstmt, "CROSS", tokenwd) == 0)
-			{
-				outerj = FALSE;
-				break;
-			}
-			return FALSE;
-		default:
-			return FALSE;
+		*pcpar = rw->num_params;
+		*multi_st = rw->multi_statement;
+		*proc_return = rw->proc_return;
+		CONNLOCK_RELEASE(conn);
+		return;
 	}
-	if (stmt)
+	CONNLOCK_RELEASE(conn);
+
+	SC_forget_query_commands(stmt);
+	stmt->num_commands = SC_scanQueryCommands(stmt->statement, conn, pcpar, multi_st, proc_return, &stmt->commands);
+
+	CONNLOCK_ACQUIRE(conn);
+	if (rw = find_stmt_rewrite(conn, stmt->statement, TRUE), NULL != rw)
 	{
-		if (outerj)
-			SC_set_outer_join(stmt);
-		else
-			SC_set_inner_join(stmt);
+		rw->num_params = *pcpar;
+		rw->multi_statement = *multi_st;
+		rw->proc_return = *proc_return;
 	}
-	return TRUE;
+	CONNLOCK_RELEASE(conn);
 }
 
-/*----------
- *	Check if the statement is
- *	INSERT INTO ... () VALUES ()
- *	This isn't really a strict check but ...
- *----------
+/*
+ *	Can the result of prepareParametersNoDesc() be cached ?
+ *	The rewrite of procedure calls and output parameters depends on
+ *	more than the parameter types.
  */
 static BOOL
-insert_without_target(const char *stmt, size_t *endpos)
+stmt_rewrite_is_cacheable(const StatementClass *stmt, BOOL fake_params)
 {
-	const char *wstmt = stmt;
+	return !fake_params &&
+		stmt->num_params >= 0 &&
+		stmt->proc_return <= 0 &&
+		!stmt->discard_output_params &&
+		STMT_TYPE_PROCCALL != stmt->statement_type;
+}
 
-	while (isspace((UCHAR) *wstmt)) wstmt++;
-	if (!*wstmt)
-		return FALSE;
-	if (strnicmp(wstmt, "VALUES", 6))
-		return FALSE;
-	wstmt += 6;
-	if (!wstmt[0] || IS_NOT_SPACE(wstmt[0]))
-		return FALSE;
-	while (isspace((UCHAR) *wstmt)) wstmt++;
-	if (*wstmt != '(' || *(++wstmt) != ')')
-		return FALSE;
-	wstmt++;
-	*endpos = wstmt - stmt;
-	return !wstmt[0] || isspace((UCHAR) wstmt[0])
-		|| ';' == wstmt[0];
+/*
+ *	The SQL type of a bound parameter which the cast is derived from.
+ *	The output parameters aren't casted.
+ */
+#define	PARAM_TYPE_OUTPUT	(-32768)
+static SQLSMALLINT
+param_type_for_cast(const ParameterImplClass *ipara)
+{
+	return SQL_PARAM_OUTPUT == ipara->paramType ? PARAM_TYPE_OUTPUT : ipara->SQLType;
 }
 
-static ProcessedStmt *
-buildProcessedStmt(const char *srvquery, ssize_t endp, int num_params)
+static BOOL
+stmt_rewrite_matches(const StmtRewrite *rw, const StatementClass *stmt, BOOL param_cast)
 {
-	ProcessedStmt *pstmt;
-	size_t		qlen;
+	const IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	int		i;
 
-	qlen = (endp == SQL_NTS) ? strlen(srvquery) : endp;
+	if (NULL == rw->pstmt || rw->param_cast != param_cast)
+		return FALSE;
+	if (!param_cast)
+		return TRUE;
+	if (rw->num_param_types != ipdopts->allocated)
+		return FALSE;
+	for (i = 0; i < ipdopts->allocated; i++)
+	{
+		if (rw->param_types[i] != param_type_for_cast(ipdopts->parameters + i))
+			return FALSE;
+	}
+	return TRUE;
+}
 
-	pstmt = malloc(sizeof(ProcessedStmt));
-	if (!pstmt)
-		return NULL;
+static void
+store_stmt_rewrite(StatementClass *stmt, BOOL param_cast, UInt4 join_info)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	const IPDFields	*ipdopts = SC_get_IPDF(stmt);
+	StmtRewrite	*rw;
+	int		i;
 
-	pstmt->next = NULL;
-	pstmt->query = malloc(qlen + 1);
-	if (!pstmt->query)
+	CONNLOCK_ACQUIRE(conn);
+	if (rw = find_stmt_rewrite(conn, stmt->statement, TRUE), NULL == rw)
+		goto cleanup;
+	free_stmt_rewrite_pstmt(rw);
+	if (param_cast && ipdopts->allocated > 0)
 	{
-		free(pstmt);
-		return NULL;
+		if (rw->param_types = (SQLSMALLINT *) malloc(sizeof(SQLSMALLINT) * ipdopts->allocated), NULL == rw->param_types)
+			goto cleanup;
+		for (i = 0; i < ipdopts->allocated; i++)
+			rw->param_types[i] = param_type_for_cast(ipdopts->parameters + i);
+		rw->num_param_types = ipdopts->allocated;
 	}
-	memcpy(pstmt->query, srvquery, qlen);
-	pstmt->query[qlen] = '\0';
-	pstmt->num_params = num_params;
+	rw->param_cast = param_cast;
+	rw->join_info = join_info;
+	rw->pstmt = copyProcessedStmts(stmt->processed_statements);
+cleanup:
+	CONNLOCK_RELEASE(conn);
+}
 
-	return pstmt;
+/*
+ *	Set the ProcessedStmt list of the statement from the cache.
+ */
+static BOOL
+reuse_stmt_rewrite(StatementClass *stmt, BOOL param_cast)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	StmtRewrite	*rw;
+	ProcessedStmt	*pstmt = NULL;
+
+	CONNLOCK_ACQUIRE(conn);
+	if (rw = find_stmt_rewrite(conn, stmt->statement, FALSE), NULL != rw &&
+	    stmt_rewrite_matches(rw, stmt, param_cast) &&
+	    NULL != (pstmt = copyProcessedStmts(rw->pstmt)))
+		stmt->join_info |= rw->join_info;
+	CONNLOCK_RELEASE(conn);
+	if (NULL == pstmt)
+		return FALSE;
+	MYLOG(MIN_LOG_LEVEL, "reusing the rewritten statement\n");
+	freeProcessedStmts(stmt->processed_statements);
+	stmt->processed_statements = pstmt;
+
+	return TRUE;
 }
 
 /*
@@ -2754,16 +3540,31 @@ prepareParametersNoDesc(StatementClass *stmt, BOOL fake_params, BOOL param_cast)
 	RETCODE		retval;
 	ConnectionClass *conn = SC_get_conn(stmt);
 	char		plan_name[32];
-	po_ind_t	multi;
-	const char	*orgquery = NULL, *srvquery = NULL;
-	ssize_t		endp1, endp2;
-	SQLSMALLINT	num_pa = 0, num_p1, num_p2;
+	const char	*srvquery = NULL;
+	QueryCommand	*srvcmds = NULL;
+	const QueryCommand	*cmd, *srvcmd;
+	int		num_srvcmds, i;
+	ssize_t		endp2;
 	ProcessedStmt *pstmt;
-	ProcessedStmt *last_pstmt;
+	ProcessedStmt *last_pstmt = NULL;
 	QueryParse	query_org, *qp;
 	QueryBuild	query_crt, *qb;
+	BOOL		cacheable;
+	UInt4		join_info;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering\n");
+	if (NAMED_PARSE_REQUEST == SC_get_prepare_method(stmt))
+		SPRINTF_FIXED(plan_name, "_PLAN%p", stmt);
+	else
+		plan_name[0] = '\0';
+	cacheable = stmt_rewrite_is_cacheable(stmt, fake_params);
+	if (cacheable && reuse_stmt_rewrite(stmt, param_cast))
+	{
+		SC_set_planname(stmt, plan_name);
+		SC_set_prepared(stmt, plan_name[0] ? PREPARING_PERMANENTLY : PREPARING_TEMPORARILY);
+		return SQL_SUCCESS;
+	}
+	join_info = stmt->join_info;
 	qp = &query_org;
 	QP_initialize(qp, stmt);
 	qb = &query_crt;
@@ -2790,54 +3591,62 @@ MYLOG(DETAIL_LOG_LEVEL, "entering\n");
 
 	retval = SQL_ERROR;
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	if (NAMED_PARSE_REQUEST == SC_get_prepare_method(stmt))
-		SPRINTF_FIXED(plan_name, "_PLAN%p", stmt);
-	else
-		plan_name[0] = '\0';
-
 	stmt->current_exec_param = 0;
-	multi = stmt->multi_statement;
-	orgquery = stmt->statement;
 	srvquery = qb->query_statement;
 
-	SC_scanQueryAndCountParams(orgquery, conn, &endp1, &num_p1, &multi, NULL);
-	SC_scanQueryAndCountParams(srvquery, conn, &endp2, NULL, NULL, NULL);
-	MYLOG(MIN_LOG_LEVEL, "parsed for the first command length=" FORMAT_SSIZE_T "(" FORMAT_SSIZE_T ") num_p=%d\n", endp2, endp1, num_p1);
-	pstmt = buildProcessedStmt(srvquery,
-							   endp2 < 0 ? SQL_NTS : endp2,
-							   fake_params ? 0 : num_p1);
-	if (!pstmt)
+	/*
+	 *	Split the statements into the commands. The index of the
+	 *	original statement is usually there since the parameters
+	 *	were counted.
+	 */
+	if (NULL == stmt->commands)
+		stmt->num_commands = SC_scanQueryCommands(stmt->statement, conn, NULL, NULL, NULL, &stmt->commands);
+	num_srvcmds = SC_scanQueryCommands(srvquery, conn, NULL, NULL, NULL, &srvcmds);
+	if (NULL == stmt->commands || NULL == srvcmds)
 	{
 		SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
 		goto cleanup;
 	}
-	stmt->processed_statements = last_pstmt = pstmt;
-	while (multi > 0)
+	if (num_srvcmds != stmt->num_commands)
+	{
+		MYLOG(0, "the command counts differ %d != %d\n", num_srvcmds, stmt->num_commands);
+		SC_set_error(stmt, STMT_INTERNAL_ERROR, "the rewritten statement doesn't match the original", func);
+		goto cleanup;
+	}
+	for (i = 0; i < stmt->num_commands; i++)
 	{
-		orgquery += (endp1 + 1);
-		srvquery += (endp2 + 1);
-		num_pa += num_p1;
-		SC_scanQueryAndCountParams(orgquery, conn, &endp1, &num_p1, &multi, NULL);
-		SC_scanQueryAndCountParams(srvquery, conn, &endp2, &num_p2, NULL, NULL);
-		MYLOG(MIN_LOG_LEVEL, "parsed for the subsequent command length=" FORMAT_SSIZE_T "(" FORMAT_SSIZE_T ") num_p=%d\n", endp2, endp1, num_p1);
-		pstmt = buildProcessedStmt(srvquery,
+		cmd = stmt->commands + i;
+		srvcmd = srvcmds + i;
+		endp2 = srvcmd->end < 0 ? -1 : srvcmd->end - srvcmd->start;
+		MYLOG(MIN_LOG_LEVEL, "parsed for the command[%d] length=" FORMAT_SSIZE_T "(" FORMAT_SSIZE_T ") num_p=%d\n", i, endp2, cmd->end < 0 ? -1 : cmd->end - cmd->start, cmd->num_params);
+		pstmt = buildProcessedStmt(srvquery + srvcmd->start,
 								   endp2 < 0 ? SQL_NTS : endp2,
-								   fake_params ? 0 : num_p1);
+								   fake_params ? 0 : cmd->num_params);
 		if (!pstmt)
 		{
 			SC_set_errornumber(stmt, STMT_NO_MEMORY_ERROR);
 			goto cleanup;
 		}
-		last_pstmt->next = pstmt;
+		if (last_pstmt)
+			last_pstmt->next = pstmt;
+		else
+			stmt->processed_statements = pstmt;
 		last_pstmt = pstmt;
 	}
 
 	SC_set_planname(stmt, plan_name);
 	SC_set_prepared(stmt, plan_name[0] ? PREPARING_PERMANENTLY : PREPARING_TEMPORARILY);
+	if (cacheable &&
+	    0 == qb->errornumber &&
+	    0 == qb->proc_return &&
+	    0 == (qb->flags & (FLGB_INACCURATE_RESULT | FLGB_CONN_STATE)))
+		store_stmt_rewrite(stmt, param_cast, stmt->join_info & ~join_info);
 
 	retval = SQL_SUCCESS;
 cleanup:
 #undef	return
+	if (srvcmds)
+		free(srvcmds);
 	stmt->current_exec_param = -1;
 	QB_Destructor(qb);
 	return retval;
@@ -3517,6 +4326,52 @@ static int PT_token_continue(ParseToken *pt, char oldchar)
 }
 #define	PT_TOKEN_IGNORE(pt)	((pt)->curchar_processed = TRUE)
 
+/*
+ *	Copy the run of characters following the current one which need no
+ *	handling in the current (quoted or comment) status at once, instead
+ *	of passing them one by one to inner_process_tokens(). The run ends
+ *	before stop1, stop2, a non-ASCII byte (the encoding state machine
+ *	has to see it) or the from/where position of the statement.
+ *	The current character is a 1-byte one so the encoding state is
+ *	unchanged by the run.
+ */
+static RETCODE
+QP_copy_plain_run(QueryParse *qp, QueryBuild *qb, UCHAR stop1, UCHAR stop2, BOOL in_token)
+{
+	RETCODE	retval = SQL_SUCCESS;
+	const UCHAR	*sptr = (const UCHAR *) qp->statement;
+	size_t	start = qp->opos + 1, end = qp->stmt_len, pos, i;
+	UCHAR	tchar;
+
+	if (qp->from_pos >= (ssize_t) start && qp->from_pos < (ssize_t) end)
+		end = qp->from_pos;
+	if (qp->where_pos >= (ssize_t) start && qp->where_pos < (ssize_t) end)
+		end = qp->where_pos;
+	for (pos = start; pos < end; pos++)
+	{
+		tchar = sptr[pos];
+		if (tchar >= 0x80 || '\0' == tchar ||
+		    stop1 == tchar || stop2 == tchar)
+			break;
+	}
+	if (pos == start)
+		return retval;
+	if (in_token)
+	{
+		for (i = start; i < pos; i++)
+		{
+			if (!qp->prev_token_end &&
+			    qp->token_len + 1 >= sizeof(qp->token_curr))
+				break;
+			token_continue(qp, (char) sptr[i]);
+		}
+	}
+	CVT_APPEND_DATA(qb, qp->statement + start, pos - start);
+	qp->opos = pos - 1;
+cleanup:
+	return retval;
+}
+
 static int
 inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 {
@@ -3629,7 +4484,7 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 			}
 		}
 		CVT_APPEND_CHAR(qb, oldchar);
-		return SQL_SUCCESS;
+		return QP_copy_plain_run(qp, qb, DOLLAR_QUOTE, DOLLAR_QUOTE, FALSE);
 	}
 	else if (QP_is_in(qp, QP_IN_LITERAL)) /* quote check */
 	{
@@ -3645,6 +4500,8 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 				QP_enter(qp, QP_IN_ESCAPE); /* escape in literal */
 		}
 		CVT_APPEND_CHAR(qb, oldchar);
+		if (QP_is_in(qp, QP_IN_LITERAL) && !QP_is_in(qp, QP_IN_ESCAPE))
+			return QP_copy_plain_run(qp, qb, LITERAL_QUOTE, qp->escape_in_literal, TRUE);
 		return SQL_SUCCESS;
 	}
 	else if (QP_is_in(qp, QP_IN_DQUOTE_IDENTIFIER)) /* double quote check */
@@ -3655,7 +4512,11 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 			QP_exit(qp, QP_IN_DQUOTE_IDENTIFIER);
 		}
 		else
+		{
 			PT_token_continue(pt, oldchar);
+			CVT_APPEND_CHAR(qb, oldchar);
+			return QP_copy_plain_run(qp, qb, IDENTIFIER_QUOTE, IDENTIFIER_QUOTE, TRUE);
+		}
 		CVT_APPEND_CHAR(qb, oldchar);
 		return SQL_SUCCESS;
 	}
@@ -3680,14 +4541,19 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 			oldchar = F_OldChar(qp);
 		}
 		CVT_APPEND_CHAR(qb, oldchar);
+		if (QP_is_in(qp, QP_IN_COMMENT_BLOCK))
+			return QP_copy_plain_run(qp, qb, '/', '*', FALSE);
 		return SQL_SUCCESS;
 	}
 	else if (QP_is_in(qp, QP_IN_LINE_COMMENT)) /* line comment check */
 	{
+		CVT_APPEND_CHAR(qb, oldchar);
 		if (PG_LINEFEED == oldchar)
+		{
 			QP_exit(qp, QP_IN_LINE_COMMENT);
-		CVT_APPEND_CHAR(qb, oldchar);
-		return SQL_SUCCESS;
+			return SQL_SUCCESS;
+		}
+		return QP_copy_plain_run(qp, qb, PG_LINEFEED, PG_LINEFEED, FALSE);
 	}
 
 	if (!QP_in_idle_status(qp))
@@ -3742,6 +4608,9 @@ inner_process_tokens(QueryParse *qp, QueryBuild *qb)
 		BOOL		converted = FALSE;
 		COL_INFO	*coli;
 
+		/* the last inserted table isn't a part of the cache key */
+		qb->flags |= FLGB_CONN_STATE;
+
 #ifdef	NOT_USED  /* lastval() isn't always appropriate */
 		if (PG_VERSION_GE(conn, 8.1))
 		{
@@ -4198,6 +5067,38 @@ cleanup:
  */
 #define MAX_NUMERIC_DIGITS 39
 
+/*
+ * The mantissa of SQL_NUMERIC_STRUCT is handled as 4 32-bit limbs
+ * (least significant first) instead of 16 bytes. Values less than
+ * 10^19 are handled with a single 64-bit integer.
+ */
+#define	NUMERIC_LIMBS	(SQL_MAX_NUMERIC_LEN / sizeof(UInt4))
+#define	MAX_INT64_DIGITS	19
+
+static void
+numeric_val_to_limbs(const SQLCHAR *val, UInt4 *limbs)
+{
+	int	i;
+
+	for (i = 0; i < NUMERIC_LIMBS; i++, val += 4)
+		limbs[i] = (UInt4) val[0] | ((UInt4) val[1] << 8) |
+			((UInt4) val[2] << 16) | ((UInt4) val[3] << 24);
+}
+
+static void
+numeric_limbs_to_val(const UInt4 *limbs, SQLCHAR *val)
+{
+	int	i;
+
+	for (i = 0; i < NUMERIC_LIMBS; i++, val += 4)
+	{
+		val[0] = (SQLCHAR) limbs[i];
+		val[1] = (SQLCHAR) (limbs[i] >> 8);
+		val[2] = (SQLCHAR) (limbs[i] >> 16);
+		val[3] = (SQLCHAR) (limbs[i] >> 24);
+	}
+}
+
 /*
  * Convert a SQL_NUMERIC_STRUCT into string representation.
  */
@@ -4205,8 +5106,8 @@ static void
 ResolveNumericParam(const SQL_NUMERIC_STRUCT *ns, char *chrform)
 {
 	Int4		i, vlen, len, newlen;
-	const UCHAR	*val = (const UCHAR *) ns->val;
-	UCHAR		vals[SQL_MAX_NUMERIC_LEN];
+	const SQLCHAR	*val = ns->val;
+	UInt4		limbs[NUMERIC_LIMBS];
 	int			lastnonzero;
 	UCHAR		calv[MAX_NUMERIC_DIGITS];
 	int			precision;
@@ -4225,34 +5126,46 @@ MYLOG(DETAIL_LOG_LEVEL, "C_NUMERIC [prec=%d scale=%d]", ns->precision, ns->scale
 		precision = MAX_NUMERIC_DIGITS;
 
 	/*
-	 * The representation in SQL_NUMERIC_STRUCT is 16 bytes with most
+	 * The representation in SQL_NUMERIC_STRUCT is 16 bytes with least
 	 * significant byte first. Make a working copy.
 	 */
-	memcpy(vals, val, SQL_MAX_NUMERIC_LEN);
+	numeric_val_to_limbs(val, limbs);
 
-	vlen = SQL_MAX_NUMERIC_LEN;
 	len = 0;
-	do
+	for (vlen = NUMERIC_LIMBS; vlen > 0 && 0 == limbs[vlen - 1]; vlen--)
+		;
+	if (vlen <= 2)
+	{
+		/* fits in 64 bits */
+		unsigned long long	v64 = ((unsigned long long) limbs[1] << 32) | limbs[0];
+
+		do
+		{
+			calv[len++] = (UCHAR) (v64 % 10);
+			v64 /= 10;
+		} while (0 != v64 && len < precision);
+	}
+	else do
 	{
-		UInt2		d, r;
+		UInt4		r;
 
 		/*
 		 * Divide the number by 10, and output the reminder as the next digit.
 		 *
-		 * Begin from the most-significant byte (last in the array), and at
-		 * each step, carry the remainder to the prev byte.
+		 * Begin from the most-significant limb (last in the array), and at
+		 * each step, carry the remainder to the prev limb.
 		 */
 		r = 0;
 		lastnonzero = -1;
 		for (i = vlen - 1; i >= 0; i--)
 		{
-			UInt2	v;
+			unsigned long long	v;
 
-			v = ((UInt2) vals[i]) + (r << 8);
-			d = v / 10; r = v % 10;
-			vals[i] = (UCHAR) d;
+			v = ((unsigned long long) r << 32) | limbs[i];
+			limbs[i] = (UInt4) (v / 10);
+			r = (UInt4) (v % 10);
 
-			if (d != 0 && lastnonzero == -1)
+			if (limbs[i] != 0 && lastnonzero == -1)
 				lastnonzero = i;
 		}
 
@@ -4310,6 +5223,8 @@ parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow)
 	int			i, nlen, dig;
 	char		calv[SQL_MAX_NUMERIC_LEN * 3];
 	BOOL		dot_exist;
+	unsigned long long	v64;
+	UInt4		limbs[NUMERIC_LIMBS];
 
 	*overflow = FALSE;
 
@@ -4364,26 +5279,32 @@ parse_to_numeric_struct(const char *wv, SQL_NUMERIC_STRUCT *ns, BOOL *overflow)
 	}
 	ns->precision = nlen;
 
-	/* Convert the decimal digits to binary */
-	pg_memset(ns->val, 0, sizeof(ns->val));
-	for (dig = 0; dig < nlen; dig++)
+	/* Convert the decimal digits to binary, 64 bits at a time first */
+	for (dig = 0, v64 = 0; dig < nlen && dig < MAX_INT64_DIGITS; dig++)
+		v64 = v64 * 10 + (calv[dig] - '0');
+	limbs[0] = (UInt4) v64;
+	limbs[1] = (UInt4) (v64 >> 32);
+	for (i = 2; i < NUMERIC_LIMBS; i++)
+		limbs[i] = 0;
+	for (; dig < nlen; dig++)
 	{
 		UInt4 carry;
 
 		/* multiply the current value by 10, and add the next digit */
 		carry = calv[dig] - '0';
-		for (i = 0; i < sizeof(ns->val); i++)
+		for (i = 0; i < NUMERIC_LIMBS; i++)
 		{
-			UInt4		t;
+			unsigned long long	t;
 
-			t = ((UInt4) ns->val[i]) * 10 + carry;
-			ns->val[i] = (unsigned char) (t & 0xFF);
-			carry = (t >> 8);
+			t = ((unsigned long long) limbs[i]) * 10 + carry;
+			limbs[i] = (UInt4) t;
+			carry = (UInt4) (t >> 32);
 		}
 
 		if (carry != 0)
 			*overflow = TRUE;
 	}
+	numeric_limbs_to_val(limbs, ns->val);
 }
 
 static BOOL
@@ -4465,6 +5386,36 @@ handle_lu_onvert_error(QueryBuild *qb, int flag, char *buffer, SQLLEN paralen)
 }
 #endif /* UNICODE_SUPPORT */
 
+/*
+ *	Read back the value PGAPI_PutData streamed into a large object.
+ */
+static BOOL
+read_streamed_putdata(ConnectionClass *conn, PutDataClass *pdata)
+{
+	SQLLEN	len = pdata->EXEC_used ? *pdata->EXEC_used : 0;
+	char	*buf;
+	int	fd;
+	Int8	nread;
+
+	if (buf = malloc(len + 1), NULL == buf)
+		return FALSE;
+	if (fd = odbc_lo_open(conn, pdata->lobj_oid, INV_READ), fd < 0)
+	{
+		free(buf);
+		return FALSE;
+	}
+	nread = odbc_lo_read_stream(conn, fd, buf, len);
+	odbc_lo_close(conn, fd);
+	if (nread != len)
+	{
+		free(buf);
+		return FALSE;
+	}
+	buf[len] = '\0';
+	pdata->EXEC_buffer = buf;
+	return TRUE;
+}
+
 /*
  * Resolve one parameter.
  *
@@ -4639,7 +5590,8 @@ MYLOG(DETAIL_LOG_LEVEL, "ipara=%p paramName=%s paramType=%d %d proc_return=%d\n"
 			extend_putdata_info(pdata, apdopts->allocated, TRUE);
 		used = pdata->pdata[param_number].EXEC_used ? *pdata->pdata[param_number].EXEC_used : SQL_NTS;
 		buffer = pdata->pdata[param_number].EXEC_buffer;
-		if (pdata->pdata[param_number].lobj_oid)
+		if (pdata->pdata[param_number].lobj_oid &&
+		    !pdata->pdata[param_number].streamed)
 			handling_large_object = TRUE;
 	}
 	else
@@ -4718,6 +5670,33 @@ MYLOG(DETAIL_LOG_LEVEL, "ipara=%p paramName=%s paramType=%d %d proc_return=%d\n"
 		return SQL_SUCCESS;
 	}
 
+	/*
+	 * PGAPI_PutData streamed the value into a temporary large object.
+	 * Let the server read it back rather than sending it again.
+	 */
+	if (apara->data_at_exec && pdata->pdata[param_number].streamed)
+	{
+		if (!req_bind)
+		{
+			SPRINTF_FIXED(param_string, "pg_catalog.lo_get(%u)", pdata->pdata[param_number].lobj_oid);
+			CVT_APPEND_STR(qb, param_string);
+			return SQL_SUCCESS;
+		}
+		/*
+		 * putdata_may_stream() keeps buffering the values of statements
+		 * that are bound, so this is only a safety net: a Bind message
+		 * can't refer to the large object, so read the value back.
+		 */
+		if (NULL == pdata->pdata[param_number].EXEC_buffer &&
+		    !read_streamed_putdata(conn, pdata->pdata + param_number))
+		{
+			qb->errormsg = "Could not read back a streamed parameter";
+			qb->errornumber = STMT_EXEC_ERROR;
+			return SQL_ERROR;
+		}
+		buffer = pdata->pdata[param_number].EXEC_buffer;
+	}
+
 	/*
 	 * If no buffer, and it's not null, then what the hell is it? Just
 	 * leave it alone then.
@@ -5280,7 +6259,7 @@ MYLOG(MIN_LOG_LEVEL, "cvt_null_date_string=%d pgtype=%d send_buf=%p\n", conn->co
 					goto cleanup;
 				}
 
-				write_result = odbc_lo_write(conn, lobj_fd, buffer, (Int4) used);
+				write_result = (int) (odbc_lo_write_stream(conn, lobj_fd, buffer, used) < 0 ? -1 : 0);
 				if (write_result < 0)
 				{
 					qb->errornumber = STMT_EXEC_ERROR;
@@ -6079,49 +7058,60 @@ parse_datetime(const char *buf, SIMPLE_TIME *st)
 }
 
 
-/*	Change linefeed to carriage-return/linefeed */
+/*
+ *	Change linefeed to carriage-return/linefeed
+ *
+ *	At most max - 1 bytes are stored into dst followed by a null terminator
+ *	(max == 0 means unlimited). The return value is the length of the whole
+ *	converted string even when dst is too small to hold it.
+ *
+ *	The spans between linefeeds are copied at once, so a string without
+ *	linefeeds costs a strlen() and a memcpy().
+ */
 size_t
 convert_linefeeds(const char *si, char *dst, size_t max, BOOL convlf, BOOL *changed)
 {
-	size_t		i = 0,
+	const char	*sptr = si, *send, *lfptr;
+	size_t		span, ncopy,
 				out = 0;
+	BOOL		chg = FALSE;
 
 	if (max == 0)
 		max = 0xffffffff;
-	*changed = FALSE;
-	for (i = 0; si[i] && out < max - 1; i++)
-	{
-		if (convlf && si[i] == '\n')
+	if (NULL == dst)
+		max = 0;
+	send = si + strlen(si);
+	for (;;)
+	{
+		lfptr = convlf ? memchr(sptr, PG_LINEFEED, send - sptr) : NULL;
+		span = (NULL != lfptr ? lfptr : send) - sptr;
+		if (out + 1 < max)
+		{
+			ncopy = max - 1 - out;
+			if (ncopy > span)
+				ncopy = span;
+			memcpy(dst + out, sptr, ncopy);
+		}
+		out += span;
+		if (NULL == lfptr)
+			break;
+		if (lfptr == si || PG_CARRIAGE_RETURN != lfptr[-1])
 		{
 			/* Only add the carriage-return if needed */
-			if (i > 0 && PG_CARRIAGE_RETURN == si[i - 1])
-			{
-				if (dst)
-					dst[out++] = si[i];
-				else
-					out++;
-				continue;
-			}
-			*changed = TRUE;
-
-			if (dst)
-			{
-				dst[out++] = PG_CARRIAGE_RETURN;
-				dst[out++] = '\n';
-			}
-			else
-				out += 2;
-		}
-		else
-		{
-			if (dst)
-				dst[out++] = si[i];
-			else
-				out++;
-		}
-	}
-	if (dst)
-		dst[out] = '\0';
+			chg = TRUE;
+			if (out + 1 < max)
+				dst[out] = PG_CARRIAGE_RETURN;
+			out++;
+		}
+		if (out + 1 < max)
+			dst[out] = PG_LINEFEED;
+		out++;
+		sptr = lfptr + 1;
+	}
+	if (max > 0)
+		dst[out < max ? out : max - 1] = '\0';
+	if (changed)
+		*changed = chg;
 	return out;
 }
 
@@ -6155,6 +7145,25 @@ convert_special_chars(QueryBuild *qb, const char *si, size_t used)
 	if (!enlarge_query_statement(qb, qb->npos + 1))
 		return FALSE;
 
+	/* no carriage-return to squeeze */
+	if (convlf && NULL == memchr(si, PG_CARRIAGE_RETURN, max))
+		convlf = FALSE;
+	if (!convlf && !double_special)
+	{
+		/* nothing to convert */
+		const char *eptr = memchr(si, '\0', max);
+
+		if (NULL != eptr)
+			max = eptr - si;
+		if (qb->npos + max + 1 >= qb->str_alsize &&
+		    !enlarge_query_statement(qb, qb->npos + max + 1))
+			return FALSE;
+		memcpy(qb->query_statement + qb->npos, si, max);
+		qb->npos += max;
+		qb->query_statement[qb->npos] = '\0';
+		return TRUE;
+	}
+
 	encoded_str_constr(&encstr, ccsc, si);
 	for (i = 0; i < max && si[i]; i++)
 	{
@@ -6448,6 +7457,55 @@ pg_hex2bin(const char *src, char *dst, SQLLEN length)
  *	mapped to PG_TYPE_LO someday, instead of PG_TYPE_TEXT as it is now.
  *-------
  */
+/*
+ *	Read len bytes of the current large object for SQLGetData.
+ *	Applications often call SQLGetData with small buffers, so the data
+ *	is read from the server in LargeObjectChunkSize pieces and kept in
+ *	stmt->lobj_buf for the following calls. Requests not smaller than a
+ *	chunk go straight into the application's buffer.
+ */
+static Int8
+lo_read_ahead(StatementClass *stmt, char *buf, Int8 len)
+{
+	ConnectionClass *conn = SC_get_conn(stmt);
+	Int4		chunk_size = conn->connInfo.lo_chunk_size, nread;
+	Int8		done = 0, ncopy, nstream;
+
+	for (; done < len; done += ncopy)
+	{
+		if (stmt->lobj_bufpos >= stmt->lobj_bufend)
+		{
+			if (chunk_size <= 0 || len - done >= chunk_size)
+			{
+				nstream = odbc_lo_read_stream(conn, stmt->lobj_fd, buf + done, len - done);
+				return nstream < 0 ? nstream : done + nstream;
+			}
+			if (stmt->lobj_buflen != chunk_size)
+			{
+				char	*newbuf = realloc(stmt->lobj_buf, chunk_size);
+
+				if (NULL == newbuf)
+					return -1;
+				stmt->lobj_buf = newbuf;
+				stmt->lobj_buflen = chunk_size;
+			}
+			nread = odbc_lo_read(conn, stmt->lobj_fd, stmt->lobj_buf, stmt->lobj_buflen);
+			if (nread < 0)
+				return -1;
+			stmt->lobj_bufpos = 0;
+			stmt->lobj_bufend = nread;
+			if (0 == nread)
+				break;
+		}
+		ncopy = stmt->lobj_bufend - stmt->lobj_bufpos;
+		if (ncopy > len - done)
+			ncopy = len - done;
+		memcpy(buf + done, stmt->lobj_buf + stmt->lobj_bufpos, ncopy);
+		stmt->lobj_bufpos += (Int4) ncopy;
+	}
+	return done;
+}
+
 static int
 convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbValue,
 		   SQLLEN cbValueMax, SQLLEN *pcbValue)
@@ -6512,12 +7570,13 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 			SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt open large object for reading.", func);
 			return COPY_GENERAL_ERROR;
 		}
+		stmt->lobj_bufpos = stmt->lobj_bufend = 0;
 
-		/* Get the size */
+		/* Get the size, lo_lseek64 returns the new position */
 		retval = odbc_lo_lseek64(conn, stmt->lobj_fd, 0L, SEEK_END);
 		if (retval >= 0)
 		{
-			left64 = odbc_lo_tell64(conn, stmt->lobj_fd);
+			left64 = retval;
 			if (gdata_blob)
 				gdata_blob->data_left64 = left64;
 
@@ -6537,8 +7596,10 @@ convert_lo(StatementClass *stmt, const void *value, SQLSMALLINT fCType, PTR rgbV
 
 	if (0 >= cbValueMax)
 		retval = 0;
+	else if (gdata_blob)
+		retval = lo_read_ahead(stmt, (char *) rgbValue, factor > 1 ? (cbValueMax - 1) / factor : cbValueMax);
 	else
-		retval = (Int8) odbc_lo_read(conn, stmt->lobj_fd, (char *) rgbValue, (Int4) (factor > 1 ? (cbValueMax - 1) / factor : cbValueMax));
+		retval = odbc_lo_read_stream(conn, stmt->lobj_fd, (char *) rgbValue, factor > 1 ? (cbValueMax - 1) / factor : cbValueMax);
 	if (retval < 0)
 	{
 		odbc_lo_close(conn, stmt->lobj_fd);
@@ -23,7 +23,34 @@ extern "C" {
 #define COPY_NO_DATA_FOUND						5
 #define COPY_INVALID_STRING_CONVERSION				6
 
+/*
+ *	Conversion plan for the columns bound by SQLBindCol.
+ *
+ *	A converter specialized for the pair (PG type, C type) is chosen once
+ *	per result set and ARD generation. SC_fetch() then calls it directly
+ *	for each row instead of dispatching through copy_and_convert_field().
+ */
+typedef SQLLEN (*COLUMN_CONVERT_FUNC)(char *value, void *rgbValue);
+struct ColumnConverter_
+{
+	COLUMN_CONVERT_FUNC	convert;	/* NULL means the general path */
+	SQLSMALLINT	returntype;	/* the bound C type the plan was built for */
+	SQLSMALLINT	elemsize;	/* element size in column-wise binding */
+};
+#define	CVT_PLAN_applicable(cvt, bic) \
+	(NULL != (cvt)->convert && (cvt)->returntype == (bic)->returntype)
+
+/*
+ *	Per-connection LRU cache of the rewritten SQL so that repeated
+ *	executions of the same text skip the tokenizer.
+ */
+#define	STMT_REWRITE_CACHE_SIZE	32
+#define	STMT_REWRITE_MAX_LENGTH	65536	/* longer statements aren't cached */
+
 int	copy_and_convert_field_bindinfo(StatementClass *stmt, OID field_type, int atttypmod, void *value, int col);
+ColumnConverter	*SC_get_conversion_plan(StatementClass *stmt, QResultClass *res);
+int	copy_and_convert_field_plan(StatementClass *stmt, const ColumnConverter *cvt, char *value, int col);
+void	copy_and_convert_column_plan(StatementClass *stmt, const ColumnConverter *cvt, int col, const SQLLEN *rows, SQLLEN nrows);
 int	copy_and_convert_field(StatementClass *stmt,
 			OID field_type, int atttypmod,
 			void *value,
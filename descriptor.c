@@ -42,7 +42,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering count=%d\n", count);
 			if (ti[i])
 			{
 				TI_ClearObject(ti[i]);
-				free(ti[i]);
+				OP_put(OP_TABLE_INFO, ti[i]);
 				ti[i] = NULL;
 			}
 		}
@@ -105,7 +105,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering count=%d\n", count);
 				NULL_THE_NAME(fi[i]->before_dot);
 				if (freeFI)
 				{
-					free(fi[i]);
+					OP_put(OP_FIELD_INFO, fi[i]);
 					fi[i] = NULL;
 				}
 			}
@@ -354,32 +354,53 @@ char CC_add_descriptor(ConnectionClass *self, DescriptorClass *desc)
 	int	i;
 	int	new_num_descs;
 	DescriptorClass **descs;
+	char	ret = FALSE;
 
 	MYLOG(MIN_LOG_LEVEL, "entering self=%p, desc=%p\n", self, desc);
 
-	for (i = 0; i < self->num_descs; i++)
+	CONNLOCK_ACQUIRE(self);
+	if (i = HS_get(&self->free_descs), i < 0)
+	{
+		/* no more room -- allocate more memory */
+		new_num_descs = DESC_INCREMENT + self->num_descs;
+		if (!HS_reserve(&self->free_descs, new_num_descs))
+			goto cleanup;
+		descs = (DescriptorClass **) realloc(self->descs, sizeof(DescriptorClass *) * new_num_descs);
+		if (!descs)
+			goto cleanup;
+		self->descs = descs;
+
+		pg_memset(&self->descs[self->num_descs], 0, sizeof(DescriptorClass *) *
+					DESC_INCREMENT);
+		HS_put_range(&self->free_descs, self->num_descs, new_num_descs);
+		self->num_descs = new_num_descs;
+		i = HS_get(&self->free_descs);
+	}
+	DC_get_conn(desc) = self;
+	desc->deschd.conn_slot = i;
+	self->descs[i] = desc;
+	ret = TRUE;
+cleanup:
+	CONNLOCK_RELEASE(self);
+
+	return ret;
+}
+
+char CC_remove_descriptor(ConnectionClass *self, DescriptorClass *desc)
+{
+	int	i = desc->deschd.conn_slot;
+	char	ret = FALSE;
+
+	CONNLOCK_ACQUIRE(self);
+	if (i >= 0 && i < self->num_descs && self->descs[i] == desc)
 	{
-		if (!self->descs[i])
-		{
-			DC_get_conn(desc) = self;
-			self->descs[i] = desc;
-			return TRUE;
-		}
+		self->descs[i] = NULL;
+		HS_put(&self->free_descs, i);
+		ret = TRUE;
 	}
-        /* no more room -- allocate more memory */
-	new_num_descs = DESC_INCREMENT + self->num_descs;
-	descs = (DescriptorClass **) realloc(self->descs, sizeof(DescriptorClass *) * new_num_descs);
-	if (!descs)
-		return FALSE;
-	self->descs = descs;
-
-	pg_memset(&self->descs[self->num_descs], 0, sizeof(DescriptorClass *) *
-				DESC_INCREMENT);
-        DC_get_conn(desc) = self;
-	self->descs[self->num_descs] = desc;
-	self->num_descs = new_num_descs;
+	CONNLOCK_RELEASE(self);
 
-	return TRUE;
+	return ret;
 }
 
 /*
@@ -396,7 +417,7 @@ PGAPI_AllocDesc(HDBC ConnectionHandle,
 
 	MYLOG(MIN_LOG_LEVEL, "entering...\n");
 
-	desc = (DescriptorClass *) malloc(sizeof(DescriptorClass));
+	desc = (DescriptorClass *) OP_get(OP_DESCRIPTOR, sizeof(DescriptorClass));
 	if (desc)
 	{
 		pg_memset(desc, 0, sizeof(DescriptorClass));
@@ -405,7 +426,7 @@ PGAPI_AllocDesc(HDBC ConnectionHandle,
 			*DescriptorHandle = desc;
 		else
 		{
-			free(desc);
+			OP_put(OP_DESCRIPTOR, desc);
 			CC_set_error(conn, CONN_STMT_ALLOC_ERROR, "Maximum number of descriptors exceeded", func);
 			ret = SQL_ERROR;
 		}
@@ -428,18 +449,8 @@ PGAPI_FreeDesc(SQLHDESC DescriptorHandle)
 	DC_Destructor(desc);
 	if (!desc->deschd.embedded)
 	{
-		int	i;
-		ConnectionClass	*conn = DC_get_conn(desc);
-
-		for (i = 0; i < conn->num_descs; i++)
-		{
-			if (conn->descs[i] == desc)
-			{
-				conn->descs[i] = NULL;
-				break;
-			}
-		}
-		free(desc);
+		CC_remove_descriptor(DC_get_conn(desc), desc);
+		OP_put(OP_DESCRIPTOR, desc);
 	}
 	return ret;
 }
@@ -450,7 +461,11 @@ static void BindInfoClass_copy(const BindInfoClass *src, BindInfoClass *target)
 }
 static void ARDFields_copy(const ARDFields *src, ARDFields *target)
 {
+	UInt4	generation = target->generation;
+
 	memcpy(target, src, sizeof(ARDFields));
+	target->generation = generation;
+	ARD_bindings_changed(target);
 	target->bookmark = NULL;
 	if (src->bookmark)
 	{
@@ -105,6 +105,7 @@ void	FI_Destructor(FIELD_INFO **, int, BOOL freeFI);
 typedef struct DescriptorHeader_
 {
 	ConnectionClass	*conn_conn;
+	int	conn_slot;	/* index in conn_conn->descs */
 	char	embedded;
 	char	type_defined;
 	UInt4	desc_type;
@@ -129,7 +130,9 @@ struct ARDFields_
 	BindInfoClass	*bindings;
 	SQLSMALLINT	allocated;
 	SQLLEN		size_of_rowset_odbc2; /* for SQLExtendedFetch */
+	UInt4		generation;	/* changed whenever the bindings change */
 };
+#define	ARD_bindings_changed(ardf)	((ardf)->generation++)
 
 /*
  *	APD must be of the same format as ARD
@@ -819,6 +819,14 @@ copyConnAttributes(ConnInfo *ci, const char *attribute, const char *value)
 		ci->optional_errors = pg_atoi(value);
 	else if (stricmp(attribute, INI_IGNORETIMEOUT) == 0 || stricmp(attribute, ABBR_IGNORETIMEOUT) == 0)
 		ci->ignore_timeout = pg_atoi(value);
+	else if (stricmp(attribute, INI_METADATACACHETTL) == 0 || stricmp(attribute, ABBR_METADATACACHETTL) == 0)
+		ci->metadata_cache_ttl = pg_atoi(value);
+	else if (stricmp(attribute, INI_LOCHUNKSIZE) == 0 || stricmp(attribute, ABBR_LOCHUNKSIZE) == 0)
+		ci->lo_chunk_size = pg_atoi(value);
+	else if (stricmp(attribute, INI_PUTDATASTREAMING) == 0 || stricmp(attribute, ABBR_PUTDATASTREAMING) == 0)
+		ci->putdata_streaming = pg_atoi(value);
+	else if (stricmp(attribute, INI_RESULTMEMORYLIMIT) == 0 || stricmp(attribute, ABBR_RESULTMEMORYLIMIT) == 0)
+		ci->result_memory_limit = pg_atoi(value);
 	else if (stricmp(attribute, INI_SSLMODE) == 0 || stricmp(attribute, ABBR_SSLMODE) == 0)
 	{
 		switch (value[0])
@@ -1004,6 +1012,10 @@ getCiDefaults(ConnInfo *ci)
 	}
 	ci->disable_convert_func = 0;
 	ci->fetch_refcursors = DEFAULT_FETCHREFCURSORS;
+	ci->metadata_cache_ttl = DEFAULT_METADATA_CACHE_TTL;
+	ci->lo_chunk_size = DEFAULT_LO_CHUNK_SIZE;
+	ci->putdata_streaming = DEFAULT_PUTDATA_STREAMING;
+	ci->result_memory_limit = DEFAULT_RESULT_MEMORY_LIMIT;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
 	ci->xa_opt = DEFAULT_XAOPT;
 #endif /* _HANDLE_ENLIST_IN_DTC_ */
@@ -1311,6 +1323,14 @@ MYLOG(MIN_LOG_LEVEL, "drivername=%s\n", drivername);
 			ci->batch_size = DEFAULT_BATCH_SIZE;
 	if (SQLGetPrivateProfileString(DSN, INI_IGNORETIMEOUT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		ci->ignore_timeout = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_METADATACACHETTL, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->metadata_cache_ttl = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_LOCHUNKSIZE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->lo_chunk_size = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_PUTDATASTREAMING, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->putdata_streaming = pg_atoi(temp);
+	if (SQLGetPrivateProfileString(DSN, INI_RESULTMEMORYLIMIT, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
+		ci->result_memory_limit = pg_atoi(temp);
 
 	if (SQLGetPrivateProfileString(DSN, INI_SSLMODE, NULL_STRING, temp, sizeof(temp), ODBC_INI) > 0)
 		STRCPY_FIXED(ci->sslmode, temp);
@@ -1773,6 +1793,26 @@ writeDSNinfo(const ConnInfo *ci)
 								 INI_IGNORETIMEOUT,
 								 temp,
 								 ODBC_INI);
+	ITOA_FIXED(temp, ci->metadata_cache_ttl);
+	SQLWritePrivateProfileString(DSN,
+								 INI_METADATACACHETTL,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->lo_chunk_size);
+	SQLWritePrivateProfileString(DSN,
+								 INI_LOCHUNKSIZE,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->putdata_streaming);
+	SQLWritePrivateProfileString(DSN,
+								 INI_PUTDATASTREAMING,
+								 temp,
+								 ODBC_INI);
+	ITOA_FIXED(temp, ci->result_memory_limit);
+	SQLWritePrivateProfileString(DSN,
+								 INI_RESULTMEMORYLIMIT,
+								 temp,
+								 ODBC_INI);
 	ITOA_FIXED(temp, ci->fetch_refcursors);
 	SQLWritePrivateProfileString(DSN,
 								 INI_FETCHREFCURSORS,
@@ -2236,6 +2276,10 @@ CC_conninfo_init(ConnInfo *conninfo, UInt4 option)
 	conninfo->disable_convert_func = -1;
 	conninfo->batch_size = DEFAULT_BATCH_SIZE;
 	conninfo->ignore_timeout = DEFAULT_IGNORETIMEOUT;
+	conninfo->metadata_cache_ttl = DEFAULT_METADATA_CACHE_TTL;
+	conninfo->lo_chunk_size = DEFAULT_LO_CHUNK_SIZE;
+	conninfo->putdata_streaming = DEFAULT_PUTDATA_STREAMING;
+	conninfo->result_memory_limit = DEFAULT_RESULT_MEMORY_LIMIT;
 	conninfo->wcs_debug = -1;
 	conninfo->fetch_refcursors = -1;
 #ifdef	_HANDLE_ENLIST_IN_DTC_
@@ -2366,6 +2410,10 @@ CC_copy_conninfo(ConnInfo *ci, const ConnInfo *sci)
 	CORR_VALCPY(keepalive_interval);
 	CORR_VALCPY(batch_size);
 	CORR_VALCPY(ignore_timeout);
+	CORR_VALCPY(metadata_cache_ttl);
+	CORR_VALCPY(lo_chunk_size);
+	CORR_VALCPY(putdata_streaming);
+	CORR_VALCPY(result_memory_limit);
 	CORR_VALCPY(fetch_refcursors);
 	// Failover - Copy Connection Info to another Connection Info
 	CORR_VALCPY(enable_failover);
@@ -200,6 +200,14 @@ extern "C" {
 #define INI_DTCLOG			"Dtclog"
 #define INI_FETCHREFCURSORS		"FetchRefcursors"
 #define ABBR_FETCHREFCURSORS		"DA"
+#define INI_METADATACACHETTL		"MetadataCacheTTL"
+#define ABBR_METADATACACHETTL		"DB"
+#define INI_LOCHUNKSIZE			"LargeObjectChunkSize"
+#define ABBR_LOCHUNKSIZE		"DC"
+#define INI_PUTDATASTREAMING		"PutDataStreaming"
+#define ABBR_PUTDATASTREAMING		"DD"
+#define INI_RESULTMEMORYLIMIT		"ResultMemoryLimit"
+#define ABBR_RESULTMEMORYLIMIT		"DE"
 /* "PreferLibpq", abbreviated "D4", used to mean whether to prefer libpq.
  * libpq is now required
 #define INI_PREFERLIBPQ			"PreferLibpq"
@@ -312,6 +320,10 @@ extern "C" {
 #define DEFAULT_BATCH_SIZE			100
 #define DEFAULT_IGNORETIMEOUT			0
 #define DEFAULT_FETCHREFCURSORS			0
+#define DEFAULT_METADATA_CACHE_TTL		0	/* seconds, 0 means disabled */
+#define DEFAULT_LO_CHUNK_SIZE			1048576	/* bytes, 0 means one call per request */
+#define DEFAULT_PUTDATA_STREAMING		0
+#define DEFAULT_RESULT_MEMORY_LIMIT		0	/* megabytes, 0 means unlimited */
 #define DEFAULT_AUTHTYPE			DATABASE_MODE
 #define DEFAULT_REGION				"us-east-1"
 #define DEFAULT_TOKEN_EXPIRATION		"900"
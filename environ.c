@@ -32,6 +32,7 @@
 /* The one instance of the handles */
 static int conns_count = 0;
 static ConnectionClass **conns = NULL;
+static HandleSlots conns_free = {NULL, 0};
 
 #if defined(WIN_MULTITHREAD_SUPPORT)
 CRITICAL_SECTION	conns_cs;
@@ -541,7 +542,10 @@ EN_Destructor(EnvironmentClass *self)
 		else if (conns[lf]->henv == self)
 		{
 			if (CC_Destructor(conns[lf]))
+			{
 				conns[lf] = NULL;
+				HS_put(&conns_free, lf);
+			}
 			else
 				rv = 0;
 			nullcnt++;
@@ -553,6 +557,7 @@ EN_Destructor(EnvironmentClass *self)
 		free(conns);
 		conns = NULL;
 		conns_count = 0;
+		HS_free(&conns_free);
 	}
 	LEAVE_CONNS_CS;
 	DELETE_ENV_CS(self);
@@ -596,31 +601,29 @@ EN_add_connection(EnvironmentClass *self, ConnectionClass *conn)
 	MYLOG(MIN_LOG_LEVEL, "entering self = %p, conn = %p\n", self, conn);
 
 	ENTER_CONNS_CS;
-	for (i = 0; i < conns_count; i++)
+	if (i = HS_get(&conns_free), i < 0)
 	{
-		if (!conns[i])
-		{
-			conn->henv = self;
-			conns[i] = conn;
-			ret = TRUE;
-			MYLOG(MIN_LOG_LEVEL, "       added at i=%d, conn->henv = %p, conns[i]->henv = %p\n", i, conn->henv, conns[i]->henv);
+		/* no more room -- allocate more memory */
+		if (conns_count > 0)
+			alloc = 2 * conns_count;
+		else
+			alloc = INIT_CONN_COUNT;
+		if (!HS_reserve(&conns_free, alloc))
 			goto cleanup;
-		}
+		if (newa = (ConnectionClass **) realloc(conns, alloc * sizeof(ConnectionClass *)), NULL == newa)
+			goto cleanup;
+		conns = newa;
+		for (i = conns_count; i < alloc; i++)
+			conns[i] = NULL;
+		HS_put_range(&conns_free, conns_count, alloc);
+		conns_count = alloc;
+		i = HS_get(&conns_free);
 	}
-	if (conns_count > 0)
-		alloc = 2 * conns_count;
-	else
-		alloc = INIT_CONN_COUNT;
-	if (newa = (ConnectionClass **) realloc(conns, alloc * sizeof(ConnectionClass *)), NULL == newa)
-		goto cleanup;
 	conn->henv = self;
-	newa[conns_count] = conn;
-	conns = newa;
+	conn->env_slot = i;
+	conns[i] = conn;
 	ret = TRUE;
-	MYLOG(MIN_LOG_LEVEL, "       added at %d, conn->henv = %p, conns[%d]->henv = %p\n", conns_count, conn->henv, conns_count, conns[conns_count]->henv);
-	for (i = conns_count + 1; i < alloc; i++)
-		conns[i] = NULL;
-	conns_count = alloc;
+	MYLOG(MIN_LOG_LEVEL, "       added at i=%d, conn->henv = %p, conns[i]->henv = %p\n", i, conn->henv, conns[i]->henv);
 cleanup:
 	LEAVE_CONNS_CS;
 	return ret;
@@ -630,18 +633,20 @@ cleanup:
 char
 EN_remove_connection(EnvironmentClass *self, ConnectionClass *conn)
 {
-	int			i;
+	int			i = conn->env_slot;
+	char		ret = FALSE;
 
-	for (i = 0; i < conns_count; i++)
-		if (conns[i] == conn && conns[i]->status != CONN_EXECUTING)
-		{
-			ENTER_CONNS_CS;
-			conns[i] = NULL;
-			LEAVE_CONNS_CS;
-			return TRUE;
-		}
+	ENTER_CONNS_CS;
+	if (i >= 0 && i < conns_count &&
+	    conns[i] == conn && conn->status != CONN_EXECUTING)
+	{
+		conns[i] = NULL;
+		HS_put(&conns_free, i);
+		ret = TRUE;
+	}
+	LEAVE_CONNS_CS;
 
-	return FALSE;
+	return ret;
 }
 
 
@@ -1427,6 +1427,7 @@ PGAPI_Cancel(HSTMT hstmt)		/* Statement to cancel. */
 		estmt->current_exec_param = -1;
 		estmt->put_data = FALSE;
 		cancelNeedDataState(estmt);
+		SC_unlink_streamed_putdata(estmt);
 		LEAVE_STMT_CS(stmt);
 		return ret;
 	}
@@ -1555,8 +1556,12 @@ PGAPI_ParamData(HSTMT hstmt,
 	{
 		odbc_lo_close(conn, estmt->lobj_fd);
 
-		/* commit transaction if needed */
-		if (!CC_cursor_count(conn) && CC_does_autocommit(conn))
+		/*
+		 * commit transaction if needed; streamed values stay in the
+		 * transaction the statement runs in
+		 */
+		if (!CC_cursor_count(conn) && CC_does_autocommit(conn) &&
+		    !SC_get_PDTI(estmt)->stream_trans)
 		{
 			if (!CC_commit(conn))
 			{
@@ -1577,6 +1582,7 @@ MYLOG(DETAIL_LOG_LEVEL, "ipdopts=%p\n", ipdopts);
 		UWORD	flag = SC_is_with_hold(stmt) ? PODBC_WITH_HOLD : 0;
 
 		retval = Exec_with_parameters_resolved(estmt, stmt->exec_type, &exec_end);
+		SC_unlink_streamed_putdata(estmt);
 		if (exec_end)
 		{
 			/**SC_reset_delegate(retval, stmt);**/
@@ -1641,6 +1647,39 @@ cleanup:
 }
 
 
+/*
+ *	Can the bytea value of a data-at-exec parameter go straight into a
+ *	temporary large object, which the query then reads back with
+ *	pg_catalog.lo_get(), instead of being buffered in the driver ?
+ */
+static BOOL
+putdata_may_stream(const StatementClass *stmt, StatementClass *estmt, const ParameterImplClass *ipara, Int2 ctype)
+{
+	ConnectionClass	*conn = SC_get_conn(estmt);
+
+	if (!conn->connInfo.putdata_streaming || SQL_C_BINARY != ctype)
+		return FALSE;
+	if (PG_VERSION_LT(conn, 9.4))	/* no lo_get() */
+		return FALSE;
+	if (PG_TYPE_BYTEA != PIC_dsp_pgtype(conn, *ipara))
+		return FALSE;
+	/*
+	 * lo_get() has to replace the parameter in the query text. A Bind
+	 * message can't refer to the large object, so keep buffering the
+	 * values of statements whose parameters will be bound.
+	 */
+	if (NAMED_PARSE_REQUEST == SC_get_prepare_method(estmt) ||
+	    PREPARED_PERMANENTLY == estmt->prepared)
+		return FALSE;
+	if (HowToPrepareBeforeExec(estmt, FALSE) >= allowParse &&
+	    SQL_CONCUR_READ_ONLY == estmt->options.scroll_concurrency)
+		return FALSE;
+	/* a deferred batch would run after the large object is gone */
+	if (DEFFERED_EXEC == stmt->exec_type)
+		return FALSE;
+	return TRUE;
+}
+
 /*
  *	Supplies parameter data at execution time.
  *	Used in conjunction with SQLParamData.
@@ -1664,6 +1703,7 @@ PGAPI_PutData(HSTMT hstmt,
 	char	   *putbuf, *allocbuf = NULL;
 	Int2		ctype;
 	SQLLEN		putlen;
+	Int8		written;
 	BOOL		lenset = FALSE, handling_lo = FALSE;
 
 	MYLOG(MIN_LOG_LEVEL, "entering...\n");
@@ -1760,16 +1800,18 @@ PGAPI_PutData(HSTMT hstmt,
 		}
 
 		*current_pdata->EXEC_used = putlen;
+		current_pdata->streamed = (!handling_lo && putdata_may_stream(stmt, estmt, current_iparam, ctype));
 
 		if (cbValue == SQL_NULL_DATA)
 		{
+			current_pdata->streamed = FALSE;
 			retval = SQL_SUCCESS;
 			goto cleanup;
 		}
 
 		/* Handle Long Var Binary with Large Objects */
 		/* if (current_iparam->SQLType == SQL_LONGVARBINARY) */
-		if (handling_lo)
+		if (handling_lo || current_pdata->streamed)
 		{
 			/* begin transaction if needed */
 			if (!CC_is_in_trans(conn))
@@ -1780,6 +1822,8 @@ PGAPI_PutData(HSTMT hstmt,
 					retval = SQL_ERROR;
 					goto cleanup;
 				}
+				if (current_pdata->streamed)
+					SC_get_PDTI(estmt)->stream_trans = TRUE;
 			}
 
 			/* store the oid */
@@ -1806,8 +1850,14 @@ PGAPI_PutData(HSTMT hstmt,
 				goto cleanup;
 			}
 
-			retval = odbc_lo_write(conn, estmt->lobj_fd, putbuf, (Int4) putlen);
-			MYLOG(MIN_LOG_LEVEL, "lo_write: cbValue=" FORMAT_LEN ", wrote %d bytes\n", putlen, retval);
+			written = odbc_lo_write_stream(conn, estmt->lobj_fd, putbuf, putlen);
+			MYLOG(MIN_LOG_LEVEL, "lo_write: cbValue=" FORMAT_LEN ", wrote " FORMATI64 " bytes\n", putlen, written);
+			if (written < 0)
+			{
+				SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt write to large object.", func);
+				retval = SQL_ERROR;
+				goto cleanup;
+			}
 		}
 		else
 		{
@@ -1828,11 +1878,17 @@ PGAPI_PutData(HSTMT hstmt,
 		MYLOG(MIN_LOG_LEVEL, "(>1) cbValue = " FORMAT_LEN "\n", cbValue);
 
 		/* if (current_iparam->SQLType == SQL_LONGVARBINARY) */
-		if (handling_lo)
+		if (handling_lo || current_pdata->streamed)
 		{
 			/* the large object fd is in EXEC_buffer */
-			retval = odbc_lo_write(conn, estmt->lobj_fd, putbuf, (Int4) putlen);
-			MYLOG(MIN_LOG_LEVEL, "lo_write(2): cbValue = " FORMAT_LEN ", wrote %d bytes\n", putlen, retval);
+			written = odbc_lo_write_stream(conn, estmt->lobj_fd, putbuf, putlen);
+			MYLOG(MIN_LOG_LEVEL, "lo_write(2): cbValue = " FORMAT_LEN ", wrote " FORMATI64 " bytes\n", putlen, written);
+			if (written < 0)
+			{
+				SC_set_error(stmt, STMT_EXEC_ERROR, "Couldnt write to large object.", func);
+				retval = SQL_ERROR;
+				goto cleanup;
+			}
 
 			*current_pdata->EXEC_used += putlen;
 		}
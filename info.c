@@ -2168,7 +2168,7 @@ retry_public_schema:
 			tuple = QR_AddNew(res);
 
 			if (list_cat || !list_some)
-				set_tuplefield_string(&tuple[TABLES_CATALOG_NAME], CurrCat(conn));
+				QR_set_tuplefield_string(res, &tuple[TABLES_CATALOG_NAME], CurrCat(conn));
 			else
 				set_tuplefield_null(&tuple[TABLES_CATALOG_NAME]);
 
@@ -2184,29 +2184,29 @@ retry_public_schema:
 			MYLOG(MIN_LOG_LEVEL, "table_name = '%s'\n", table_name);
 
 			if (list_schemas || !list_some)
-				set_tuplefield_string(&tuple[TABLES_SCHEMA_NAME], GET_SCHEMA_NAME(table_owner));
+				QR_set_tuplefield_string(res, &tuple[TABLES_SCHEMA_NAME], GET_SCHEMA_NAME(table_owner));
 			else
 				set_tuplefield_null(&tuple[TABLES_SCHEMA_NAME]);
 			if (list_some)
 				set_tuplefield_null(&tuple[TABLES_TABLE_NAME]);
 			else
-				set_tuplefield_string(&tuple[TABLES_TABLE_NAME], table_name);
+				QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_NAME], table_name);
 			if (list_table_types || !list_some)
 			{
 				if (systable)
-					set_tuplefield_string(&tuple[TABLES_TABLE_TYPE], CSTR_SYS_TABLE);
+					QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_TYPE], CSTR_SYS_TABLE);
 				else if (view)
-					set_tuplefield_string(&tuple[TABLES_TABLE_TYPE], CSTR_VIEW);
+					QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_TYPE], CSTR_VIEW);
 				else if (matview)
-					set_tuplefield_string(&tuple[TABLES_TABLE_TYPE], CSTR_MATVIEW);
+					QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_TYPE], CSTR_MATVIEW);
 				else if (foreign_table)
-					set_tuplefield_string(&tuple[TABLES_TABLE_TYPE], CSTR_FOREIGN_TABLE);
+					QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_TYPE], CSTR_FOREIGN_TABLE);
 				else
-					set_tuplefield_string(&tuple[TABLES_TABLE_TYPE], CSTR_TABLE);
+					QR_set_tuplefield_string(res, &tuple[TABLES_TABLE_TYPE], CSTR_TABLE);
 			}
 			else
 				set_tuplefield_null(&tuple[TABLES_TABLE_TYPE]);
-			set_tuplefield_string(&tuple[TABLES_REMARKS], NULL_STRING);
+			QR_set_tuplefield_string(res, &tuple[TABLES_REMARKS], NULL_STRING);
 			/*** set_tuplefield_string(&tuple[TABLES_REMARKS], "TABLE"); ***/
 		}
 		result = PGAPI_Fetch(tbl_stmt);
@@ -2747,11 +2747,11 @@ MYLOG(MIN_LOG_LEVEL, " and the data=%s\n", attdef);
 		tuple = QR_AddNew(res);
 
 		sqltype = SQL_TYPE_NULL;	/* unspecified */
-		set_tuplefield_string(&tuple[COLUMNS_CATALOG_NAME], CurrCat(conn));
+		QR_set_tuplefield_string(res, &tuple[COLUMNS_CATALOG_NAME], CurrCat(conn));
 		/* see note in SQLTables() */
-		set_tuplefield_string(&tuple[COLUMNS_SCHEMA_NAME], GET_SCHEMA_NAME(table_owner));
-		set_tuplefield_string(&tuple[COLUMNS_TABLE_NAME], table_name);
-		set_tuplefield_string(&tuple[COLUMNS_COLUMN_NAME], field_name);
+		QR_set_tuplefield_string(res, &tuple[COLUMNS_SCHEMA_NAME], GET_SCHEMA_NAME(table_owner));
+		QR_set_tuplefield_string(res, &tuple[COLUMNS_TABLE_NAME], table_name);
+		QR_set_tuplefield_string(res, &tuple[COLUMNS_COLUMN_NAME], field_name);
 		auto_unique = SQL_FALSE;
 		if (field_type = pg_true_type(conn, field_type, basetype), field_type == basetype)
 			mod_length = typmod;
@@ -2761,7 +2761,7 @@ MYLOG(MIN_LOG_LEVEL, " and the data=%s\n", attdef);
 				if (0 != pg_atoi(ci->fake_oid_index))
 				{
 					auto_unique = SQL_TRUE;
-					set_tuplefield_string(&tuple[COLUMNS_TYPE_NAME], "identity");
+					QR_set_tuplefield_string(res, &tuple[COLUMNS_TYPE_NAME], "identity");
 					break;
 				}
 			case PG_TYPE_INT4:
@@ -2777,12 +2777,12 @@ MYLOG(MIN_LOG_LEVEL, " and the data=%s\n", attdef);
 						char	tmp[256];
 
 						SPRINTF_FIXED(tmp, "%s identity", field_type_name);
-						set_tuplefield_string(&tuple[COLUMNS_TYPE_NAME], tmp);
+						QR_set_tuplefield_string(res, &tuple[COLUMNS_TYPE_NAME], tmp);
 						break;
 					}
 				}
 			default:
-				set_tuplefield_string(&tuple[COLUMNS_TYPE_NAME], field_type_name);
+				QR_set_tuplefield_string(res, &tuple[COLUMNS_TYPE_NAME], field_type_name);
 				break;
 		}
 
@@ -2815,35 +2815,35 @@ MYLOG(MIN_LOG_LEVEL, " and the data=%s\n", attdef);
 				if (mod_length >= 4)
 					mod_length -= 4;
 		}
-		set_tuplefield_int4(&tuple[COLUMNS_PRECISION], PGTYPE_ATTR_COLUMN_SIZE(conn, field_type, mod_length));
-		set_tuplefield_int4(&tuple[COLUMNS_LENGTH], PGTYPE_ATTR_BUFFER_LENGTH(conn, field_type, mod_length));
-		set_tuplefield_int4(&tuple[COLUMNS_DISPLAY_SIZE], PGTYPE_ATTR_DISPLAY_SIZE(conn, field_type, mod_length));
-		set_nullfield_int2(&tuple[COLUMNS_SCALE], PGTYPE_ATTR_DECIMAL_DIGITS(conn, field_type, mod_length));
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_PRECISION], PGTYPE_ATTR_COLUMN_SIZE(conn, field_type, mod_length));
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_LENGTH], PGTYPE_ATTR_BUFFER_LENGTH(conn, field_type, mod_length));
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_DISPLAY_SIZE], PGTYPE_ATTR_DISPLAY_SIZE(conn, field_type, mod_length));
+		QR_set_nullfield_int2(res, &tuple[COLUMNS_SCALE], PGTYPE_ATTR_DECIMAL_DIGITS(conn, field_type, mod_length));
 
 		sqltype = PGTYPE_ATTR_TO_CONCISE_TYPE(conn, field_type, mod_length);
 		concise_type = PGTYPE_ATTR_TO_SQLDESCTYPE(conn, field_type, mod_length);
 
-		set_tuplefield_int2(&tuple[COLUMNS_DATA_TYPE], sqltype);
+		QR_set_tuplefield_int2(res, &tuple[COLUMNS_DATA_TYPE], sqltype);
 
-		set_nullfield_int2(&tuple[COLUMNS_RADIX], pgtype_radix(conn, field_type));
-		set_tuplefield_int2(&tuple[COLUMNS_NULLABLE], (Int2) (not_null[0] != '0' ? SQL_NO_NULLS : pgtype_nullable(conn, field_type)));
-		set_tuplefield_string(&tuple[COLUMNS_REMARKS], NULL_STRING);
+		QR_set_nullfield_int2(res, &tuple[COLUMNS_RADIX], pgtype_radix(conn, field_type));
+		QR_set_tuplefield_int2(res, &tuple[COLUMNS_NULLABLE], (Int2) (not_null[0] != '0' ? SQL_NO_NULLS : pgtype_nullable(conn, field_type)));
+		QR_set_tuplefield_string(res, &tuple[COLUMNS_REMARKS], NULL_STRING);
 		if (attdef && strlen(attdef) > INFO_VARCHAR_SIZE)
-			set_tuplefield_string(&tuple[COLUMNS_COLUMN_DEF], "TRUNCATE");
+			QR_set_tuplefield_string(res, &tuple[COLUMNS_COLUMN_DEF], "TRUNCATE");
 		else
-			set_tuplefield_string(&tuple[COLUMNS_COLUMN_DEF], attdef);
-		set_tuplefield_int2(&tuple[COLUMNS_SQL_DATA_TYPE], concise_type);
-		set_nullfield_int2(&tuple[COLUMNS_SQL_DATETIME_SUB], pgtype_attr_to_datetime_sub(conn, field_type, mod_length));
-		set_tuplefield_int4(&tuple[COLUMNS_CHAR_OCTET_LENGTH], PGTYPE_ATTR_TRANSFER_OCTET_LENGTH(conn, field_type, mod_length));
-		set_tuplefield_int4(&tuple[COLUMNS_ORDINAL_POSITION], ordinal);
+			QR_set_tuplefield_string(res, &tuple[COLUMNS_COLUMN_DEF], attdef);
+		QR_set_tuplefield_int2(res, &tuple[COLUMNS_SQL_DATA_TYPE], concise_type);
+		QR_set_nullfield_int2(res, &tuple[COLUMNS_SQL_DATETIME_SUB], pgtype_attr_to_datetime_sub(conn, field_type, mod_length));
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_CHAR_OCTET_LENGTH], PGTYPE_ATTR_TRANSFER_OCTET_LENGTH(conn, field_type, mod_length));
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_ORDINAL_POSITION], ordinal);
 		set_tuplefield_null(&tuple[COLUMNS_IS_NULLABLE]);
-		set_tuplefield_int4(&tuple[COLUMNS_FIELD_TYPE], field_type);
-		set_tuplefield_int4(&tuple[COLUMNS_AUTO_INCREMENT], auto_unique);
-		set_tuplefield_int2(&tuple[COLUMNS_PHYSICAL_NUMBER], field_number);
-		set_tuplefield_int4(&tuple[COLUMNS_TABLE_OID], greloid);
-		set_tuplefield_int4(&tuple[COLUMNS_BASE_TYPEID], basetype);
-		set_tuplefield_int4(&tuple[COLUMNS_ATTTYPMOD], mod_length);
-		set_tuplefield_int4(&tuple[COLUMNS_TABLE_INFO], table_info);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_FIELD_TYPE], field_type);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_AUTO_INCREMENT], auto_unique);
+		QR_set_tuplefield_int2(res, &tuple[COLUMNS_PHYSICAL_NUMBER], field_number);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_TABLE_OID], greloid);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_BASE_TYPEID], basetype);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_ATTTYPMOD], mod_length);
+		QR_set_tuplefield_int4(res, &tuple[COLUMNS_TABLE_INFO], table_info);
 		ordinal++;
 
 		result = PGAPI_Fetch(col_stmt);
@@ -3255,37 +3255,16 @@ PGAPI_Statistics(HSTMT hstmt,
 	CSTR func = "PGAPI_Statistics";
 	StatementClass *stmt = (StatementClass *) hstmt;
 	ConnectionClass *conn;
-	QResultClass	*res;
-	PQExpBufferData		index_query = {0};
+	QResultClass	*res = NULL;
+	PQExpBufferData		index_query = {0}, table_query = {0};
 	RETCODE		ret = SQL_ERROR, result;
 	char		*escSchemaName = NULL, *table_name = NULL, *escTableName = NULL;
-	char		index_name[MAX_INFO_STRING];
-	short		fields_vector[INDEX_KEYS_STORAGE_COUNT + 1];
-	short		indopt_vector[INDEX_KEYS_STORAGE_COUNT + 1];
-	char		isunique[10],
-				isclustered[10],
-				ishash[MAX_INFO_STRING];
-	SQLLEN		index_name_len, fields_vector_len;
-	TupleField	*tuple;
+	char		table_schemaname[MAX_INFO_STRING];
 	int			i;
-	StatementClass *col_stmt = NULL, *indx_stmt = NULL;
-	char		column_name[MAX_INFO_STRING],
-			table_schemaname[MAX_INFO_STRING],
-				relhasrules[10];
-	struct columns_idx {
-		int	pnum;
-		char	*col_name;
-	} *column_names = NULL;
-	/* char	  **column_names = NULL; */
-	SQLLEN		column_name_len;
-	int		total_columns = 0, alcount;
 	ConnInfo   *ci;
-	char		buf[256];
-	SQLSMALLINT	internal_asis_type = SQL_C_CHAR, cbSchemaName, field_number;
+	SQLSMALLINT	cbSchemaName;
 	const SQLCHAR *szSchemaName;
-	const char *eq_string;
-	OID		ioid;
-	Int4		relhasoids;
+	const char *eq_string, *catalog_expr;
 
 	static const char *catcn[][2] = {
 		{"TABLE_CAT", "TABLE_QUALIFIER"},
@@ -3301,6 +3280,10 @@ PGAPI_Statistics(HSTMT hstmt,
 		{"CARDINALITY", "CARDINALITY"},
 		{"PAGES", "PAGES"},
 		{"FILTER_CONDITION", "FILTER_CONDITION"}};
+	/* the types of the result columns, see also catcn[] */
+	static const char *stats_types[] = {
+		"varchar", "varchar", "varchar", "int2", "varchar", "varchar",
+		"int2", "int2", "varchar", "char(1)", "int4", "int4", "varchar"};
 	EnvironmentClass *env;
 	BOOL is_ODBC2;
 
@@ -3320,43 +3303,6 @@ PGAPI_Statistics(HSTMT hstmt,
 	ci = &(conn->connInfo);
 	env = CC_get_env(conn);
 	is_ODBC2 = EN_is_odbc2(env);
-#ifdef	UNICODE_SUPPORT
-	if (CC_is_in_unicode_driver(conn))
-		internal_asis_type = INTERNAL_ASIS_TYPE;
-#endif /* UNICODE_SUPPORT */
-
-	if (res = QR_Constructor(), !res)
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for PGAPI_Statistics result.", func);
-		free(table_name);
-		return SQL_ERROR;
-	}
-	SC_set_Result(stmt, res);
-
-	/* the binding structure for a statement is not set up until */
-
-	/*
-	 * a statement is actually executed, so we'll have to do this
-	 * ourselves.
-	 */
-	extend_column_bindings(SC_get_ARDF(stmt), 13);
-
-	stmt->catalog_result = TRUE;
-	/* set the field names */
-	QR_set_num_fields(res, NUM_OF_STATS_FIELDS);
-	QR_set_field_info_EN(res, STATS_CATALOG_NAME, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_SCHEMA_NAME, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_TABLE_NAME, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_NON_UNIQUE, PG_TYPE_INT2, 2);
-	QR_set_field_info_EN(res, STATS_INDEX_QUALIFIER, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_INDEX_NAME, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_TYPE, PG_TYPE_INT2, 2);
-	QR_set_field_info_EN(res, STATS_SEQ_IN_INDEX, PG_TYPE_INT2, 2);
-	QR_set_field_info_EN(res, STATS_COLUMN_NAME, PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_EN(res, STATS_COLLATION, PG_TYPE_CHAR, 1);
-	QR_set_field_info_EN(res, STATS_CARDINALITY, PG_TYPE_INT4, 4);
-	QR_set_field_info_EN(res, STATS_PAGES, PG_TYPE_INT4, 4);
-	QR_set_field_info_EN(res, STATS_FILTER_CONDITION, PG_TYPE_VARCHAR, MAX_INFO_STRING);
 
 #define	return	DONT_CALL_RETURN_FROM_HERE???
 	szSchemaName = szTableOwner;
@@ -3365,382 +3311,156 @@ PGAPI_Statistics(HSTMT hstmt,
 	table_schemaname[0] = '\0';
 	schema_str(table_schemaname, sizeof(table_schemaname), szSchemaName, cbSchemaName, TABLE_IS_VALID(szTableName, cbTableName), conn);
 
+	/* TableName cannot contain a string search pattern */
+	escTableName = simpleCatalogEscape((SQLCHAR *) table_name, SQL_NTS, conn);
+	escSchemaName = simpleCatalogEscape((SQLCHAR *) table_schemaname, SQL_NTS, conn);
+	eq_string = gen_opestr(eqop, conn);
+
 	/*
-	 * we need to get a list of the field names first, so we can return
-	 * them later.
+	 * The oid of the target table.  If the table isn't found in the
+	 * specified schema, the 'public' schema may be searched instead
+	 * (see allow_public_schema()).
 	 */
-	result = PGAPI_AllocStmt(conn, (HSTMT *) &col_stmt, 0);
-	if (!SQL_SUCCEEDED(result))
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "PGAPI_AllocStmt failed in PGAPI_Statistics for columns.", func);
+	initPQExpBuffer(&table_query);
+	printfPQExpBuffer(&table_query, "(select tc.oid"
+		" from pg_catalog.pg_class tc inner join pg_catalog.pg_namespace tn"
+		" on tn.oid operator(pg_catalog.=) tc.relnamespace"
+		" where tc.relname %s'%s'", eq_string, escTableName);
+	if (escSchemaName && escSchemaName[0])
+	{
+		appendPQExpBuffer(&table_query, " and (tn.nspname %s'%s'", eq_string, escSchemaName);
+		if (allow_public_schema(conn, (SQLCHAR *) table_schemaname, SQL_NTS))
+			appendPQExpBuffer(&table_query, " or tn.nspname operator(pg_catalog.=) '%s'", pubstr);
+		appendPQExpBufferStr(&table_query, ")");
+	}
+	appendPQExpBuffer(&table_query, " order by tn.nspname operator(pg_catalog.=) '%s' limit 1)", pubstr);
+	if (PQExpBufferDataBroken(table_query))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_Statistics()", func);
 		goto cleanup;
 	}
 
 	/*
-	 * table_name parameter cannot contain a string search pattern.
+	 * Build the whole result on the server side.  Each index column is
+	 * a row of the index's pg_attribute entries, so neither the column
+	 * list of the table nor the definitions of expression columns have
+	 * to be fetched separately.
 	 */
-	result = PGAPI_Columns(col_stmt,
-						   NULL, 0,
-						   (SQLCHAR *) table_schemaname, SQL_NTS,
-						   (SQLCHAR *) table_name, SQL_NTS,
-						   NULL, 0,
-						   PODBC_NOT_SEARCH_PATTERN | PODBC_SEARCH_PUBLIC_SCHEMA, 0, 0);
-
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-	result = PGAPI_BindCol(col_stmt, COLUMNS_COLUMN_NAME + 1, internal_asis_type,
-						 column_name, sizeof(column_name), &column_name_len);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-	result = PGAPI_BindCol(col_stmt, COLUMNS_PHYSICAL_NUMBER + 1, SQL_C_SHORT,
-			&field_number, sizeof(field_number), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-
-	alcount = 0;
-	result = PGAPI_Fetch(col_stmt);
-	while (SQL_SUCCEEDED(result))
-	{
-		if (0 == total_columns)
-			PGAPI_GetData(col_stmt, 2, internal_asis_type, table_schemaname, sizeof(table_schemaname), NULL);
-
-		if (total_columns >= alcount)
-		{
-			if (0 == alcount)
-				alcount = 4;
-			else
-				alcount *= 2;
-			SC_REALLOC_gexit_with_error(column_names, struct columns_idx, alcount * sizeof(struct columns_idx), stmt, "Couldn't allocate memory for column names.", (result = SQL_ERROR));
-		}
-		column_names[total_columns].col_name = strdup(column_name);
-		if (!column_names[total_columns].col_name)
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for column name.", func);
-			goto cleanup;
-		}
-		column_names[total_columns].pnum = field_number;
-		total_columns++;
-
-		MYLOG(MIN_LOG_LEVEL, "column_name = '%s'\n", column_name);
-
-		result = PGAPI_Fetch(col_stmt);
-	}
-
-	if (result != SQL_NO_DATA_FOUND)
-	{
-		SC_full_error_copy(stmt, col_stmt, FALSE);
-		goto cleanup;
-	}
-	PGAPI_FreeStmt(col_stmt, SQL_DROP);
-	col_stmt = NULL;
-	if (total_columns == 0)
-	{
-		/* Couldn't get column names in SQLStatistics.; */
-		ret = SQL_SUCCESS;
-		goto cleanup;
-	}
-
-	/* get a list of indexes on this table */
-	result = PGAPI_AllocStmt(conn, (HSTMT *) &indx_stmt, 0);
-	if (!SQL_SUCCEEDED(result))
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "PGAPI_AllocStmt failed in SQLStatistics for indices.", func);
-		goto cleanup;
-
-	}
-
-	/* TableName cannot contain a string search pattern */
-	escTableName = simpleCatalogEscape((SQLCHAR *) table_name, SQL_NTS, conn);
-	eq_string = gen_opestr(eqop, conn);
-	escSchemaName = simpleCatalogEscape((SQLCHAR *) table_schemaname, SQL_NTS, conn);
+	catalog_expr = CurrCat(conn) ? "pg_catalog.current_database()" : "NULL";
 	initPQExpBuffer(&index_query);
-	printfPQExpBuffer(&index_query, "select c.relname, i.indkey, i.indisunique"
-		", i.indisclustered, a.amname, c.relhasrules, n.nspname"
-		", c.oid, %s, %s"
-		" from pg_catalog.pg_index i, pg_catalog.pg_class c,"
-		" pg_catalog.pg_class d, pg_catalog.pg_am a,"
-		" pg_catalog.pg_namespace n"
-		" where d.relname %s'%s'"
-		" and n.nspname %s'%s'"
-		" and n.oid operator(pg_catalog.=) d.relnamespace"
-		" and d.oid operator(pg_catalog.=) i.indrelid"
-		" and i.indexrelid operator(pg_catalog.=) c.oid"
-		" and c.relam operator(pg_catalog.=) a.oid order by"
-        , PG_VERSION_LT(conn, 12.0) ? "d.relhasoids" : "0"
-		, PG_VERSION_GE(conn, 8.3) ? "i.indoption" : "0"
-		, eq_string, escTableName, eq_string, escSchemaName);
-	appendPQExpBufferStr(&index_query, " i.indisprimary desc,");
-	appendPQExpBufferStr(&index_query, " i.indisunique, n.nspname, c.relname");
+	for (i = 0; i < NUM_OF_STATS_FIELDS; i++)
+		appendPQExpBuffer(&index_query, "%s s.c%d::%s as \"%s\"",
+			0 == i ? "select" : ",", i, stats_types[i], catcn[i][is_ODBC2]);
+	appendPQExpBufferStr(&index_query, " from (");
+	/* fake index of OID */
+	if (PG_VERSION_LT(conn, 12.0) &&
+	    pg_atoi(ci->show_oid_column) && pg_atoi(ci->fake_oid_index))
+	{
+		appendPQExpBuffer(&index_query, "select 0 as o0, true as o1"
+			", true as o2, d.relname as o3"
+			", %s as c0, n.nspname as c1, d.relname as c2, %d as c3"
+			", n.nspname as c4, d.relname || '_idx_fake_oid' as c5"
+			", %d as c6, 1 as c7, '%s' as c8, 'A' as c9"
+			", NULL as c10, NULL as c11, NULL as c12"
+			" from pg_catalog.pg_class d inner join pg_catalog.pg_namespace n"
+			" on n.oid operator(pg_catalog.=) d.relnamespace"
+			" where d.oid operator(pg_catalog.=) %s"
+			" and d.relhasoids and not d.relhasrules"
+			" union all "
+			, catalog_expr, ci->drivers.unique_index ? FALSE : TRUE
+			, SQL_INDEX_OTHER, OID_NAME, table_query.data);
+	}
+	appendPQExpBuffer(&index_query, "select 1 as o0, i.indisprimary as o1"
+		", i.indisunique as o2, c.relname as o3"
+		", %s as c0, n.nspname as c1, d.relname as c2"
+		", case when %s then 0 else 1 end as c3"
+		", n.nspname as c4, c.relname as c5"
+		", case when i.indisclustered then %d"
+		" when a.amname operator(pg_catalog.~~) 'hash%%' then %d"
+		" else %d end as c6"
+		", ia.attnum as c7"
+		", case i.indkey[ia.attnum operator(pg_catalog.-) 1]"
+		" when 0 then pg_catalog.pg_get_indexdef(i.indexrelid, ia.attnum, true)"
+		" when %d then '%s'"
+		" else coalesce(ta.attname::text, 'UNKNOWN') end as c8"
+		, catalog_expr
+		, ci->drivers.unique_index ? "i.indisunique" : "false"
+		, SQL_INDEX_CLUSTERED, SQL_INDEX_HASHED, SQL_INDEX_OTHER
+		, OID_ATTNUM, OID_NAME);
+	if (PG_VERSION_GE(conn, 8.3))
+		appendPQExpBuffer(&index_query, ", case when i.indoption[ia.attnum operator(pg_catalog.-) 1]"
+			" operator(pg_catalog.&) %d operator(pg_catalog.<>) 0"
+			" then 'D' else 'A' end as c9", INDOPTION_DESC);
+	else
+		appendPQExpBufferStr(&index_query, ", 'A' as c9");
+	appendPQExpBuffer(&index_query, ", NULL as c10, NULL as c11, NULL as c12"
+		" from pg_catalog.pg_class d"
+		" inner join pg_catalog.pg_namespace n"
+		" on n.oid operator(pg_catalog.=) d.relnamespace"
+		" inner join pg_catalog.pg_index i"
+		" on i.indrelid operator(pg_catalog.=) d.oid"
+		" inner join pg_catalog.pg_class c"
+		" on c.oid operator(pg_catalog.=) i.indexrelid"
+		" inner join pg_catalog.pg_am a"
+		" on a.oid operator(pg_catalog.=) c.relam"
+		" inner join pg_catalog.pg_attribute ia"
+		" on ia.attrelid operator(pg_catalog.=) i.indexrelid"
+		" and ia.attnum operator(pg_catalog.>) 0"
+		" left join pg_catalog.pg_attribute ta"
+		" on ta.attrelid operator(pg_catalog.=) d.oid"
+		" and ta.attnum operator(pg_catalog.=) i.indkey[ia.attnum operator(pg_catalog.-) 1]"
+		" and ta.attnum operator(pg_catalog.>) 0"
+		" and (not ta.attisdropped)"
+		" where d.oid operator(pg_catalog.=) %s", table_query.data);
+	/* If only requesting unique indexes, then just return those. */
+	if (fUnique == SQL_INDEX_UNIQUE)
+		appendPQExpBufferStr(&index_query, " and i.indisunique");
+	appendPQExpBufferStr(&index_query, ") s order by s.o0, s.o1 desc, s.o2, s.o3, s.c7");
 	if (PQExpBufferDataBroken(index_query))
 	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_Columns()", func);
-		goto cleanup;
-	}
-
-	result = PGAPI_ExecDirect(indx_stmt, (SQLCHAR *) index_query.data, SQL_NTS, PODBC_RDONLY);
-	if (!SQL_SUCCEEDED(result))
-	{
-		/*
-		 * "Couldn't execute index query (w/SQLExecDirect) in
-		 * SQLStatistics.";
-		 */
-		SC_full_error_copy(stmt, indx_stmt, FALSE);
-		goto cleanup;
-	}
-
-	/* bind the index name column */
-	result = PGAPI_BindCol(indx_stmt, 1, internal_asis_type,
-						   index_name, MAX_INFO_STRING, &index_name_len);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-
-	}
-	/* bind the vector column */
-	result = PGAPI_BindCol(indx_stmt, 2, SQL_C_DEFAULT,
-			fields_vector, sizeof(fields_vector), &fields_vector_len);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-
-	}
-	/* bind the "is unique" column */
-	result = PGAPI_BindCol(indx_stmt, 3, internal_asis_type,
-						   isunique, sizeof(isunique), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-
-	/* bind the "is clustered" column */
-	result = PGAPI_BindCol(indx_stmt, 4, internal_asis_type,
-						   isclustered, sizeof(isclustered), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-
-	}
-
-	/* bind the "is hash" column */
-	result = PGAPI_BindCol(indx_stmt, 5, internal_asis_type,
-						   ishash, sizeof(ishash), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-
-	}
-
-	result = PGAPI_BindCol(indx_stmt, 6, internal_asis_type,
-					relhasrules, sizeof(relhasrules), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-
-	result = PGAPI_BindCol(indx_stmt, 8, SQL_C_ULONG,
-					&ioid, sizeof(ioid), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
-		goto cleanup;
-	}
-
-	result = PGAPI_BindCol(indx_stmt, 9, SQL_C_ULONG,
-					&relhasoids, sizeof(relhasoids), NULL);
-	if (!SQL_SUCCEEDED(result))
-	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_Statistics()", func);
 		goto cleanup;
 	}
+	MYLOG(MIN_LOG_LEVEL, "index_query='%s'\n", index_query.data);
 
-	/* bind the vector column */
-	result = PGAPI_BindCol(indx_stmt, 10, SQL_C_DEFAULT,
-			indopt_vector, sizeof(fields_vector), &fields_vector_len);
-	if (!SQL_SUCCEEDED(result))
+	if (res = CC_send_query(conn, index_query.data, NULL, READ_ONLY_QUERY, stmt), !QR_command_maybe_successful(res))
 	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "PGAPI_Statistics query error", func);
 		goto cleanup;
-
-	}
-
-	relhasrules[0] = '0';
-	result = PGAPI_Fetch(indx_stmt);
-	/* fake index of OID */
-	if (relhasoids && relhasrules[0] != '1' && pg_atoi(ci->show_oid_column) && pg_atoi(ci->fake_oid_index))
-	{
-		tuple = QR_AddNew(res);
-
-		/* no table qualifier */
-		set_tuplefield_string(&tuple[STATS_CATALOG_NAME], CurrCat(conn));
-		/* don't set the table owner, else Access tries to use it */
-		set_tuplefield_string(&tuple[STATS_SCHEMA_NAME], GET_SCHEMA_NAME(table_schemaname));
-		set_tuplefield_string(&tuple[STATS_TABLE_NAME], table_name);
-
-		/* non-unique index? */
-		set_tuplefield_int2(&tuple[STATS_NON_UNIQUE], (Int2) (ci->drivers.unique_index ? FALSE : TRUE));
-
-		/* no index qualifier */
-		set_tuplefield_string(&tuple[STATS_INDEX_QUALIFIER], GET_SCHEMA_NAME(table_schemaname));
-
-		SPRINTF_FIXED(buf, "%s_idx_fake_oid", table_name);
-		set_tuplefield_string(&tuple[STATS_INDEX_NAME], buf);
-
-		/*
-		 * Clustered/HASH index?
-		 */
-		set_tuplefield_int2(&tuple[STATS_TYPE], (Int2) SQL_INDEX_OTHER);
-		set_tuplefield_int2(&tuple[STATS_SEQ_IN_INDEX], (Int2) 1);
-
-		set_tuplefield_string(&tuple[STATS_COLUMN_NAME], OID_NAME);
-		set_tuplefield_string(&tuple[STATS_COLLATION], "A");
-		set_tuplefield_null(&tuple[STATS_CARDINALITY]);
-		set_tuplefield_null(&tuple[STATS_PAGES]);
-		set_tuplefield_null(&tuple[STATS_FILTER_CONDITION]);
 	}
+	SC_set_Result(stmt, res);
+	stmt->catalog_result = TRUE;
 
-	while (SQL_SUCCEEDED(result))
-	{
-		/* If only requesting unique indexes, then just return those. */
-		if (fUnique == SQL_INDEX_ALL ||
-			(fUnique == SQL_INDEX_UNIQUE && pg_atoi(isunique)))
-		{
-			int	colcnt, attnum;
-
-			/* add a row in this table for each field in the index */
-			colcnt = fields_vector[0];
-			for (i = 1; i <= colcnt; i++)
-			{
-				tuple = QR_AddNew(res);
-
-				/* no table qualifier */
-				set_tuplefield_string(&tuple[STATS_CATALOG_NAME], CurrCat(conn));
-				/* don't set the table owner, else Access tries to use it */
-				set_tuplefield_string(&tuple[STATS_SCHEMA_NAME], GET_SCHEMA_NAME(table_schemaname));
-				set_tuplefield_string(&tuple[STATS_TABLE_NAME], table_name);
-
-				/* non-unique index? */
-				if (ci->drivers.unique_index)
-					set_tuplefield_int2(&tuple[STATS_NON_UNIQUE], (Int2) (pg_atoi(isunique) ? FALSE : TRUE));
-				else
-					set_tuplefield_int2(&tuple[STATS_NON_UNIQUE], TRUE);
-
-				/* no index qualifier */
-				set_tuplefield_string(&tuple[STATS_INDEX_QUALIFIER], GET_SCHEMA_NAME(table_schemaname));
-				set_tuplefield_string(&tuple[STATS_INDEX_NAME], index_name);
-
-				/*
-				 * Clustered/HASH index?
-				 */
-				set_tuplefield_int2(&tuple[STATS_TYPE], (Int2)
-							   (pg_atoi(isclustered) ? SQL_INDEX_CLUSTERED :
-								(!strncmp(ishash, "hash", 4)) ? SQL_INDEX_HASHED : SQL_INDEX_OTHER));
-				set_tuplefield_int2(&tuple[STATS_SEQ_IN_INDEX], (Int2) i);
-
-				attnum = fields_vector[i];
-				if (OID_ATTNUM == attnum)
-				{
-					set_tuplefield_string(&tuple[STATS_COLUMN_NAME], OID_NAME);
-					MYLOG(MIN_LOG_LEVEL, "column name = oid\n");
-				}
-				else if (0 == attnum)
-				{
-					char	cmd[64];
-
-					QResultClass *res;
-
-					SPRINTF_FIXED(cmd, "select pg_catalog.pg_get_indexdef(%u, %d, true)", ioid, i);
-					res = CC_send_query(conn, cmd, NULL, READ_ONLY_QUERY, stmt);
-					if (QR_command_maybe_successful(res))
-						set_tuplefield_string(&tuple[STATS_COLUMN_NAME], QR_get_value_backend_text(res, 0, 0));
-					QR_Destructor(res);
-				}
-				else
-				{
-					int j, matchidx;
-					BOOL	unknownf = TRUE;
-
-					if (attnum > 0)
-					{
-						for (j = 0; j < total_columns; j++)
-						{
-							if (attnum == column_names[j].pnum)
-							{
-								matchidx = j;
-								unknownf = FALSE;
-								break;
-							}
-						}
-					}
-					if (unknownf)
-					{
-						set_tuplefield_string(&tuple[STATS_COLUMN_NAME], "UNKNOWN");
-						MYLOG(MIN_LOG_LEVEL, "column name = UNKNOWN\n");
-					}
-					else
-					{
-						set_tuplefield_string(&tuple[STATS_COLUMN_NAME], column_names[matchidx].col_name);
-						MYLOG(MIN_LOG_LEVEL, "column name = '%s'\n", column_names[matchidx].col_name);
-					}
-				}
-
-				if (i <= indopt_vector[0] &&
-				    (indopt_vector[i] & INDOPTION_DESC) != 0)
-					set_tuplefield_string(&tuple[STATS_COLLATION], "D");
-				else
-					set_tuplefield_string(&tuple[STATS_COLLATION], "A");
-				set_tuplefield_null(&tuple[STATS_CARDINALITY]);
-				set_tuplefield_null(&tuple[STATS_PAGES]);
-				set_tuplefield_null(&tuple[STATS_FILTER_CONDITION]);
-			}
-		}
+	/* the binding structure for a statement is not set up until */
 
-		result = PGAPI_Fetch(indx_stmt);
-	}
-	if (result != SQL_NO_DATA_FOUND)
-	{
-		/* "SQLFetch failed in SQLStatistics."; */
-		SC_full_error_copy(stmt, indx_stmt, FALSE);
-		goto cleanup;
-	}
+	/*
+	 * a statement is actually executed, so we'll have to do this
+	 * ourselves.
+	 */
+	extend_column_bindings(SC_get_ARDF(stmt), NUM_OF_STATS_FIELDS);
 	ret = SQL_SUCCESS;
 
 cleanup:
 #undef	return
+	if (!SQL_SUCCEEDED(ret))
+		QR_Destructor(res);
 	/*
 	 * also, things need to think that this statement is finished so the
 	 * results can be retrieved.
 	 */
 	stmt->status = STMT_FINISHED;
 
-	if (!SQL_SUCCEEDED(ret) && 0 >= SC_get_errornumber(stmt))
-	{
-		SC_error_copy(stmt, col_stmt, TRUE);
-		if (0 >= SC_get_errornumber(stmt))
-			SC_error_copy(stmt, indx_stmt, TRUE);
-	}
-
-	if (col_stmt)
-		PGAPI_FreeStmt(col_stmt, SQL_DROP);
-	if (indx_stmt)
-		PGAPI_FreeStmt(indx_stmt, SQL_DROP);
 	/* These things should be freed on any error ALSO! */
 	if (!PQExpBufferDataBroken(index_query))
 		termPQExpBuffer(&index_query);
+	if (!PQExpBufferDataBroken(table_query))
+		termPQExpBuffer(&table_query);
 	if (table_name)
 		free(table_name);
 	if (escTableName)
 		free(escTableName);
 	if (escSchemaName)
 		free(escSchemaName);
-	if (column_names)
-	{
-		for (i = 0; i < total_columns; i++)
-			free(column_names[i].col_name);
-		free(column_names);
-	}
 
 	/* set up the current tuple pointer for SQLFetch */
 	stmt->currTuple = -1;
@@ -4163,95 +3883,6 @@ cleanup:
 }
 
 
-/*
- *	Multibyte support stuff for SQLForeignKeys().
- *	There may be much more effective way in the
- *	future version. The way is very forcible currently.
- */
-static BOOL
-isMultibyte(const char *str)
-{
-	for (; *str; str++)
-	{
-		if ((unsigned char) *str >= 0x80)
-			return TRUE;
-	}
-	return FALSE;
-}
-static char *
-getClientColumnName(ConnectionClass *conn, UInt4 relid, char *serverColumnName, BOOL *nameAlloced)
-{
-	char		query[1024], saveattnum[16],
-			   *ret = serverColumnName;
-	const char *eq_string;
-	BOOL		continueExec = TRUE,
-				bError = FALSE;
-	QResultClass *res = NULL;
-	UWORD	flag = READ_ONLY_QUERY;
-
-	*nameAlloced = FALSE;
-	if (!conn->original_client_encoding || !isMultibyte(serverColumnName))
-		return ret;
-	if (!conn->server_encoding)
-	{
-		if (res = CC_send_query(conn, "select getdatabaseencoding()", NULL, flag, NULL), QR_command_maybe_successful(res))
-		{
-			if (QR_get_num_cached_tuples(res) > 0)
-				conn->server_encoding = strdup(QR_get_value_backend_text(res, 0, 0));
-		}
-		QR_Destructor(res);
-		res = NULL;
-	}
-	if (!conn->server_encoding)
-		return ret;
-	SPRINTF_FIXED(query, "SET CLIENT_ENCODING TO '%s'", conn->server_encoding);
-	bError = (!QR_command_maybe_successful((res = CC_send_query(conn, query, NULL, flag, NULL))));
-	QR_Destructor(res);
-	eq_string = gen_opestr(eqop, conn);
-	if (!bError && continueExec)
-	{
-		SPRINTF_FIXED(query, "select attnum from pg_catalog.pg_attribute "
-			"where attrelid operator(pg_catalog.=) %u and attname %s'%s'",
-			relid, eq_string, serverColumnName);
-		if (res = CC_send_query(conn, query, NULL, flag, NULL), QR_command_maybe_successful(res))
-		{
-			if (QR_get_num_cached_tuples(res) > 0)
-			{
-				STRCPY_FIXED(saveattnum, QR_get_value_backend_text(res, 0, 0));
-			}
-			else
-				continueExec = FALSE;
-		}
-		else
-			bError = TRUE;
-		QR_Destructor(res);
-	}
-	continueExec = (continueExec && !bError);
-	/* restore the client encoding */
-	SPRINTF_FIXED(query, "SET CLIENT_ENCODING TO '%s'", conn->original_client_encoding);
-	bError = (!QR_command_maybe_successful((res = CC_send_query(conn, query, NULL, flag, NULL))));
-	QR_Destructor(res);
-	if (bError || !continueExec)
-		return ret;
-	SPRINTF_FIXED(query, "select attname from pg_catalog.pg_attribute where attrelid operator(pg_catalog.=) %u and attnum operator(pg_catalog.=) %s", relid, saveattnum);
-	if (res = CC_send_query(conn, query, NULL, flag, NULL), QR_command_maybe_successful(res))
-	{
-		if (QR_get_num_cached_tuples(res) > 0)
-		{
-			char *tmp;
-
-			tmp = strdup(QR_get_value_backend_text(res, 0, 0));
-			if (tmp)
-			{
-				ret = tmp;
-				*nameAlloced = TRUE;
-			}
-		}
-	}
-	QR_Destructor(res);
-	return ret;
-}
-
 static RETCODE          SQL_API
 PGAPI_ForeignKeys_new(HSTMT hstmt,
 					  const SQLCHAR * szPkTableQualifier, /* OA X*/
@@ -4267,787 +3898,6 @@ PGAPI_ForeignKeys_new(HSTMT hstmt,
 					  const SQLCHAR * szFkTableName, /* OA(R) E*/
 					  SQLSMALLINT cbFkTableName);
 
-static RETCODE		SQL_API
-PGAPI_ForeignKeys_old(HSTMT hstmt,
-					  const SQLCHAR * szPkTableQualifier, /* OA X*/
-					  SQLSMALLINT cbPkTableQualifier,
-					  const SQLCHAR * szPkTableOwner, /* OA E*/
-					  SQLSMALLINT cbPkTableOwner,
-					  const SQLCHAR * szPkTableName, /* OA(R) E*/
-					  SQLSMALLINT cbPkTableName,
-					  const SQLCHAR * szFkTableQualifier, /* OA X*/
-					  SQLSMALLINT cbFkTableQualifier,
-					  const SQLCHAR * szFkTableOwner, /* OA E*/
-					  SQLSMALLINT cbFkTableOwner,
-					  const SQLCHAR * szFkTableName, /* OA(R) E*/
-					  SQLSMALLINT cbFkTableName)
-{
-	CSTR func = "PGAPI_ForeignKeys";
-	StatementClass *stmt = (StatementClass *) hstmt;
-	QResultClass	*res;
-	TupleField	*tuple;
-	HSTMT		hpkey_stmt = NULL;
-	StatementClass *tbl_stmt = NULL;
-	RETCODE		ret = SQL_ERROR, result, keyresult;
-	PQExpBufferData		tables_query = {0};
-	char		trig_deferrable[2];
-	char		trig_initdeferred[2];
-	char		trig_args[1024];
-	char		upd_rule[TABLE_NAME_STORAGE_LEN],
-				del_rule[TABLE_NAME_STORAGE_LEN];
-	char		*pk_table_needed = NULL, *escPkTableName = NULL;
-	char		fk_table_fetched[TABLE_NAME_STORAGE_LEN + 1];
-	char		*fk_table_needed = NULL, *escFkTableName = NULL;
-	char		pk_table_fetched[TABLE_NAME_STORAGE_LEN + 1];
-	char		schema_needed[SCHEMA_NAME_STORAGE_LEN + 1];
-	char		schema_fetched[SCHEMA_NAME_STORAGE_LEN + 1];
-	char		constrname[NAMESTORAGELEN + 1], pkname[TABLE_NAME_STORAGE_LEN + 1];
-	char	   *pkey_ptr,
-			   *pkey_text = NULL,
-			   *fkey_ptr,
-			   *fkey_text = NULL;
-
-	ConnectionClass *conn;
-	BOOL		pkey_alloced,
-			fkey_alloced, got_pkname;
-	int			i,
-				j,
-				k,
-				num_keys;
-	SQLSMALLINT		trig_nargs,
-				upd_rule_type = 0,
-				del_rule_type = 0;
-	SQLSMALLINT	internal_asis_type = SQL_C_CHAR;
-	SQLSMALLINT	defer_type;
-	char		pkey[MAX_INFO_STRING];
-	Int2		result_cols;
-	UInt4		relid1, relid2;
-	const char *eq_string;
-
-	MYLOG(MIN_LOG_LEVEL, "entering...stmt=%p\n", stmt);
-
-	if (result = SC_initialize_and_recycle(stmt), SQL_SUCCESS != result)
-		return result;
-
-	if (res = QR_Constructor(), !res)
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for PGAPI_ForeignKeys result.", func);
-		return SQL_ERROR;
-	}
-	SC_set_Result(stmt, res);
-
-	/* the binding structure for a statement is not set up until */
-
-	/*
-	 * a statement is actually executed, so we'll have to do this
-	 * ourselves.
-	 */
-	result_cols = NUM_OF_FKS_FIELDS;
-	extend_column_bindings(SC_get_ARDF(stmt), result_cols);
-
-	stmt->catalog_result = TRUE;
-	/* set the field names */
-	QR_set_num_fields(res, result_cols);
-	QR_set_field_info_v(res, FKS_PKTABLE_CAT, "PKTABLE_QUALIFIER", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_PKTABLE_SCHEM, "PKTABLE_OWNER", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_PKTABLE_NAME, "PKTABLE_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_PKCOLUMN_NAME, "PKCOLUMN_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_FKTABLE_CAT, "FKTABLE_QUALIFIER", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_FKTABLE_SCHEM, "FKTABLE_OWNER", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_FKTABLE_NAME, "FKTABLE_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_FKCOLUMN_NAME, "FKCOLUMN_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_KEY_SEQ, "KEY_SEQ", PG_TYPE_INT2, 2);
-	QR_set_field_info_v(res, FKS_UPDATE_RULE, "UPDATE_RULE", PG_TYPE_INT2, 2);
-	QR_set_field_info_v(res, FKS_DELETE_RULE, "DELETE_RULE", PG_TYPE_INT2, 2);
-	QR_set_field_info_v(res, FKS_FK_NAME, "FK_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_PK_NAME, "PK_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-	QR_set_field_info_v(res, FKS_DEFERRABILITY, "DEFERRABILITY", PG_TYPE_INT2, 2);
-	QR_set_field_info_v(res, FKS_TRIGGER_NAME, "TRIGGER_NAME", PG_TYPE_VARCHAR, MAX_INFO_STRING);
-
-	/*
-	 * also, things need to think that this statement is finished so the
-	 * results can be retrieved.
-	 */
-	stmt->status = STMT_FINISHED;
-
-	/* set up the current tuple pointer for SQLFetch */
-	stmt->currTuple = -1;
-	SC_set_rowset_start(stmt, -1, FALSE);
-	SC_set_current_col(stmt, -1);
-
-	conn = SC_get_conn(stmt);
-	result = PGAPI_AllocStmt(conn, (HSTMT *) &tbl_stmt, 0);
-	if (!SQL_SUCCEEDED(result))
-	{
-		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate statement for PGAPI_ForeignKeys result.", func);
-		return SQL_ERROR;
-	}
-
-#define	return	DONT_CALL_RETURN_FROM_HERE???
-
-	schema_needed[0] = '\0';
-	schema_fetched[0] = '\0';
-
-	pk_table_needed = make_string(szPkTableName, cbPkTableName, NULL, 0);
-	fk_table_needed = make_string(szFkTableName, cbFkTableName, NULL, 0);
-
-#ifdef	UNICODE_SUPPORT
-	if (CC_is_in_unicode_driver(conn))
-		internal_asis_type = INTERNAL_ASIS_TYPE;
-#endif /* UNICODE_SUPPORT */
-	pkey_alloced = fkey_alloced = FALSE;
-
-	eq_string = gen_opestr(eqop, conn);
-	initPQExpBuffer(&tables_query);
-	/*
-	 * Case #2 -- Get the foreign keys in the specified table (fktab) that
-	 * refer to the primary keys of other table(s).
-	 */
-	if (fk_table_needed && fk_table_needed[0] != '\0')
-	{
-		char    *escSchemaName;
-
-		MYLOG(MIN_LOG_LEVEL, " Foreign Key Case #2\n");
-		escFkTableName = simpleCatalogEscape((SQLCHAR *) fk_table_needed, SQL_NTS, conn);
-		schema_str(schema_needed, sizeof(schema_needed), szFkTableOwner, cbFkTableOwner, TABLE_IS_VALID(szFkTableName, cbFkTableName), conn);
-		escSchemaName = simpleCatalogEscape((SQLCHAR *) schema_needed, SQL_NTS, conn);
-		printfPQExpBuffer(&tables_query, "SELECT	pt.tgargs, "
-			"		pt.tgnargs, "
-			"		pt.tgdeferrable, "
-			"		pt.tginitdeferred, "
-			"		pp1.proname, "
-			"		pp2.proname, "
-			"		pc.oid, "
-			"		pc1.oid, "
-			"		pc1.relname, "
-			"		pt.tgconstrname, pn.nspname "
-			"FROM	pg_catalog.pg_class pc, "
-			"		pg_catalog.pg_proc pp1, "
-			"		pg_catalog.pg_proc pp2, "
-			"		pg_catalog.pg_trigger pt1, "
-			"		pg_catalog.pg_trigger pt2, "
-			"		pg_catalog.pg_proc pp, "
-			"		pg_catalog.pg_trigger pt, "
-			"		pg_catalog.pg_class pc1, "
-			"		pg_catalog.pg_namespace pn, "
-			"		pg_catalog.pg_namespace pn1 "
-			"WHERE	pt.tgrelid operator(pg_catalog.=) pc.oid "
-			"AND pp.oid operator(pg_catalog.=) pt.tgfoid "
-			"AND pt1.tgconstrrelid operator(pg_catalog.=) pc.oid "
-			"AND pp1.oid operator(pg_catalog.=) pt1.tgfoid "
-			"AND pt2.tgfoid operator(pg_catalog.=) pp2.oid "
-			"AND pt2.tgconstrrelid operator(pg_catalog.=) pc.oid "
-			"AND ((pc.relname %s'%s') "
-			"AND (pn1.oid operator(pg_catalog.=) pc.relnamespace) "
-			"AND (pn1.nspname %s'%s') "
-			"AND (pp.proname LIKE '%%ins') "
-			"AND (pp1.proname LIKE '%%upd') "
-			"AND (pp1.proname not LIKE '%%check%%') "
-			"AND (pp2.proname LIKE '%%del') "
-			"AND (pt1.tgrelid operator(pg_catalog.=) pt.tgconstrrelid) "
-			"AND (pt1.tgconstrname operator(pg_catalog.=) pt.tgconstrname) "
-			"AND (pt2.tgrelid operator(pg_catalog.=) pt.tgconstrrelid) "
-			"AND (pt2.tgconstrname operator(pg_catalog.=) pt.tgconstrname) "
-			"AND (pt.tgconstrrelid operator(pg_catalog.=) pc1.oid) "
-			"AND (pc1.relnamespace operator(pg_catalog.=) pn.oid))"
-			" order by pt.tgconstrname",
-			eq_string, escFkTableName, eq_string, escSchemaName);
-		free(escSchemaName);
-		if (PQExpBufferDataBroken(tables_query))
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_ForeignKeys()", func);
-			goto cleanup;
-		}
-
-		result = PGAPI_ExecDirect(tbl_stmt, (SQLCHAR *) tables_query.data, SQL_NTS, PODBC_RDONLY);
-
-		if (!SQL_SUCCEEDED(result))
-		{
-			SC_full_error_copy(stmt, tbl_stmt, FALSE);
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 1, SQL_C_BINARY,
-							   trig_args, sizeof(trig_args), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 2, SQL_C_SHORT,
-							   &trig_nargs, 0, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 3, internal_asis_type,
-						 trig_deferrable, sizeof(trig_deferrable), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 4, internal_asis_type,
-					 trig_initdeferred, sizeof(trig_initdeferred), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 5, internal_asis_type,
-							   upd_rule, sizeof(upd_rule), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 6, internal_asis_type,
-							   del_rule, sizeof(del_rule), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 7, SQL_C_ULONG,
-							   &relid1, sizeof(relid1), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 8, SQL_C_ULONG,
-							   &relid2, sizeof(relid2), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 9, internal_asis_type,
-					pk_table_fetched, TABLE_NAME_STORAGE_LEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 10, internal_asis_type,
-					constrname, NAMESTORAGELEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 11, internal_asis_type,
-				schema_fetched, SCHEMA_NAME_STORAGE_LEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_Fetch(tbl_stmt);
-		if (result == SQL_NO_DATA_FOUND)
-		{
-			ret = SQL_SUCCESS;
-			goto cleanup;
-		}
-
-		if (result != SQL_SUCCESS)
-		{
-			SC_full_error_copy(stmt, tbl_stmt, FALSE);
-			goto cleanup;
-		}
-
-		keyresult = PGAPI_AllocStmt(conn, &hpkey_stmt, 0);
-		if (!SQL_SUCCEEDED(keyresult))
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate statement for PGAPI_ForeignKeys (pkeys) result.", func);
-			goto cleanup;
-		}
-
-		keyresult = PGAPI_BindCol(hpkey_stmt, 4, internal_asis_type,
-								  pkey, sizeof(pkey), NULL);
-		if (keyresult != SQL_SUCCESS)
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't bindcol for primary keys for PGAPI_ForeignKeys result.", func);
-			goto cleanup;
-		}
-
-		while (result == SQL_SUCCESS)
-		{
-			/* Compute the number of keyparts. */
-			num_keys = (trig_nargs - 4) / 2;
-
-			MYLOG(MIN_LOG_LEVEL, "Foreign Key Case#2: trig_nargs = %d, num_keys = %d\n", trig_nargs, num_keys);
-
-			/* If there is a pk table specified, then check it. */
-			if (pk_table_needed && pk_table_needed[0] != '\0')
-			{
-				/* If it doesn't match, then continue */
-				if (strcmp(pk_table_fetched, pk_table_needed))
-				{
-					result = PGAPI_Fetch(tbl_stmt);
-					continue;
-				}
-			}
-
-			got_pkname = FALSE;
-			keyresult = PGAPI_PrimaryKeys(hpkey_stmt, NULL, 0,
-										  (SQLCHAR *) schema_fetched, SQL_NTS,
-										  (SQLCHAR *) pk_table_fetched, SQL_NTS,
-										  0);
-			if (keyresult != SQL_SUCCESS)
-			{
-				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't get primary keys for PGAPI_ForeignKeys result.", func);
-				goto cleanup;
-			}
-
-			/* Get to first primary key */
-			pkey_ptr = trig_args;
-			for (i = 0; i < 5; i++)
-				pkey_ptr += strlen(pkey_ptr) + 1;
-
-			for (k = 0; k < num_keys; k++)
-			{
-				/* Check that the key listed is the primary key */
-				keyresult = PGAPI_Fetch(hpkey_stmt);
-				if (keyresult != SQL_SUCCESS)
-				{
-					num_keys = 0;
-					break;
-				}
-				if (!got_pkname)
-				{
-					PGAPI_GetData(hpkey_stmt, 6, internal_asis_type, pkname, sizeof(pkname), NULL);
-					got_pkname = TRUE;
-				}
-				pkey_text = getClientColumnName(conn, relid2, pkey_ptr, &pkey_alloced);
-				MYLOG(MIN_LOG_LEVEL, "pkey_ptr='%s', pkey='%s'\n", pkey_text, pkey);
-				if (strcmp(pkey_text, pkey))
-				{
-					num_keys = 0;
-					break;
-				}
-				if (pkey_alloced)
-					free(pkey_text);
-				pkey_alloced = FALSE;
-				/* Get to next primary key */
-				for (k = 0; k < 2; k++)
-					pkey_ptr += strlen(pkey_ptr) + 1;
-
-			}
-			PGAPI_FreeStmt(hpkey_stmt, SQL_CLOSE);
-
-			/* Set to first fk column */
-			fkey_ptr = trig_args;
-			for (k = 0; k < 4; k++)
-				fkey_ptr += strlen(fkey_ptr) + 1;
-
-			/* Set update and delete actions for foreign keys */
-			if (!strcmp(upd_rule, "RI_FKey_cascade_upd"))
-				upd_rule_type = SQL_CASCADE;
-			else if (!strcmp(upd_rule, "RI_FKey_noaction_upd"))
-				upd_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(upd_rule, "RI_FKey_restrict_upd"))
-				upd_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(upd_rule, "RI_FKey_setdefault_upd"))
-				upd_rule_type = SQL_SET_DEFAULT;
-			else if (!strcmp(upd_rule, "RI_FKey_setnull_upd"))
-				upd_rule_type = SQL_SET_NULL;
-
-			if (!strcmp(del_rule, "RI_FKey_cascade_del"))
-				del_rule_type = SQL_CASCADE;
-			else if (!strcmp(del_rule, "RI_FKey_noaction_del"))
-				del_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(del_rule, "RI_FKey_restrict_del"))
-				del_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(del_rule, "RI_FKey_setdefault_del"))
-				del_rule_type = SQL_SET_DEFAULT;
-			else if (!strcmp(del_rule, "RI_FKey_setnull_del"))
-				del_rule_type = SQL_SET_NULL;
-
-			/* Set deferrability type */
-			if (!strcmp(trig_initdeferred, "y"))
-				defer_type = SQL_INITIALLY_DEFERRED;
-			else if (!strcmp(trig_deferrable, "y"))
-				defer_type = SQL_INITIALLY_IMMEDIATE;
-			else
-				defer_type = SQL_NOT_DEFERRABLE;
-
-			/* Get to first primary key */
-			pkey_ptr = trig_args;
-			for (i = 0; i < 5; i++)
-				pkey_ptr += strlen(pkey_ptr) + 1;
-
-			for (k = 0; k < num_keys; k++)
-			{
-				tuple = QR_AddNew(res);
-
-				pkey_text = getClientColumnName(conn, relid2, pkey_ptr, &pkey_alloced);
-				fkey_text = getClientColumnName(conn, relid1, fkey_ptr, &fkey_alloced);
-
-				MYLOG(MIN_LOG_LEVEL, "pk_table = '%s', pkey_ptr = '%s'\n", pk_table_fetched, pkey_text);
-				set_tuplefield_string(&tuple[FKS_PKTABLE_CAT], CurrCat(conn));
-				set_tuplefield_string(&tuple[FKS_PKTABLE_SCHEM], GET_SCHEMA_NAME(schema_fetched));
-				set_tuplefield_string(&tuple[FKS_PKTABLE_NAME], pk_table_fetched);
-				set_tuplefield_string(&tuple[FKS_PKCOLUMN_NAME], pkey_text);
-
-				MYLOG(MIN_LOG_LEVEL, "fk_table_needed = '%s', fkey_ptr = '%s'\n", fk_table_needed, fkey_text);
-				set_tuplefield_string(&tuple[FKS_FKTABLE_CAT], CurrCat(conn));
-				set_tuplefield_string(&tuple[FKS_FKTABLE_SCHEM], GET_SCHEMA_NAME(schema_needed));
-				set_tuplefield_string(&tuple[FKS_FKTABLE_NAME], fk_table_needed);
-				set_tuplefield_string(&tuple[FKS_FKCOLUMN_NAME], fkey_text);
-
-				MYLOG(MIN_LOG_LEVEL, "upd_rule_type = '%i', del_rule_type = '%i'\n, trig_name = '%s'", upd_rule_type, del_rule_type, trig_args);
-				set_tuplefield_int2(&tuple[FKS_KEY_SEQ], (Int2) (k + 1));
-				set_tuplefield_int2(&tuple[FKS_UPDATE_RULE], upd_rule_type);
-				set_tuplefield_int2(&tuple[FKS_DELETE_RULE], del_rule_type);
-				set_tuplefield_string(&tuple[FKS_FK_NAME], constrname);
-				set_tuplefield_string(&tuple[FKS_PK_NAME], pkname);
-				set_tuplefield_int2(&tuple[FKS_DEFERRABILITY], defer_type);
-				set_tuplefield_string(&tuple[FKS_TRIGGER_NAME], trig_args);
-
-				if (fkey_alloced)
-					free(fkey_text);
-				fkey_alloced = FALSE;
-				if (pkey_alloced)
-					free(pkey_text);
-				pkey_alloced = FALSE;
-				/* next primary/foreign key */
-				for (i = 0; i < 2; i++)
-				{
-					fkey_ptr += strlen(fkey_ptr) + 1;
-					pkey_ptr += strlen(pkey_ptr) + 1;
-				}
-			}
-
-			result = PGAPI_Fetch(tbl_stmt);
-		}
-	}
-
-	/*
-	 * Case #1 -- Get the foreign keys in other tables that refer to the
-	 * primary key in the specified table (pktab).	i.e., Who points to
-	 * me?
-	 */
-	else if (pk_table_needed[0] != '\0')
-	{
-		char	*escSchemaName;
-
-		escPkTableName = simpleCatalogEscape((SQLCHAR *) pk_table_needed, SQL_NTS, conn);
-		schema_str(schema_needed, sizeof(schema_needed), szPkTableOwner, cbPkTableOwner, TABLE_IS_VALID(szPkTableName, cbPkTableName), conn);
-		escSchemaName = simpleCatalogEscape((SQLCHAR *) schema_needed, SQL_NTS, conn);
-		printfPQExpBuffer(&tables_query, "SELECT	pt.tgargs, "
-			"	pt.tgnargs, "
-			"	pt.tgdeferrable, "
-			"	pt.tginitdeferred, "
-			"	pp1.proname, "
-			"	pp2.proname, "
-			"	pc.oid, "
-			"	pc1.oid, "
-			"	pc1.relname, "
-			"	pt.tgconstrname, pn1.nspname "
-			"FROM	pg_catalog.pg_class pc, "
-			"	pg_catalog.pg_class pc1, "
-			"	pg_catalog.pg_proc pp, "
-			"	pg_catalog.pg_proc pp1, "
-			"	pg_catalog.pg_proc pp2, "
-			"	pg_catalog.pg_trigger pt, "
-			"	pg_catalog.pg_trigger pt1, "
-			"	pg_catalog.pg_trigger pt2, "
-			"	pg_catalog.pg_namespace pn, "
-			"	pg_catalog.pg_namespace pn1 "
-			"WHERE  pc.relname %s'%s' "
-			"	AND pn.nspname %s'%s' "
-			"	AND pc.relnamespace operator(pg_catalog.=) pn.oid "
-			"	AND pt.tgconstrrelid operator(pg_catalog.=) pc.oid "
-			"	AND pp.oid operator(pg_catalog.=) pt.tgfoid "
-			"	AND pp.proname Like '%%ins' "
-			"	AND pt1.tgconstrname operator(pg_catalog.=) pt.tgconstrname "
-			"	AND pt1.tgconstrrelid operator(pg_catalog.=) pt.tgrelid "
-			"	AND pt1.tgrelid operator(pg_catalog.=) pc.oid "
-			"	AND pc1.oid operator(pg_catalog.=) pt.tgrelid "
-			"	AND pp1.oid operator(pg_catalog.=) pt1.tgfoid "
-			"	AND pp1.proname like '%%upd' "
-			"	AND (pp1.proname not like '%%check%%') "
-			"	AND pt2.tgconstrname operator(pg_catalog.=) pt.tgconstrname "
-			"	AND pt2.tgconstrrelid operator(pg_catalog.=) pt.tgrelid "
-			"	AND pt2.tgrelid operator(pg_catalog.=) pc.oid "
-			"	AND pp2.oid operator(pg_catalog.=) pt2.tgfoid "
-			"	AND pp2.proname Like '%%del' "
-			"	AND pn1.oid operator(pg_catalog.=) pc1.relnamespace "
-			" order by pt.tgconstrname",
-			eq_string, escPkTableName, eq_string, escSchemaName);
-		free(escSchemaName);
-		if (PQExpBufferDataBroken(tables_query))
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in PGAPI_ForeignKeys()", func);
-			goto cleanup;
-		}
-
-		result = PGAPI_ExecDirect(tbl_stmt, (SQLCHAR *) tables_query.data, SQL_NTS, PODBC_RDONLY);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 1, SQL_C_BINARY,
-							   trig_args, sizeof(trig_args), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 2, SQL_C_SHORT,
-							   &trig_nargs, 0, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 3, internal_asis_type,
-						 trig_deferrable, sizeof(trig_deferrable), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 4, internal_asis_type,
-					 trig_initdeferred, sizeof(trig_initdeferred), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 5, internal_asis_type,
-							   upd_rule, sizeof(upd_rule), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 6, internal_asis_type,
-							   del_rule, sizeof(del_rule), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 7, SQL_C_ULONG,
-						&relid1, sizeof(relid1), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 8, SQL_C_ULONG,
-						&relid2, sizeof(relid2), NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 9, internal_asis_type,
-					fk_table_fetched, TABLE_NAME_STORAGE_LEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-		result = PGAPI_BindCol(tbl_stmt, 10, internal_asis_type,
-					constrname, NAMESTORAGELEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_BindCol(tbl_stmt, 11, internal_asis_type,
-				schema_fetched, SCHEMA_NAME_STORAGE_LEN, NULL);
-		if (!SQL_SUCCEEDED(result))
-		{
-			goto cleanup;
-		}
-
-		result = PGAPI_Fetch(tbl_stmt);
-		if (result == SQL_NO_DATA_FOUND)
-		{
-			ret = SQL_SUCCESS;
-			goto cleanup;
-		}
-
-		if (result != SQL_SUCCESS)
-		{
-			SC_full_error_copy(stmt, tbl_stmt, FALSE);
-			goto cleanup;
-		}
-
-		/*
-		 *	get pk_name here
-		 */
-		keyresult = PGAPI_AllocStmt(conn, &hpkey_stmt, 0);
-		if (!SQL_SUCCEEDED(keyresult))
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate statement for PGAPI_ForeignKeys (pkeys) result.", func);
-			goto cleanup;
-		}
-		keyresult = PGAPI_BindCol(hpkey_stmt, 6, internal_asis_type,
-				pkname, sizeof(pkname), NULL);
-		if (keyresult != SQL_SUCCESS)
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't bindcol for primary keys for PGAPI_ForeignKeys result.", func);
-			goto cleanup;
-		}
-		keyresult = PGAPI_PrimaryKeys(hpkey_stmt, NULL, 0,
-									  (SQLCHAR *) schema_needed, SQL_NTS,
-									  (SQLCHAR *) pk_table_needed, SQL_NTS, 0);
-		if (keyresult != SQL_SUCCESS)
-		{
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't get primary keys for PGAPI_ForeignKeys result.", func);
-			goto cleanup;
-		}
-		pkname[0] = '\0';
-		keyresult = PGAPI_Fetch(hpkey_stmt);
-		PGAPI_FreeStmt(hpkey_stmt, SQL_CLOSE);
-		while (result == SQL_SUCCESS)
-		{
-			/* Calculate the number of key parts */
-			num_keys = (trig_nargs - 4) / 2;;
-
-			/* Handle action (i.e., 'cascade', 'restrict', 'setnull') */
-			if (!strcmp(upd_rule, "RI_FKey_cascade_upd"))
-				upd_rule_type = SQL_CASCADE;
-			else if (!strcmp(upd_rule, "RI_FKey_noaction_upd"))
-				upd_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(upd_rule, "RI_FKey_restrict_upd"))
-				upd_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(upd_rule, "RI_FKey_setdefault_upd"))
-				upd_rule_type = SQL_SET_DEFAULT;
-			else if (!strcmp(upd_rule, "RI_FKey_setnull_upd"))
-				upd_rule_type = SQL_SET_NULL;
-
-			if (!strcmp(del_rule, "RI_FKey_cascade_del"))
-				del_rule_type = SQL_CASCADE;
-			else if (!strcmp(del_rule, "RI_FKey_noaction_del"))
-				del_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(del_rule, "RI_FKey_restrict_del"))
-				del_rule_type = SQL_NO_ACTION;
-			else if (!strcmp(del_rule, "RI_FKey_setdefault_del"))
-				del_rule_type = SQL_SET_DEFAULT;
-			else if (!strcmp(del_rule, "RI_FKey_setnull_del"))
-				del_rule_type = SQL_SET_NULL;
-
-			/* Set deferrability type */
-			if (!strcmp(trig_initdeferred, "y"))
-				defer_type = SQL_INITIALLY_DEFERRED;
-			else if (!strcmp(trig_deferrable, "y"))
-				defer_type = SQL_INITIALLY_IMMEDIATE;
-			else
-				defer_type = SQL_NOT_DEFERRABLE;
-
-			MYLOG(MIN_LOG_LEVEL, "Foreign Key Case#1: trig_nargs = %d, num_keys = %d\n", trig_nargs, num_keys);
-
-			/* Get to first primary key */
-			pkey_ptr = trig_args;
-			for (i = 0; i < 5; i++)
-				pkey_ptr += strlen(pkey_ptr) + 1;
-
-			/* Get to first foreign key */
-			fkey_ptr = trig_args;
-			for (k = 0; k < 4; k++)
-				fkey_ptr += strlen(fkey_ptr) + 1;
-
-			for (k = 0; k < num_keys; k++)
-			{
-				pkey_text = getClientColumnName(conn, relid1, pkey_ptr, &pkey_alloced);
-				fkey_text = getClientColumnName(conn, relid2, fkey_ptr, &fkey_alloced);
-
-				MYLOG(MIN_LOG_LEVEL, "pkey_ptr = '%s', fk_table = '%s', fkey_ptr = '%s'\n", pkey_text, fk_table_fetched, fkey_text);
-
-				tuple = QR_AddNew(res);
-
-				MYLOG(MIN_LOG_LEVEL, "pk_table_needed = '%s', pkey_ptr = '%s'\n", pk_table_needed, pkey_text);
-				set_tuplefield_string(&tuple[FKS_PKTABLE_CAT], CurrCat(conn));
-				set_tuplefield_string(&tuple[FKS_PKTABLE_SCHEM], GET_SCHEMA_NAME(schema_needed));
-				set_tuplefield_string(&tuple[FKS_PKTABLE_NAME], pk_table_needed);
-				set_tuplefield_string(&tuple[FKS_PKCOLUMN_NAME], pkey_text);
-
-				MYLOG(MIN_LOG_LEVEL, "fk_table = '%s', fkey_ptr = '%s'\n", fk_table_fetched, fkey_text);
-				set_tuplefield_string(&tuple[FKS_FKTABLE_CAT], CurrCat(conn));
-				set_tuplefield_string(&tuple[FKS_FKTABLE_SCHEM], GET_SCHEMA_NAME(schema_fetched));
-				set_tuplefield_string(&tuple[FKS_FKTABLE_NAME], fk_table_fetched);
-				set_tuplefield_string(&tuple[FKS_FKCOLUMN_NAME], fkey_text);
-
-				set_tuplefield_int2(&tuple[FKS_KEY_SEQ], (Int2) (k + 1));
-
-				MYLOG(MIN_LOG_LEVEL, "upd_rule = %d, del_rule= %d", upd_rule_type, del_rule_type);
-				set_nullfield_int2(&tuple[FKS_UPDATE_RULE], upd_rule_type);
-				set_nullfield_int2(&tuple[FKS_DELETE_RULE], del_rule_type);
-
-				set_tuplefield_string(&tuple[FKS_FK_NAME], constrname);
-				set_tuplefield_string(&tuple[FKS_PK_NAME], pkname);
-
-				set_tuplefield_string(&tuple[FKS_TRIGGER_NAME], trig_args);
-
-				MYPRINTF(0, " defer_type = %d\n", defer_type);
-				set_tuplefield_int2(&tuple[FKS_DEFERRABILITY], defer_type);
-
-				if (pkey_alloced)
-					free(pkey_text);
-				pkey_alloced = FALSE;
-				if (fkey_alloced)
-					free(fkey_text);
-				fkey_alloced = FALSE;
-
-				/* next primary/foreign key */
-				for (j = 0; j < 2; j++)
-				{
-					pkey_ptr += strlen(pkey_ptr) + 1;
-					fkey_ptr += strlen(fkey_ptr) + 1;
-				}
-			}
-			result = PGAPI_Fetch(tbl_stmt);
-		}
-	}
-	else
-	{
-		SC_set_error(stmt, STMT_INTERNAL_ERROR, "No tables specified to PGAPI_ForeignKeys.", func);
-		goto cleanup;
-	}
-	ret = SQL_SUCCESS;
-
-cleanup:
-#undef	return
-	/*
-	 * also, things need to think that this statement is finished so the
-	 * results can be retrieved.
-	 */
-	stmt->status = STMT_FINISHED;
-
-	if (!SQL_SUCCEEDED(ret) && 0 >= SC_get_errornumber(stmt))
-		SC_error_copy(stmt, tbl_stmt, TRUE);
-
-	if (!PQExpBufferDataBroken(tables_query))
-		termPQExpBuffer(&tables_query);
-	if (pkey_alloced)
-		free(pkey_text);
-	if (fkey_alloced)
-		free(fkey_text);
-	if (pk_table_needed)
-		free(pk_table_needed);
-	if (escPkTableName)
-		free(escPkTableName);
-	if (fk_table_needed)
-		free(fk_table_needed);
-	if (escFkTableName)
-		free(escFkTableName);
-
-	if (tbl_stmt)
-		PGAPI_FreeStmt(tbl_stmt, SQL_DROP);
-	if (hpkey_stmt)
-		PGAPI_FreeStmt(hpkey_stmt, SQL_DROP);
-
-	/* set up the current tuple pointer for SQLFetch */
-	stmt->currTuple = -1;
-	SC_set_rowset_start(stmt, -1, FALSE);
-	SC_set_current_col(stmt, -1);
-
-	MYLOG(MIN_LOG_LEVEL, "leaving stmt=%p, ret=%d\n", stmt, ret);
-	return ret;
-}
-
 RETCODE		SQL_API
 PGAPI_ForeignKeys(HSTMT hstmt,
 				  const SQLCHAR * szPkTableQualifier, /* OA X*/
@@ -5063,23 +3913,17 @@ PGAPI_ForeignKeys(HSTMT hstmt,
 				  const SQLCHAR * szFkTableName, /* OA(R) E*/
 				  SQLSMALLINT cbFkTableName)
 {
-	ConnectionClass	*conn = SC_get_conn(((StatementClass *) hstmt));
-	if (PG_VERSION_GE(conn, 8.1))
-		return PGAPI_ForeignKeys_new(hstmt,
-				szPkTableQualifier, cbPkTableQualifier,
-				szPkTableOwner, cbPkTableOwner,
-				szPkTableName, cbPkTableName,
-				szFkTableQualifier, cbFkTableQualifier,
-				szFkTableOwner, cbFkTableOwner,
-				szFkTableName, cbFkTableName);
-	else
-		return PGAPI_ForeignKeys_old(hstmt,
-				szPkTableQualifier, cbPkTableQualifier,
-				szPkTableOwner, cbPkTableOwner,
-				szPkTableName, cbPkTableName,
-				szFkTableQualifier, cbFkTableQualifier,
-				szFkTableOwner, cbFkTableOwner,
-				szFkTableName, cbFkTableName);
+	/*
+	 * The keys are expanded from pg_constraint.conkey/confkey on the
+	 * server side, so the whole result is built in one round trip.
+	 */
+	return PGAPI_ForeignKeys_new(hstmt,
+			szPkTableQualifier, cbPkTableQualifier,
+			szPkTableOwner, cbPkTableOwner,
+			szPkTableName, cbPkTableName,
+			szFkTableQualifier, cbFkTableQualifier,
+			szFkTableOwner, cbFkTableOwner,
+			szFkTableName, cbFkTableName);
 }
 
 
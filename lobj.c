@@ -77,6 +77,24 @@ odbc_lo_close(ConnectionClass *conn, int fd)
 }
 
 
+int
+odbc_lo_unlink(ConnectionClass *conn, OID lobjId)
+{
+	LO_ARG		argv[1];
+	int			retval,
+				result_len;
+
+	argv[0].isint = 1;
+	argv[0].len = 4;
+	argv[0].u.integer = lobjId;
+
+	if (!CC_send_function(conn, "lo_unlink", &retval, &result_len, 1, argv, 1))
+		return -1;
+	else
+		return retval;
+}
+
+
 Int4
 odbc_lo_read(ConnectionClass *conn, int fd, char *buf, Int4 len)
 {
@@ -123,6 +141,59 @@ odbc_lo_write(ConnectionClass *conn, int fd, char *buf, Int4 len)
 }
 
 
+/*
+ *	Read or write len bytes in chunks of the LargeObjectChunkSize option.
+ *	The chunks are pipelined when libpq supports it, otherwise they are
+ *	sent one call at a time.
+ */
+static Int8
+odbc_lo_stream(ConnectionClass *conn, int fd, char *buf, Int8 len, BOOL is_write)
+{
+	Int4		chunk_size = conn->connInfo.lo_chunk_size, chunk_len, moved;
+	Int8		done;
+
+	if (len <= 0)
+		return 0;
+	if (chunk_size <= 0 || len <= chunk_size)
+	{
+		if (len != (Int4) len)
+		{
+			CC_set_error(conn, CONN_VALUE_OUT_OF_RANGE, "large object data is too long for one call", __FUNCTION__);
+			return -1;
+		}
+		return is_write ? odbc_lo_write(conn, fd, buf, (Int4) len) : odbc_lo_read(conn, fd, buf, (Int4) len);
+	}
+#ifdef	LIBPQ_HAS_PIPELINING
+	if (done = CC_send_lo_pipeline(conn, fd, buf, len, chunk_size, is_write), -2 != done)
+		return done;
+#endif /* LIBPQ_HAS_PIPELINING */
+	for (done = 0; done < len; done += moved)
+	{
+		chunk_len = (Int4) (len - done > chunk_size ? chunk_size : len - done);
+		moved = is_write ? odbc_lo_write(conn, fd, buf + done, chunk_len) : odbc_lo_read(conn, fd, buf + done, chunk_len);
+		if (moved < 0)
+			return -1;
+		if (moved < chunk_len)
+			return done + moved;
+	}
+	return done;
+}
+
+
+Int8
+odbc_lo_read_stream(ConnectionClass *conn, int fd, char *buf, Int8 len)
+{
+	return odbc_lo_stream(conn, fd, buf, len, FALSE);
+}
+
+
+Int8
+odbc_lo_write_stream(ConnectionClass *conn, int fd, char *buf, Int8 len)
+{
+	return odbc_lo_stream(conn, fd, buf, len, TRUE);
+}
+
+
 Int4
 odbc_lo_lseek(ConnectionClass *conn, int fd, int offset, Int4 whence)
 {
@@ -30,8 +30,11 @@ struct lo_arg
 OID		odbc_lo_creat(ConnectionClass *conn, int mode);
 int		odbc_lo_open(ConnectionClass *conn, int lobjId, int mode);
 int		odbc_lo_close(ConnectionClass *conn, int fd);
+int		odbc_lo_unlink(ConnectionClass *conn, OID lobjId);
 Int4		odbc_lo_read(ConnectionClass *conn, int fd, char *buf, Int4 len);
 Int4		odbc_lo_write(ConnectionClass *conn, int fd, char *buf, Int4 len);
+Int8		odbc_lo_read_stream(ConnectionClass *conn, int fd, char *buf, Int8 len);
+Int8		odbc_lo_write_stream(ConnectionClass *conn, int fd, char *buf, Int8 len);
 Int4		odbc_lo_lseek(ConnectionClass *conn, int fd, int offset, Int4 len);
 Int4		odbc_lo_tell(ConnectionClass *conn, int fd);
 
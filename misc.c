@@ -14,6 +14,7 @@
 
 #include "psqlodbc.h"
 #include "misc.h"
+#include "environ.h"
 
 #include <stdio.h>
 #include <stdarg.h>
@@ -346,3 +347,262 @@ char* hide_password(const char* str, const char end_char)
 
 	return outstr;
 }
+
+
+/*
+ *	Make room for the free slots of a handle array of the given size.
+ */
+BOOL
+HS_reserve(HandleSlots *self, int size)
+{
+	int	*slots;
+
+	if (slots = (int *) realloc(self->slots, sizeof(int) * size), NULL == slots)
+		return FALSE;
+	self->slots = slots;
+	return TRUE;
+}
+
+/*
+ *	Mark the slots [from, to) free. The lowest one is handed out first.
+ */
+void
+HS_put_range(HandleSlots *self, int from, int to)
+{
+	int	i;
+
+	for (i = to - 1; i >= from; i--)
+		self->slots[self->count++] = i;
+}
+
+/*
+ *	Take a free slot, or -1 if the array is full.
+ */
+int
+HS_get(HandleSlots *self)
+{
+	if (self->count <= 0)
+		return -1;
+	return self->slots[--self->count];
+}
+
+void
+HS_put(HandleSlots *self, int slot)
+{
+	self->slots[self->count++] = slot;
+}
+
+void
+HS_free(HandleSlots *self)
+{
+	if (self->slots)
+		free(self->slots);
+	self->slots = NULL;
+	self->count = 0;
+}
+
+
+/*
+ *	Per-thread object pools (see OP_get()).
+ *
+ *	The memory debugging build has to see every allocation, so it
+ *	doesn't pool. Without a thread local storage class the pools are
+ *	disabled as well.
+ */
+#if defined(_MEMORY_DEBUG_)
+#define	OP_DISABLED
+#elif defined(WIN32)
+#define	OP_THREAD_LOCAL	__declspec(thread)
+#elif !defined(POSIX_MULTITHREAD_SUPPORT)
+#define	OP_THREAD_LOCAL
+#elif defined(__GNUC__) || defined(__SUNPRO_C)
+#define	OP_THREAD_LOCAL	__thread
+#else
+#define	OP_DISABLED
+#endif
+
+#ifndef	OP_DISABLED
+typedef struct
+{
+	void	*head[OP_KINDS];	/* freed objects linked through their first word */
+	int	count[OP_KINDS];
+	UInt4	hits[OP_KINDS];
+	UInt4	misses[OP_KINDS];
+}	ObjPoolCache;
+
+static const char * const op_names[OP_KINDS] =
+	{"QResult", "Statement", "Descriptor", "TABLE_INFO", "FIELD_INFO"};
+
+static OP_THREAD_LOCAL ObjPoolCache	*op_cache = NULL;
+
+static void
+op_cache_free(ObjPoolCache *cache)
+{
+	int	kind;
+	void	*obj;
+
+	for (kind = 0; kind < OP_KINDS; kind++)
+	{
+		if (cache->hits[kind] > 0 || cache->misses[kind] > 0)
+			MYLOG(MIN_LOG_LEVEL, "%s pool hits=%u misses=%u cached=%d\n", op_names[kind], cache->hits[kind], cache->misses[kind], cache->count[kind]);
+		while (obj = cache->head[kind], NULL != obj)
+		{
+			cache->head[kind] = *((void **) obj);
+			free(obj);
+		}
+	}
+	free(cache);
+}
+
+#ifdef	POSIX_MULTITHREAD_SUPPORT
+/*
+ *	The key is only used to free the cache of an exiting thread.
+ */
+static pthread_key_t	op_key;
+static pthread_once_t	op_key_once = PTHREAD_ONCE_INIT;
+static BOOL	op_key_valid = FALSE;
+
+static void
+op_thread_exit(void *cache)
+{
+	op_cache = NULL;
+	op_cache_free((ObjPoolCache *) cache);
+}
+
+static void
+op_create_key(void)
+{
+	op_key_valid = (0 == pthread_key_create(&op_key, op_thread_exit));
+}
+#endif /* POSIX_MULTITHREAD_SUPPORT */
+
+static ObjPoolCache *
+op_get_cache(void)
+{
+	ObjPoolCache	*cache;
+
+	if (NULL != op_cache)
+		return op_cache;
+	if (cache = (ObjPoolCache *) calloc(1, sizeof(ObjPoolCache)), NULL == cache)
+		return NULL;
+#ifdef	POSIX_MULTITHREAD_SUPPORT
+	pthread_once(&op_key_once, op_create_key);
+	/* without the key the cache of this thread would leak at its exit */
+	if (!op_key_valid || 0 != pthread_setspecific(op_key, cache))
+	{
+		free(cache);
+		return NULL;
+	}
+#endif /* POSIX_MULTITHREAD_SUPPORT */
+	return op_cache = cache;
+}
+#endif /* OP_DISABLED */
+
+/*
+ *	A number identifying the calling thread which, unlike a thread id, is
+ *	never given to another thread of the process. 0 if it's unavailable.
+ */
+UInt4
+thread_serial(void)
+{
+#ifndef	OP_DISABLED
+	static OP_THREAD_LOCAL UInt4	serial = 0;
+	static UInt4	last_serial = 0;
+
+	if (0 == serial)
+	{
+		shortterm_common_lock();
+		serial = ++last_serial;
+		shortterm_common_unlock();
+	}
+	return serial;
+#else
+	return 0;
+#endif /* OP_DISABLED */
+}
+
+/*
+ *	Get the memory of an object of the kind, a recycled one if this
+ *	thread has any. The size must be the same for every call of a kind.
+ */
+void *
+OP_get(int kind, size_t size)
+{
+#ifndef	OP_DISABLED
+	ObjPoolCache	*cache = op_get_cache();
+	void	*obj;
+
+	if (NULL != cache)
+	{
+		if (obj = cache->head[kind], NULL != obj)
+		{
+			cache->head[kind] = *((void **) obj);
+			cache->count[kind]--;
+			cache->hits[kind]++;
+			return obj;
+		}
+		cache->misses[kind]++;
+	}
+#endif /* OP_DISABLED */
+	return malloc(size);
+}
+
+/*
+ *	Give back an object got by OP_get(). It is freed if the pool of
+ *	this thread is full.
+ */
+void
+OP_put(int kind, void *obj)
+{
+#ifndef	OP_DISABLED
+	ObjPoolCache	*cache;
+
+	if (NULL == obj)
+		return;
+	if (cache = op_get_cache(), NULL != cache &&
+	    cache->count[kind] < OP_MAX_CACHED)
+	{
+		*((void **) obj) = cache->head[kind];
+		cache->head[kind] = obj;
+		cache->count[kind]++;
+		return;
+	}
+#endif /* OP_DISABLED */
+	free(obj);
+}
+
+/*
+ *	Free the objects cached by the calling thread.
+ */
+void
+OP_release_thread(void)
+{
+#ifndef	OP_DISABLED
+	ObjPoolCache	*cache = op_cache;
+
+	if (NULL == cache)
+		return;
+	op_cache = NULL;
+#ifdef	POSIX_MULTITHREAD_SUPPORT
+	if (op_key_valid)
+		pthread_setspecific(op_key, NULL);
+#endif /* POSIX_MULTITHREAD_SUPPORT */
+	op_cache_free(cache);
+#endif /* OP_DISABLED */
+}
+
+/*
+ *	Called when the driver is unloaded. The caches of the other threads
+ *	which are still alive can't be reached and are left as they are.
+ */
+void
+OP_finalize(void)
+{
+	OP_release_thread();
+#if	!defined(OP_DISABLED) && defined(POSIX_MULTITHREAD_SUPPORT)
+	/* the destructor of the key mustn't be called after the unload */
+	if (op_key_valid)
+		pthread_key_delete(op_key);
+	op_key_valid = FALSE;
+#endif
+}
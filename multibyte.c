@@ -235,6 +235,12 @@ pg_mb_maxlen(int characterset_code)
 	}
 }
 
+/*
+ *	In every supported encoding an ASCII byte which isn't the trailing
+ *	byte of a multibyte character (stat 0 or 1 before it) leaves stat 0.
+ *	encoded_nextchar() and encoded_byte_check() rely on this to skip the
+ *	state machine for such bytes.
+ */
 static int
 pg_CS_stat(int stat,unsigned int character,int characterset_code)
 {
@@ -522,7 +528,10 @@ int encoded_nextchar(encoded_str *encstr)
 	if (encstr->pos >= 0 && !encstr->encstr[encstr->pos])
 		return 0;
 	chr = encstr->encstr[++encstr->pos];
-	encstr->ccst = pg_CS_stat(encstr->ccst, (unsigned int) chr, encstr->ccsc);
+	if (chr < 0x80 && encstr->ccst <= 1)	/* an ASCII character */
+		encstr->ccst = 0;
+	else
+		encstr->ccst = pg_CS_stat(encstr->ccst, (unsigned int) chr, encstr->ccsc);
 	return chr;
 }
 ssize_t encoded_position_shift(encoded_str *encstr, size_t shift)
@@ -535,6 +544,9 @@ int encoded_byte_check(encoded_str *encstr, size_t abspos)
 	int	chr;
 
 	chr = encstr->encstr[encstr->pos = abspos];
-	encstr->ccst = pg_CS_stat(encstr->ccst, (unsigned int) chr, encstr->ccsc);
+	if (chr < 0x80 && encstr->ccst <= 1)	/* an ASCII character */
+		encstr->ccst = 0;
+	else
+		encstr->ccst = pg_CS_stat(encstr->ccst, (unsigned int) chr, encstr->ccsc);
 	return chr;
 }
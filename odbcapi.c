@@ -527,14 +527,13 @@ SQLGetFunctions(HDBC ConnectionHandle,
 
 	MYLOG(MIN_LOG_LEVEL, "Entering\n");
 	CC_examine_global_transaction(conn);
-	ENTER_CONN_CS(conn);
+	/* a static answer, no need to wait for the connection lock */
 	CC_clear_error(conn);
 	if (FunctionId == SQL_API_ODBC3_ALL_FUNCTIONS)
 		ret = PGAPI_GetFunctions30(ConnectionHandle, FunctionId, Supported);
 	else
 		ret = PGAPI_GetFunctions(ConnectionHandle, FunctionId, Supported);
 
-	LEAVE_CONN_CS(conn);
 	return ret;
 }
 
@@ -58,11 +58,14 @@ SQLAllocHandle(SQLSMALLINT HandleType,
 			LEAVE_CONN_CS(conn);
 			break;
 		case SQL_HANDLE_DESC:
+			/*
+			 * Registering a descriptor doesn't touch the server, so
+			 * don't wait for the connection lock. The descriptor list
+			 * is guarded by CONNLOCK in CC_add_descriptor().
+			 */
 			conn = (ConnectionClass *) InputHandle;
 			CC_examine_global_transaction(conn);
-			ENTER_CONN_CS(conn);
 			ret = PGAPI_AllocDesc(InputHandle, OutputHandle);
-			LEAVE_CONN_CS(conn);
 MYLOG(DETAIL_LOG_LEVEL, "OutputHandle=%p\n", *OutputHandle);
 			break;
 		default:
@@ -407,6 +410,9 @@ SQLGetConnectAttr(HDBC ConnectionHandle,
 	RETCODE	ret;
 
 	MYLOG(MIN_LOG_LEVEL, "Entering " FORMAT_UINTEGER "\n", Attribute);
+	if (PGOPT_IS_COUNTER_ATTR(Attribute))
+		return PGAPI_GetConnectAttr(ConnectionHandle, Attribute, Value,
+			BufferLength, StringLength);
 	CC_examine_global_transaction((ConnectionClass*) ConnectionHandle);
 	ENTER_CONN_CS((ConnectionClass *) ConnectionHandle);
 	CC_clear_error((ConnectionClass *) ConnectionHandle);
@@ -74,6 +74,9 @@ SQLGetConnectAttrW(HDBC hdbc,
 	RETCODE	ret;
 
 	MYLOG(MIN_LOG_LEVEL, "Entering\n");
+	if (PGOPT_IS_COUNTER_ATTR(fAttribute))
+		return PGAPI_GetConnectAttr(hdbc, fAttribute, rgbValue,
+			cbValueMax, pcbValue);
 	CC_examine_global_transaction((ConnectionClass *) hdbc);
 	ENTER_CONN_CS((ConnectionClass *) hdbc);
 	CC_clear_error((ConnectionClass *) hdbc);
@@ -37,6 +37,7 @@
 
 #include "multibyte.h"
 #include "misc.h"
+#include "environ.h"
 
 #define FLD_INCR	32
 #define TAB_INCR	8
@@ -484,7 +485,7 @@ static BOOL increaseNtab(StatementClass *stmt, const char *func)
 		SC_REALLOC_return_with_error(ti, TABLE_INFO *, (stmt->ntab + TAB_INCR) * sizeof(TABLE_INFO *), stmt, "PGAPI_AllocStmt failed in parse_statement for TABLE_INFO", FALSE);
 		stmt->ti = ti;
 	}
-	wti = ti[stmt->ntab] = (TABLE_INFO *) malloc(sizeof(TABLE_INFO));
+	wti = ti[stmt->ntab] = (TABLE_INFO *) OP_get(OP_TABLE_INFO, sizeof(TABLE_INFO));
 	if (wti == NULL)
 	{
 		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "PGAPI_AllocStmt failed in parse_statement for TABLE_INFO(2).", func);
@@ -655,7 +656,7 @@ MYPRINTF(0, "->%d\n", updatable);
 		{
 			if (wfi = fi[i], NULL == wfi)
 			{
-				wfi = (FIELD_INFO *) malloc(sizeof(FIELD_INFO));
+				wfi = (FIELD_INFO *) OP_get(OP_FIELD_INFO, sizeof(FIELD_INFO));
 				if (wfi == NULL)
 				{
 					SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for field info.", func);
@@ -788,42 +789,336 @@ getCOLIfromTable(ConnectionClass *conn, pgNAME *schema_name, pgNAME table_name,
 	return TRUE; /* success */
 }
 
+/*
+ *	Process-wide cache of the SQLColumns results used by getColumnsInfo().
+ *
+ *	The per-connection col_info cache is lost when a connection is closed
+ *	and isn't shared between the connections of a pool. When the
+ *	MetadataCacheTTL option is positive, the results are also kept here
+ *	for that many seconds, keyed by the connection identity (server,
+ *	database, user and the options which affect the SQLColumns result)
+ *	and the table oid.
+ *	Each entry also keeps the version of the catalog rows describing the
+ *	table (see get_table_version()). It's looked up again whenever the
+ *	entry is used, so a change of the table made by any session makes
+ *	only the entries of that table stale. The lookup is much cheaper than
+ *	the SQLColumns query but still costs a round trip.
+ *	Only the driver's own column lookups (parse_statement, keyset
+ *	cursors, @@identity) use it. SQLColumns, SQLPrimaryKeys,
+ *	SQLStatistics, SQLSpecialColumns and the other catalog functions
+ *	called by the application always query the server.
+ */
+#if defined(WIN_MULTITHREAD_SUPPORT)
+extern  CRITICAL_SECTION        common_cs;
+#elif defined(POSIX_MULTITHREAD_SUPPORT)
+extern  pthread_mutex_t         common_cs;
+#endif /* WIN_MULTITHREAD_SUPPORT */
+
+#define	METADATA_CACHE_SIZE	256
+typedef struct
+{
+	char		*conn_key;
+	OID		table_oid;
+	char		*version;	/* see get_table_version() */
+	QResultClass	*result;	/* private copy of the SQLColumns result */
+	time_t		stored_time;
+} MetadataCacheEntry;
+
+static MetadataCacheEntry	md_cache[METADATA_CACHE_SIZE];
+
+static void
+free_metadata_cache_entry(MetadataCacheEntry *entry)
+{
+	if (entry->conn_key)
+		free(entry->conn_key);
+	entry->conn_key = NULL;
+	if (entry->version)
+		free(entry->version);
+	entry->version = NULL;
+	if (entry->result)
+		QR_Destructor(entry->result);
+	entry->result = NULL;
+	entry->table_oid = 0;
+	entry->stored_time = 0;
+}
+
+static void
+append_key_string(PQExpBufferData *key, const char *str)
+{
+	/* length prefixed so that no value can be taken for a separator */
+	appendPQExpBuffer(key, "%u:%s/", (unsigned int) strlen(str), str);
+}
+
+static void
+make_metadata_cache_key(const ConnectionClass *conn, PQExpBufferData *key)
+{
+	const ConnInfo	*ci = &(conn->connInfo);
+	const EnvironmentClass *env = CC_get_env(conn);
+
+	/* every setting PGAPI_Columns() and pgtype.c consult */
+	append_key_string(key, ci->server);
+	append_key_string(key, ci->port);
+	append_key_string(key, ci->database);
+	append_key_string(key, ci->username);
+	appendPQExpBuffer(key, "%d.%d/%d/%d,%d/%d,%d,%d,%d,%d,%d/%d,%d,%d/%d,%d,%s,%s,%s/%d"
+		, conn->pg_version_major, conn->pg_version_minor
+		, conn->ccsc, CC_is_in_unicode_driver(conn)
+		, NULL != env && EN_is_odbc3(env)
+		, ci->drivers.unknown_sizes, ci->drivers.max_varchar_size
+		, ci->drivers.max_longvarchar_size, ci->drivers.text_as_longvarchar
+		, ci->drivers.unknowns_as_longvarchar, ci->drivers.bools_as_char
+		, ci->int8_as, ci->numeric_as, ci->bytea_as_longvarbinary
+		, conn->ms_jet, ci->fake_mss, ci->fake_oid_index
+		, ci->show_oid_column, ci->row_versioning
+		, conn->lobj_type);
+}
+
+/*
+ *	Looks up the oid of the table specified by greloid or, if it's 0, by
+ *	the schema qualified name of wti and the version of its definition.
+ *	The version lists the transaction ids which wrote the pg_class row
+ *	and the column, default and comment rows of the table. Any ALTER
+ *	TABLE, COMMENT etc. changes it, and a table dropped and created
+ *	again gets another oid.
+ *	Returns FALSE if the table isn't found. *version is malloc'ed.
+ */
+static BOOL
+get_table_version(ConnectionClass *conn, const TABLE_INFO *wti, OID greloid, OID *table_oid, char **version)
+{
+	PQExpBufferData	query = {0};
+	QResultClass	*res = NULL;
+	char		*escSchemaName = NULL, *escTableName = NULL;
+	const char	*eq_string;
+	BOOL		ret = FALSE;
+
+	*table_oid = 0;
+	*version = NULL;
+	if (!PG_VERSION_GE(conn, 8.3))	/* no xid to text cast */
+		return FALSE;
+	if (0 == greloid &&
+	    (NAME_IS_NULL(wti->schema_name) || 0 == GET_NAME(wti->schema_name)[0]))
+		return FALSE;	/* depends on the search_path */
+	initPQExpBuffer(&query);
+	appendPQExpBufferStr(&query, "select c.oid, c.xmin::text"
+		" || '/' || pg_catalog.array_to_string(array(select a.xmin::text"
+		" from pg_catalog.pg_attribute a where a.attrelid = c.oid"
+		" and a.attnum > 0 order by a.attnum), ',')"
+		" || '/' || pg_catalog.array_to_string(array(select d.xmin::text"
+		" from pg_catalog.pg_attrdef d where d.adrelid = c.oid"
+		" order by d.adnum), ',')"
+		" || '/' || pg_catalog.array_to_string(array(select e.xmin::text"
+		" from pg_catalog.pg_description e where e.objoid = c.oid"
+		" and e.classoid = 'pg_catalog.pg_class'::pg_catalog.regclass"
+		" order by e.objsubid), ',')"
+		" from pg_catalog.pg_class c");
+	if (0 != greloid)
+		appendPQExpBuffer(&query, " where c.oid = %u", greloid);
+	else
+	{
+		escSchemaName = identifierEscape((SQLCHAR *) SAFE_NAME(wti->schema_name), SQL_NTS, conn, NULL, -1, FALSE);
+		escTableName = identifierEscape((SQLCHAR *) SAFE_NAME(wti->table_name), SQL_NTS, conn, NULL, -1, FALSE);
+		if (NULL == escSchemaName || NULL == escTableName)
+			goto cleanup;
+		eq_string = (0 != CC_get_escape(conn)) ? "= E" : "= ";
+		appendPQExpBuffer(&query, " inner join pg_catalog.pg_namespace n"
+			" on n.oid = c.relnamespace"
+			" where n.nspname %s'%s' and c.relname %s'%s'",
+			eq_string, escSchemaName, eq_string, escTableName);
+	}
+	if (PQExpBufferDataBroken(query))
+		goto cleanup;
+	res = CC_send_query(conn, query.data, NULL, ROLLBACK_ON_ERROR | IGNORE_ABORT_ON_CONN | READ_ONLY_QUERY, NULL);
+	if (QR_command_maybe_successful(res) &&
+	    1 == QR_get_num_cached_tuples(res) &&
+	    NULL != QR_get_value_backend_text(res, 0, 1))
+	{
+		*table_oid = (OID) strtoul(QR_get_value_backend_text(res, 0, 0), NULL, 10);
+		*version = strdup(QR_get_value_backend_text(res, 0, 1));
+		ret = (NULL != *version);
+	}
+cleanup:
+	QR_Destructor(res);
+	if (escSchemaName)
+		free(escSchemaName);
+	if (escTableName)
+		free(escTableName);
+	if (!PQExpBufferDataBroken(query))
+		termPQExpBuffer(&query);
+	MYLOG(MIN_LOG_LEVEL, "table %u(%s) version=%s\n", *table_oid, PRINT_NAME(wti->table_name), ret ? *version : "(none)");
+	return ret;
+}
+
+/*
+ *	Returns a copy of the cached SQLColumns result for the table or NULL.
+ */
+static QResultClass *
+lookup_metadata_cache(const ConnectionClass *conn, const char *conn_key, OID table_oid, const char *version)
+{
+	QResultClass	*res = NULL;
+	time_t		now;
+	int		i;
+
+	now = time(NULL);
+	ENTER_COMMON_CS;
+	for (i = 0; i < METADATA_CACHE_SIZE; i++)
+	{
+		MetadataCacheEntry	*entry = md_cache + i;
+
+		if (NULL == entry->conn_key ||
+		    entry->table_oid != table_oid ||
+		    strcmp(entry->conn_key, conn_key) != 0)
+			continue;
+		if (now - entry->stored_time >= conn->connInfo.metadata_cache_ttl ||
+		    strcmp(entry->version, version) != 0)
+		{
+			free_metadata_cache_entry(entry);
+			break;
+		}
+		res = QR_duplicate(entry->result);
+		break;
+	}
+	LEAVE_COMMON_CS;
+	MYLOG(MIN_LOG_LEVEL, "table %u %s\n", table_oid, res ? "hit" : "missed");
+	return res;
+}
+
+/*
+ *	Stores a copy of the SQLColumns result res of the table in the
+ *	process-wide cache.
+ */
+static void
+store_metadata_cache(const char *conn_key, OID table_oid, const char *version, const QResultClass *res)
+{
+	const char	*schema_name;
+	MetadataCacheEntry	*entry = NULL;
+	QResultClass	*copy;
+	int		i;
+
+	if (QR_get_num_cached_tuples(res) <= 0)
+		return;
+	schema_name = QR_get_value_backend_text(res, 0, COLUMNS_SCHEMA_NAME);
+	/* temporary tables are private to the session */
+	if (NULL == schema_name || strnicmp(schema_name, "pg_temp_", 8) == 0)
+		return;
+	/* the columns may have been found in another table (the public schema) */
+	if ((OID) strtoul(QR_get_value_backend_text(res, 0, COLUMNS_TABLE_OID), NULL, 10) != table_oid)
+		return;
+	if (copy = QR_duplicate(res), NULL == copy)
+		return;
+	ENTER_COMMON_CS;
+	/* replace the entry of the same table, an empty one or the oldest one */
+	for (i = 0; i < METADATA_CACHE_SIZE; i++)
+	{
+		MetadataCacheEntry	*tentry = md_cache + i;
+
+		if (NULL == tentry->conn_key)
+		{
+			if (NULL == entry || NULL != entry->conn_key)
+				entry = tentry;
+			continue;
+		}
+		if (tentry->table_oid == table_oid &&
+		    strcmp(tentry->conn_key, conn_key) == 0)
+		{
+			entry = tentry;
+			break;
+		}
+		if (NULL == entry ||
+		    (NULL != entry->conn_key && tentry->stored_time < entry->stored_time))
+			entry = tentry;
+	}
+	free_metadata_cache_entry(entry);
+	entry->conn_key = strdup(conn_key);
+	entry->version = strdup(version);
+	if (NULL != entry->conn_key && NULL != entry->version)
+	{
+		entry->table_oid = table_oid;
+		entry->result = copy;
+		entry->stored_time = time(NULL);
+		copy = NULL;
+	}
+	else
+		free_metadata_cache_entry(entry);
+	LEAVE_COMMON_CS;
+	if (copy)
+		QR_Destructor(copy);
+}
+
+/*
+ *	Frees all the entries of the process-wide metadata cache.
+ */
+void
+clear_metadata_cache(void)
+{
+	int	i;
+
+	ENTER_COMMON_CS;
+	for (i = 0; i < METADATA_CACHE_SIZE; i++)
+		free_metadata_cache_entry(md_cache + i);
+	LEAVE_COMMON_CS;
+}
+
 static BOOL
 getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementClass *stmt)
 {
 	BOOL		found = FALSE;
 	RETCODE		result;
 	HSTMT		hcol_stmt = NULL;
-	StatementClass	*col_stmt;
-	QResultClass	*res;
+	StatementClass	*col_stmt = NULL;
+	QResultClass	*res, *cached_res = NULL;
+	PQExpBufferData	conn_key = {0};
+	OID		table_oid = 0;
+	char		*version = NULL;
 
 	MYLOG(MIN_LOG_LEVEL, "entering Getting PG_Columns for table %u(%s)\n", greloid, PRINT_NAME(wti->table_name));
 
 	if (NULL == conn)
 		conn = SC_get_conn(stmt);
-	result = PGAPI_AllocStmt(conn, &hcol_stmt, 0);
-	if (!SQL_SUCCEEDED(result))
+	if (conn->connInfo.metadata_cache_ttl > 0 &&
+	    get_table_version(conn, wti, greloid, &table_oid, &version))
 	{
-		if (stmt)
-			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "PGAPI_AllocStmt failed in parse_statement for columns.", __FUNCTION__);
-		goto cleanup;
+		initPQExpBuffer(&conn_key);
+		make_metadata_cache_key(conn, &conn_key);
+		if (PQExpBufferDataBroken(conn_key))
+		{
+			free(version);
+			version = NULL;
+		}
 	}
+	if (NULL != version &&
+	    (res = lookup_metadata_cache(conn, conn_key.data, table_oid, version), NULL != res))
+	{
+		cached_res = res;
+		result = SQL_SUCCESS;
+	}
+	else
+	{
+		result = PGAPI_AllocStmt(conn, &hcol_stmt, 0);
+		if (!SQL_SUCCEEDED(result))
+		{
+			if (stmt)
+				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "PGAPI_AllocStmt failed in parse_statement for columns.", __FUNCTION__);
+			goto cleanup;
+		}
 
-	col_stmt = (StatementClass *) hcol_stmt;
+		col_stmt = (StatementClass *) hcol_stmt;
 
-	if (greloid)
-		result = PGAPI_Columns(hcol_stmt, NULL, 0,
-				NULL, 0, NULL, 0, NULL, 0,
-				PODBC_SEARCH_BY_IDS, greloid, 0);
-	else
-		result = PGAPI_Columns(hcol_stmt, NULL, 0,
-							   (SQLCHAR *) SAFE_NAME(wti->schema_name), SQL_NTS,
-							   (SQLCHAR *) SAFE_NAME(wti->table_name), SQL_NTS,
-							   NULL, 0,
-							   PODBC_NOT_SEARCH_PATTERN, 0, 0);
-
-	MYLOG(MIN_LOG_LEVEL, "        Past PG_Columns\n");
-	res = SC_get_ExecdOrParsed(col_stmt);
+		if (greloid)
+			result = PGAPI_Columns(hcol_stmt, NULL, 0,
+					NULL, 0, NULL, 0, NULL, 0,
+					PODBC_SEARCH_BY_IDS, greloid, 0);
+		else
+			result = PGAPI_Columns(hcol_stmt, NULL, 0,
+								   (SQLCHAR *) SAFE_NAME(wti->schema_name), SQL_NTS,
+								   (SQLCHAR *) SAFE_NAME(wti->table_name), SQL_NTS,
+								   NULL, 0,
+								   PODBC_NOT_SEARCH_PATTERN, 0, 0);
+
+		MYLOG(MIN_LOG_LEVEL, "        Past PG_Columns\n");
+		res = SC_get_ExecdOrParsed(col_stmt);
+		if (SQL_SUCCEEDED(result) && NULL != res && NULL != version)
+			store_metadata_cache(conn_key.data, table_oid, version, res);
+	}
 	if (SQL_SUCCEEDED(result)
 		&& res != NULL && QR_get_num_cached_tuples(res) > 0)
 	{
@@ -926,6 +1221,7 @@ getColumnsInfo(ConnectionClass *conn, TABLE_INFO *wti, OID greloid, StatementCla
 		coli->refcnt = tmp_refcnt;
 		coli->refcnt++; /* Counting one reference to coli object from connection COL_INFO cache table. */
 		coli->result = res;
+		cached_res = NULL;
 		if (res && QR_get_num_cached_tuples(res) > 0)
 		{
 			int num_tuples = QR_get_num_cached_tuples(res);
@@ -968,7 +1264,8 @@ MYLOG(DETAIL_LOG_LEVEL, "#2 %p->table_name=%s(%u)\n", wti, PRINT_NAME(wti->table
 		 * The connection will now free the result structures, so
 		 * make sure that the statement doesn't free it
 		 */
-		SC_init_Result(col_stmt);
+		if (col_stmt)
+			SC_init_Result(col_stmt);
 
 		if (!coli_exist)
 			conn->ntables++;
@@ -996,6 +1293,12 @@ MYLOG(MIN_LOG_LEVEL, "!!!refcnt %p:%d -> %d\n", wti->col_info, wti->col_info->re
 cleanup:
 	if (hcol_stmt)
 		PGAPI_FreeStmt(hcol_stmt, SQL_DROP);
+	if (cached_res)
+		QR_Destructor(cached_res);
+	if (version)
+		free(version);
+	if (!PQExpBufferDataBroken(conn_key))
+		termPQExpBuffer(&conn_key);
 	return found;
 }
 
@@ -1474,6 +1777,7 @@ MYLOG(MIN_LOG_LEVEL, "blevel=%d btoken=%s in_dot=%d in_field=%d tbname=%s\n", bl
 					{
 						free(stmt->statement);
 						stmt->statement = news;
+						SC_forget_query_commands(stmt);
 					}
 				}
 			}
@@ -1552,7 +1856,7 @@ MYLOG(MIN_LOG_LEVEL, "blevel=%d btoken=%s in_dot=%d in_field=%d tbname=%s\n", bl
 					if (NULL != wfi)
 						fi_reuse = TRUE;
 					else
-						wfi = fi[irdflds->nfields] = (FIELD_INFO *) malloc(sizeof(FIELD_INFO));
+						wfi = fi[irdflds->nfields] = (FIELD_INFO *) OP_get(OP_FIELD_INFO, sizeof(FIELD_INFO));
 					if (NULL == wfi)
 					{
 						SC_set_parse_status(stmt, STMT_PARSE_FATAL);
@@ -2114,7 +2418,7 @@ MYLOG(MIN_LOG_LEVEL, "blevel=%d btoken=%s in_dot=%d in_field=%d tbname=%s\n", bl
 					if (k > 0 || n > 0)
 					{
 						MYLOG(MIN_LOG_LEVEL, "allocating field info at %d\n", n + i);
-						fi[n + i] = (FIELD_INFO *) malloc(sizeof(FIELD_INFO));
+						fi[n + i] = (FIELD_INFO *) OP_get(OP_FIELD_INFO, sizeof(FIELD_INFO));
 						if (fi[n + i] == NULL)
 						{
 							SC_set_parse_status(stmt, STMT_PARSE_FATAL);
@@ -471,6 +471,23 @@ PGAPI_GetConnectAttr(HDBC ConnectionHandle,
 		case SQL_ATTR_PGOPT_IGNORETIMEOUT:
 			*((SQLINTEGER *) Value) = conn->connInfo.ignore_timeout;
 			break;
+		case SQL_ATTR_PGOPT_CONN_LOCK_WAITS:
+			CONNLOCK_ACQUIRE(conn);
+			*((SQLUINTEGER *) Value) = conn->cs_waits;
+			CONNLOCK_RELEASE(conn);
+			break;
+		case SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC:
+			CONNLOCK_ACQUIRE(conn);
+			*((SQLBIGINT *) Value) = conn->cs_wait_usec;
+			CONNLOCK_RELEASE(conn);
+			len = sizeof(SQLBIGINT);
+			break;
+		case SQL_ATTR_PGOPT_SPILLED_BYTES:
+			CONNLOCK_ACQUIRE(conn);
+			*((SQLBIGINT *) Value) = conn->spilled_bytes;
+			CONNLOCK_RELEASE(conn);
+			len = sizeof(SQLBIGINT);
+			break;
 		default:
 			ret = PGAPI_GetConnectOption(ConnectionHandle, (UWORD) Attribute, Value, &len, BufferLength);
 	}
@@ -559,6 +576,7 @@ ARDSetField(DescriptorClass *desc, SQLSMALLINT RecNumber,
 		DC_set_error(desc, DESC_INVALID_COLUMN_NUMBER_ERROR, "invalid column number");
 		return SQL_ERROR;
 	}
+	ARD_bindings_changed(opts);
 	if (0 == RecNumber) /* bookmark column */
 	{
 		BindInfoClass	*bookmark = ARD_AllocBookmark(opts);
@@ -2307,6 +2325,7 @@ RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 	QResultClass	*res;
 	IRDFields	*irdflds;
 	PG_BM		pg_bm;
+	BOOL		resumed = s->need_data_callback;
 
 	if (s->need_data_callback)
 	{
@@ -2320,6 +2339,74 @@ RETCODE	bulk_ope_callback(RETCODE retcode, void *para)
 	}
 	s->need_data_callback = FALSE;
 	res = SC_get_Curres(s->stmt);
+	if (SQL_DELETE_BY_BOOKMARK == s->operation &&
+	    s->idx < s->opts->size_of_rowset)
+	{
+		/* deletes never need data, so the whole rowset goes at once */
+		SQLSETPOSIROW	count = (SQLSETPOSIROW) (s->opts->size_of_rowset - s->idx), i, processed = 0;
+		SQLULEN		*gidxs = (SQLULEN *) malloc(sizeof(SQLULEN) * count);
+		KeySet		*keysets = (KeySet *) malloc(sizeof(KeySet) * count);
+
+		if (!gidxs || !keysets)
+		{
+			SC_set_error(s->stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for the bookmarks.", func);
+			ret = SQL_ERROR;
+		}
+		else
+		{
+			for (i = 0; i < count; i++)
+			{
+				pg_bm = SC_Resolve_bookmark(s->opts, s->idx + i);
+				QR_get_last_bookmark(res, s->idx + i, &pg_bm.keys);
+				gidxs[i] = pg_bm.index;
+				keysets[i] = pg_bm.keys;
+			}
+			ret = SC_pos_delete_rowset(s->stmt, s->idx, count, gidxs, keysets, &processed);
+			s->idx += processed;
+			s->processed += processed;
+		}
+		if (gidxs)
+			free(gidxs);
+		if (keysets)
+			free(keysets);
+	}
+	else if (SQL_UPDATE_BY_BOOKMARK == s->operation &&
+		 !resumed && s->idx < s->opts->size_of_rowset)
+	{
+		/*
+		 * unless a value is supplied at execution time, the whole rowset
+		 * goes at once
+		 */
+		SQLSETPOSIROW	count = (SQLSETPOSIROW) (s->opts->size_of_rowset - s->idx), i, processed = 0;
+		SQLULEN		*gidxs = (SQLULEN *) malloc(sizeof(SQLULEN) * count);
+
+		if (!gidxs)
+		{
+			SC_set_error(s->stmt, STMT_NO_MEMORY_ERROR, "Couldn't allocate memory for the bookmarks.", func);
+			ret = SQL_ERROR;
+		}
+		else
+		{
+			for (i = 0; i < count; i++)
+			{
+				pg_bm = SC_Resolve_bookmark(s->opts, s->idx + i);
+				gidxs[i] = pg_bm.index;
+			}
+			ret = SC_pos_update_rowset(s->stmt, s->idx, count, gidxs, &processed);
+			s->idx += processed;
+			s->processed += processed;
+			free(gidxs);
+		}
+	}
+	else if (SQL_ADD == s->operation &&
+		 !resumed && s->idx < s->opts->size_of_rowset)
+	{
+		SQLSETPOSIROW	processed = 0;
+
+		ret = SC_pos_add_rowset(s->stmt, s->idx, (SQLSETPOSIROW) (s->opts->size_of_rowset - s->idx), &processed);
+		s->idx += processed;
+		s->processed += processed;
+	}
 	for (; SQL_ERROR != ret && s->idx < s->opts->size_of_rowset; s->idx++)
 	{
 		if (SQL_ADD != s->operation)
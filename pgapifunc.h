@@ -317,7 +317,18 @@ enum {
 	,SQL_ATTR_PGOPT_MSJET = 65549
 	,SQL_ATTR_PGOPT_BATCHSIZE = 65550
 	,SQL_ATTR_PGOPT_IGNORETIMEOUT = 65551
+	,SQL_ATTR_PGOPT_CONN_LOCK_WAITS = 65552	/* read only */
+	,SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC = 65553	/* read only */
+	,SQL_ATTR_PGOPT_SPILLED_BYTES = 65554	/* read only */
 };
+/*
+ *	The counters above are read without the connection lock, which the
+ *	thread whose waits they count may be holding.
+ */
+#define	PGOPT_IS_COUNTER_ATTR(attr) \
+	(SQL_ATTR_PGOPT_CONN_LOCK_WAITS == (attr) || \
+	 SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC == (attr) || \
+	 SQL_ATTR_PGOPT_SPILLED_BYTES == (attr))
 RETCODE SQL_API PGAPI_SetConnectAttr(HDBC ConnectionHandle,
 			SQLINTEGER Attribute, PTR Value,
 			SQLINTEGER StringLength);
@@ -96,6 +96,8 @@ int	initialize_global_cs(void)
 
 static void finalize_global_cs(void)
 {
+	clear_metadata_cache();
+	OP_finalize();
 	DELETE_COMMON_CS;
 	DELETE_CONNS_CS;
 	FinalizeLogging();
@@ -141,6 +143,7 @@ DllMain(HANDLE hInst, ULONG ul_reason_for_call, LPVOID lpReserved)
 			return TRUE;
 
 		case DLL_THREAD_DETACH:
+			OP_release_thread();
 			break;
 
 		default:
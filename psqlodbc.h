@@ -521,6 +521,8 @@ typedef struct BindInfoClass_ BindInfoClass;
 typedef struct ParameterInfoClass_ ParameterInfoClass;
 typedef struct ParameterImplClass_ ParameterImplClass;
 typedef struct ColumnInfoClass_ ColumnInfoClass;
+typedef struct ColumnConverter_ ColumnConverter;
+typedef struct StmtRewrite_ StmtRewrite;
 typedef struct EnvironmentClass_ EnvironmentClass;
 typedef struct TupleField_ TupleField;
 typedef struct KeySet_ KeySet;
@@ -604,6 +606,47 @@ do { \
 #define	NAMEICMP(name1, name2) (stricmp(SAFE_NAME(name1), SAFE_NAME(name2)))
 /*	pgNAME define end */
 
+/*
+ *	The free slots of a handle array (connections of the environment,
+ *	statements and descriptors of a connection) kept as a stack, so that
+ *	a handle is registered and removed without scanning the array.
+ *	The stack is as large as the array, so HS_put() can't fail.
+ */
+typedef struct
+{
+	int	*slots;
+	int	count;
+}	HandleSlots;
+
+BOOL	HS_reserve(HandleSlots *self, int size);
+void	HS_put_range(HandleSlots *self, int from, int to);
+int	HS_get(HandleSlots *self);
+void	HS_put(HandleSlots *self, int slot);
+void	HS_free(HandleSlots *self);
+
+/*
+ *	Recycled objects of the frequently created classes. Each thread keeps
+ *	up to OP_MAX_CACHED freed objects of a kind and hands them out again
+ *	before falling back to malloc(). The memory OP_get() returns is not
+ *	initialized; the constructors of these classes set every member.
+ */
+enum
+{
+	OP_QRESULT = 0
+	,OP_STATEMENT
+	,OP_DESCRIPTOR
+	,OP_TABLE_INFO
+	,OP_FIELD_INFO
+	,OP_KINDS
+};
+#define	OP_MAX_CACHED	16
+
+void	*OP_get(int kind, size_t size);
+void	OP_put(int kind, void *obj);
+void	OP_release_thread(void);
+void	OP_finalize(void);
+UInt4	thread_serial(void);
+
 
 typedef struct GlobalValues_
 {
@@ -763,6 +806,10 @@ typedef struct
 	Int4		keepalive_idle;
 	Int4		keepalive_interval;
 	Int4		batch_size;
+	Int4		metadata_cache_ttl;
+	Int4		lo_chunk_size;
+	char		putdata_streaming;
+	Int4		result_memory_limit;
 	// Failover
 	signed char		enable_failover;
 	char			failover_mode[MEDIUM_REGISTRY_LEN];
@@ -783,6 +830,7 @@ typedef struct
 #define SUPPORT_DESCRIBE_PARAM(conninfo_) (conninfo_->use_server_side_prepare)
 
 int	initialize_global_cs(void);
+void	clear_metadata_cache(void);
 enum { /* CC_conninfo_init option */
 	CLEANUP_FOR_REUSE	= 1L		/* reuse the info */
 	,INIT_GLOBALS		= (1L << 1) /* init globals members */
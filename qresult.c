@@ -24,7 +24,13 @@
 #include "misc.h"
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
 #include <limits.h>
+#include <stddef.h>
+#ifndef	WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif /* WIN32 */
 
 #include "secure_sscanf.h"
 
@@ -41,6 +47,7 @@ QR_set_num_fields(QResultClass *self, int new_num_fields)
 	if (!self)	return;
 	MYLOG(MIN_LOG_LEVEL, "entering\n");
 
+	QR_clear_conversion_plan(self);
 	CI_set_num_fields(QR_get_fields(self), new_num_fields);
 
 	MYLOG(MIN_LOG_LEVEL, "leaving\n");
@@ -158,6 +165,7 @@ QR_set_fields(QResultClass *self, ColumnInfoClass *fields)
 	if (curfields == fields)
 		return;
 
+	QR_clear_conversion_plan(self);
 	/*
 	 * Unlink the old columninfo from this result set, freeing it if this
 	 * was the last reference.
@@ -183,7 +191,7 @@ QR_Constructor(void)
 	QResultClass *rv;
 
 	MYLOG(MIN_LOG_LEVEL, "entering\n");
-	rv = (QResultClass *) malloc(sizeof(QResultClass));
+	rv = (QResultClass *) OP_get(OP_QRESULT, sizeof(QResultClass));
 
 	if (rv != NULL)
 	{
@@ -194,9 +202,15 @@ QR_Constructor(void)
 
 		/* construct the column info */
 		rv->fields = NULL;
+		rv->cvt_plan = NULL;
+		rv->cvt_plan_count = 0;
+		rv->cvt_plan_ard = NULL;
+		rv->cvt_plan_generation = 0;
+		rv->arena = NULL;
+		rv->spill = NULL;
 		if (fields = CI_Constructor(), NULL == fields)
 		{
-			free(rv);
+			OP_put(OP_QRESULT, rv);
 			return NULL;
 		}
 		QR_set_fields(rv, fields);
@@ -249,6 +263,8 @@ QR_Constructor(void)
 		rv->dl_count = 0;
 		rv->deleted = NULL;
 		rv->deleted_keyset = NULL;
+		rv->valid_tree = NULL;
+		rv->vt_count = rv->vt_alloc = 0;
 	}
 
 	MYLOG(MIN_LOG_LEVEL, "leaving %p\n", rv);
@@ -283,6 +299,7 @@ QR_close_result(QResultClass *self, BOOL destroy)
 		}
 
 		QR_free_memory(self);		/* safe to call anyway */
+		QR_clear_conversion_plan(self);
 
 		/*
 		 * Should have been freed in the close() but just in case...
@@ -320,7 +337,7 @@ QR_close_result(QResultClass *self, BOOL destroy)
 		next = QR_nextr(self);
 		QR_detach(self);
 		if (destroy)
-			free(self);
+			OP_put(OP_QRESULT, self);
 
 		/* Repeat for the next result in the chain */
 		self = next;
@@ -482,6 +499,467 @@ MYLOG(DETAIL_LOG_LEVEL, FORMAT_ULEN "th row(%d fields) alloc=" FORMAT_LEN "\n",
 	return self->backend_tuples + num_fields * (self->num_cached_rows - 1);
 }
 
+/*
+ *	Make a private copy of a result whose tuples are all cached, e.g.
+ *	the result of a catalog function. The copy belongs to no connection.
+ */
+QResultClass *
+QR_duplicate(const QResultClass *self)
+{
+	QResultClass	*rv;
+	ColumnInfoClass	*fields = QR_get_fields(self), *nfields;
+	int		num_fields, i;
+	SQLULEN		num_values, k;
+
+	if (rv = QR_Constructor(), NULL == rv)
+		return NULL;
+	num_fields = CI_get_num_fields(fields);
+	QR_set_num_fields(rv, num_fields);
+	nfields = QR_get_fields(rv);
+	if (num_fields > 0 && NULL == nfields->coli_array)
+		goto cleanup;
+	for (i = 0; i < num_fields; i++)
+	{
+		CI_set_field_info(nfields, i, CI_get_fieldname(fields, i),
+			CI_get_oid(fields, i), CI_get_fieldsize(fields, i),
+			CI_get_atttypmod(fields, i), CI_get_relid(fields, i),
+			CI_get_attid(fields, i));
+		nfields->coli_array[i].display_size = CI_get_display_size(fields, i);
+	}
+	rv->num_fields = self->num_fields;
+	num_values = self->num_cached_rows * self->num_fields;
+	if (num_values > 0)
+	{
+		if (rv->backend_tuples = (TupleField *) calloc(num_values, sizeof(TupleField)), NULL == rv->backend_tuples)
+			goto cleanup;
+		rv->count_backend_allocated = rv->num_cached_rows = self->num_cached_rows;
+		for (k = 0; k < num_values; k++)
+		{
+			const TupleField	*from = self->backend_tuples + k;
+			TupleField	*to = rv->backend_tuples + k;
+
+			to->len = from->len;
+			if (NULL != from->value &&
+			    NULL == (to->value = strdup(from->value)))
+				goto cleanup;
+		}
+	}
+	rv->num_total_read = self->num_total_read;
+	rv->rstatus = self->rstatus;
+	rv->pstatus = self->pstatus;
+	rv->dataFilled = self->dataFilled;
+	return rv;
+cleanup:
+	QR_Destructor(rv);
+	return NULL;
+}
+
+/*
+ *	Values of manual result sets (catalog functions) may be kept in an
+ *	arena owned by the result instead of being malloc'ed one by one.
+ *	Equal strings set in a row are likely to be repeated in the following
+ *	rows (catalog, schema and table names etc.), so they are interned.
+ *
+ *	The values of the rows read for an application query are packed into
+ *	an arena as well (see QR_pack_rows()): the values of neighbouring rows
+ *	lie back to back in a few large blocks, without a malloc header and
+ *	its rounding per value.
+ */
+#define	ARENA_BLOCK_MIN		8192
+#define	ARENA_BLOCK_MAX		(1024 * 1024)
+#define	ARENA_INTERN_SLOTS	256	/* must be a power of 2 */
+#define	ARENA_INTERN_MAXLEN	128
+
+typedef struct QRArenaBlock_
+{
+	struct QRArenaBlock_	*next;
+	size_t	size;
+	size_t	used;
+	char	data[1];
+} QRArenaBlock;
+
+struct QRArena_
+{
+	QRArenaBlock	*blocks;	/* the current block comes first */
+	size_t		next_size;
+	BOOL		packed;		/* holds every value of the fetched rows */
+	const char	*interned[ARENA_INTERN_SLOTS];
+};
+
+static void
+free_arena_blocks(QRArena *arena)
+{
+	QRArenaBlock	*block, *next;
+
+	for (block = arena->blocks; block; block = next)
+	{
+		next = block->next;
+		free(block);
+	}
+	arena->blocks = NULL;
+	pg_memset(arena->interned, 0, sizeof(arena->interned));
+}
+
+static void
+free_arena(QRArena *arena)
+{
+	free_arena_blocks(arena);
+	free(arena);
+}
+
+static BOOL
+arena_owns(const QRArena *arena, const void *ptr)
+{
+	const QRArenaBlock	*block;
+
+	for (block = arena->blocks; block; block = block->next)
+	{
+		if ((const char *) ptr >= block->data &&
+		    (const char *) ptr < block->data + block->used)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ *	ClearCachedRows() for the tuples which may have values in the arena.
+ */
+static void
+clear_arena_rows(const QRArena *arena, TupleField *tuple, int num_fields, SQLLEN num_rows)
+{
+	SQLLEN	i, num_values = num_rows * num_fields;
+
+	for (i = 0; i < num_values; i++, tuple++)
+	{
+		if (NULL != tuple->value)
+		{
+			if (!arena->packed && !arena_owns(arena, tuple->value))
+				free(tuple->value);
+			tuple->value = NULL;
+		}
+		tuple->len = -1;
+	}
+}
+
+/*
+ *	Past the ResultMemoryLimit option, the values read into the cache of a
+ *	result are written to a temporary file, which is mapped copy-on-write
+ *	in their place. The kernel then pages them in and out as they are
+ *	accessed. Only the values move: the TupleField array, a pointer and a
+ *	length per value, stays in memory and isn't counted in the limit.
+ *	The bytes written are added to the spilled_bytes of the connection
+ *	(SQL_ATTR_PGOPT_SPILLED_BYTES).
+ *	Windows has no mmap(), so nothing spills there and the option is
+ *	ignored.
+ *	Spilled values must never be replaced or freed one by one. So only
+ *	the rows of application queries (QR_has_app_rows()) read once spill:
+ *	not those with a keyset (updatable cursors), nor those of a server
+ *	side cursor whose cache is refilled as it scrolls, nor those of the
+ *	queries of the driver whose rows are moved into other results.
+ */
+#ifndef	WIN32
+#define	SPILL_MIN_ROWS	64	/* don't write fewer rows at a time */
+
+typedef struct
+{
+	char	*addr;
+	size_t	size;
+} SpillMap;
+
+struct QRSpill_
+{
+	FILE	*file;		/* NULL until the first rows are written */
+	off_t	file_size;	/* multiple of the page size */
+	size_t	limit;
+	size_t	mem_bytes;	/* bytes of the values still in memory */
+	SQLLEN	spilled_rows;	/* the rows [0, spilled_rows) are in the file */
+	BOOL	broken;		/* an I/O error occurred, keep the rest in memory */
+	int	num_maps;
+	int	alloc_maps;
+	SpillMap	*maps;
+};
+#endif /* WIN32 */
+
+/*
+ *	Called before a result not read through a cursor is filled.
+ */
+static void
+QR_prepare_spill(QResultClass *self)
+{
+#ifndef	WIN32
+	ConnectionClass	*conn = QR_get_conn(self);
+	QRSpill	*spill;
+
+	if (NULL != self->spill || NULL == conn ||
+	    conn->connInfo.result_memory_limit <= 0 || !QR_has_app_rows(self))
+		return;
+	if (spill = (QRSpill *) calloc(1, sizeof(QRSpill)), NULL == spill)
+		return;
+	spill->limit = (size_t) conn->connInfo.result_memory_limit * 1024 * 1024;
+	self->spill = spill;
+#endif /* WIN32 */
+}
+
+/*
+ *	Write the values of the rows read since the last call to the file and
+ *	map them back. A failure leaves the values in memory.
+ */
+static void
+spill_rows(QResultClass *self)
+{
+#ifndef	WIN32
+	QRSpill	*spill = self->spill;
+	int	num_fields = self->num_fields;
+	TupleField	*tuple = self->backend_tuples + spill->spilled_rows * num_fields;
+	TupleField	*end = self->backend_tuples + self->num_cached_rows * num_fields;
+	TupleField	*tp;
+	long	page_size = sysconf(_SC_PAGESIZE);
+	BOOL	packed = (NULL != self->arena && self->arena->packed);
+	ConnectionClass	*conn;
+	size_t	size = 0;
+	char	*addr;
+
+	if (NULL == spill->file &&
+	    NULL == (spill->file = tmpfile()))
+		goto error;
+	if (spill->num_maps >= spill->alloc_maps)
+	{
+		int	alloc = spill->alloc_maps > 0 ? spill->alloc_maps * 2 : 16;
+		SpillMap	*maps;
+
+		if (maps = (SpillMap *) realloc(spill->maps, sizeof(SpillMap) * alloc), NULL == maps)
+			goto error;
+		spill->maps = maps;
+		spill->alloc_maps = alloc;
+	}
+	if (0 != fseeko(spill->file, spill->file_size, SEEK_SET))
+		goto error;
+	for (tp = tuple; tp < end; tp++)
+	{
+		if (NULL == tp->value)
+			continue;
+		if (fwrite(tp->value, tp->len + 1, 1, spill->file) != 1)
+			goto error;
+		size += tp->len + 1;
+	}
+	if (0 == size)
+		goto done;
+	if (0 != fflush(spill->file))
+		goto error;
+	addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(spill->file), spill->file_size);
+	if (MAP_FAILED == addr)
+		goto error;
+	spill->maps[spill->num_maps].addr = addr;
+	spill->maps[spill->num_maps].size = size;
+	spill->num_maps++;
+	spill->file_size += (size + page_size - 1) / page_size * page_size;
+
+	for (tp = tuple; tp < end; tp++)
+	{
+		if (NULL == tp->value)
+			continue;
+		if (!packed)
+			free(tp->value);
+		tp->value = addr;
+		addr += tp->len + 1;
+	}
+	/* the arena held only the values just written */
+	if (packed)
+		free_arena_blocks(self->arena);
+	if (NULL != (conn = QR_get_conn(self)))
+	{
+		CONNLOCK_ACQUIRE(conn);
+		conn->spilled_bytes += size;
+		CONNLOCK_RELEASE(conn);
+	}
+done:
+	MYLOG(DETAIL_LOG_LEVEL, "spilled rows [" FORMAT_LEN "," FORMAT_ULEN ") " FORMAT_SIZE_T " bytes\n", spill->spilled_rows, self->num_cached_rows, size);
+	spill->spilled_rows = self->num_cached_rows;
+	spill->mem_bytes = 0;
+	return;
+error:
+	MYLOG(MIN_LOG_LEVEL, "couldn't spill the result values, errno=%d\n", errno);
+	spill->broken = TRUE;
+#endif /* WIN32 */
+}
+
+/*
+ *	Account for a row read into the cache and spill the rows in memory if
+ *	they exceed the limit.
+ */
+static void
+QR_spill_check(QResultClass *self, size_t row_bytes)
+{
+#ifndef	WIN32
+	QRSpill	*spill = self->spill;
+
+	if (spill->broken)
+		return;
+	spill->mem_bytes += row_bytes;
+	if (spill->mem_bytes > spill->limit &&
+	    self->num_cached_rows - spill->spilled_rows >= SPILL_MIN_ROWS)
+		spill_rows(self);
+#endif /* WIN32 */
+}
+
+/*
+ *	Detach the spilled values from the tuples before ClearCachedRows().
+ */
+static void
+forget_spilled_rows(QRSpill *spill, TupleField *tuple, int num_fields)
+{
+#ifndef	WIN32
+	SQLLEN	i, num_values = spill->spilled_rows * num_fields;
+
+	for (i = 0; i < num_values; i++, tuple++)
+	{
+		tuple->value = NULL;
+		tuple->len = -1;
+	}
+	spill->spilled_rows = 0;
+#endif /* WIN32 */
+}
+
+static void
+free_spill(QRSpill *spill)
+{
+#ifndef	WIN32
+	int	i;
+
+	for (i = 0; i < spill->num_maps; i++)
+		munmap(spill->maps[i].addr, spill->maps[i].size);
+	if (spill->maps)
+		free(spill->maps);
+	if (spill->file)
+		fclose(spill->file);	/* removes the file */
+	free(spill);
+#endif /* WIN32 */
+}
+
+/*
+ *	Keep the values of the rows to be read in an arena. The values must
+ *	never be freed one by one, so this is only for the rows of application
+ *	queries read once.
+ */
+static void
+QR_pack_rows(QResultClass *self)
+{
+	QRArena		*arena;
+
+	if (NULL != self->arena)
+		return;
+	if (arena = (QRArena *) calloc(1, sizeof(QRArena)), NULL == arena)
+		return;
+	arena->next_size = ARENA_BLOCK_MIN;
+	arena->packed = TRUE;
+	self->arena = arena;
+}
+
+static char *
+arena_alloc(QResultClass *self, size_t size)
+{
+	QRArena		*arena = self->arena;
+	QRArenaBlock	*block;
+	size_t		bsize;
+
+	if (NULL == arena)
+	{
+		if (arena = (QRArena *) calloc(1, sizeof(QRArena)), NULL == arena)
+			return NULL;
+		arena->next_size = ARENA_BLOCK_MIN;
+		self->arena = arena;
+	}
+	if (block = arena->blocks, NULL != block &&
+	    block->size - block->used >= size)
+	{
+		char	*ptr = block->data + block->used;
+
+		block->used += size;
+		return ptr;
+	}
+	bsize = arena->next_size;
+	if (bsize < size)
+		bsize = size;
+	if (block = (QRArenaBlock *) CC_malloc(QR_get_conn(self), offsetof(QRArenaBlock, data) + bsize), NULL == block)
+		return NULL;
+	block->size = bsize;
+	block->used = size;
+	block->next = arena->blocks;
+	arena->blocks = block;
+	if (arena->next_size < ARENA_BLOCK_MAX)
+		arena->next_size *= 2;
+	return block->data;
+}
+
+static void
+arena_set_value(QResultClass *self, TupleField *tuple_field, const char *str, size_t len, BOOL intern)
+{
+	const char	**slot = NULL;
+	char		*value;
+
+	if (intern && len < ARENA_INTERN_MAXLEN && NULL != self->arena)
+	{
+		UInt4	hash = 2166136261U;
+		size_t	i;
+
+		for (i = 0; i < len; i++)
+			hash = (hash ^ (UCHAR) str[i]) * 16777619U;
+		slot = self->arena->interned + (hash & (ARENA_INTERN_SLOTS - 1));
+		if (NULL != *slot && strcmp(*slot, str) == 0)
+		{
+			tuple_field->len = (Int4) len;
+			tuple_field->value = (void *) *slot;
+			return;
+		}
+	}
+	if (value = arena_alloc(self, len + 1), NULL == value)
+	{
+		set_tuplefield_null(tuple_field);
+		return;
+	}
+	memcpy(value, str, len + 1);
+	if (NULL != slot)
+		*slot = value;
+	tuple_field->len = (Int4) len;
+	tuple_field->value = value;
+}
+
+/*
+ *	set_tuplefield_string() whose value is kept in the arena of the result.
+ */
+void
+QR_set_tuplefield_string(QResultClass *self, TupleField *tuple_field, const char *string)
+{
+	if (!string)
+	{
+		set_tuplefield_null(tuple_field);
+		return;
+	}
+	arena_set_value(self, tuple_field, string, strlen(string), TRUE);
+}
+
+/*
+ *	set_tuplefield_int4() whose value is kept in the arena of the result.
+ */
+void
+QR_set_tuplefield_int4(QResultClass *self, TupleField *tuple_field, Int4 value)
+{
+	char	buffer[16], *ptr = buffer + sizeof(buffer);
+	UInt4	uval = value < 0 ? -(UInt4) value : (UInt4) value;
+
+	*(--ptr) = '\0';
+	do
+	{
+		*(--ptr) = '0' + uval % 10;
+		uval /= 10;
+	} while (uval > 0);
+	if (value < 0)
+		*(--ptr) = '-';
+	arena_set_value(self, tuple_field, ptr, buffer + sizeof(buffer) - 1 - ptr, FALSE);
+	if (NULL != tuple_field->value)
+		tuple_field->len++;	/* as set_tuplefield_int4() does */
+}
+
 void
 QR_free_memory(QResultClass *self)
 {
@@ -492,7 +970,12 @@ QR_free_memory(QResultClass *self)
 
 	if (self->backend_tuples)
 	{
-		ClearCachedRows(self->backend_tuples, num_fields, num_backend_rows);
+		if (self->spill)
+			forget_spilled_rows(self->spill, self->backend_tuples, num_fields);
+		if (self->arena)
+			clear_arena_rows(self->arena, self->backend_tuples, num_fields, num_backend_rows);
+		else
+			ClearCachedRows(self->backend_tuples, num_fields, num_backend_rows);
 		free(self->backend_tuples);
 		self->count_backend_allocated = 0;
 		self->backend_tuples = NULL;
@@ -506,6 +989,12 @@ QR_free_memory(QResultClass *self)
 		free(self->keyset);
 		self->keyset = NULL;
 		self->count_keyset_allocated = 0;
+		if (self->valid_tree)
+		{
+			free(self->valid_tree);
+			self->valid_tree = NULL;
+		}
+		self->vt_count = self->vt_alloc = 0;
 		if (self->reload_count > 0 && conn && conn->pqconn)
 		{
 			char	plannm[32];
@@ -579,6 +1068,16 @@ QR_free_memory(QResultClass *self)
 	}
 	self->up_alloc = 0;
 	self->up_count = 0;
+	if (self->arena)
+	{
+		free_arena(self->arena);
+		self->arena = NULL;
+	}
+	if (self->spill)
+	{
+		free_spill(self->spill);
+		self->spill = NULL;
+	}
 
 	self->num_total_read = 0;
 	self->num_cached_rows = 0;
@@ -680,6 +1179,11 @@ MYLOG(DETAIL_LOG_LEVEL, "[%d].PGType %u->%u\n", i, PIC_get_pgtype(ipdopts->param
 
 	/* Then, get the data itself */
 	num_cached_rows = self->num_cached_rows;
+	if (NULL == cursor && QR_has_app_rows(self))
+	{
+		QR_pack_rows(self);
+		QR_prepare_spill(self);
+	}
 	if (!QR_read_tuples_from_pgres(self, pgres))
 		return FALSE;
 
@@ -1275,32 +1779,28 @@ MYLOG(DETAIL_LOG_LEVEL, "will add " FORMAT_LEN " added_tuples from " FORMAT_LEN
 		for (i = lkidx; i < hkidx; i++)
 			self->keyset[i].status |= CURS_NEEDS_REREAD;
 		/* deleted info */
-		for (i = 0; i < self->dl_count && hidx > deleted[i]; i++)
+		for (i = QR_search_index(deleted, self->dl_count, lidx); i < self->dl_count && hidx > deleted[i]; i++)
 		{
-			if (lidx <= deleted[i])
+			lf = GIdx2KResIdx(deleted[i], stmt, self);
+			if (lf >= 0 && lf < self->num_cached_keys)
 			{
-				lf = GIdx2KResIdx(deleted[i], stmt, self);
-				if (lf >= 0 && lf < self->num_cached_keys)
-				{
-					self->keyset[lf].status = self->deleted_keyset[i].status;
-					/* mark the row off */
-					self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
-				}
+				self->keyset[lf].status = self->deleted_keyset[i].status;
+				/* mark the row off */
+				self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
 			}
 		}
-		for (i = self->up_count - 1; i >= 0; i--)
+		/* the latest update of a row comes last among its entries */
+		for (i = QR_search_index(updated, self->up_count, hidx) - 1; i >= 0; i--)
 		{
-			if (hidx > updated[i] &&
-			    lidx <= updated[i])
-			{
-				lf = GIdx2KResIdx(updated[i], stmt, self);
-				/* in case the row is marked off */
-				if (0 == (self->keyset[lf].status & CURS_NEEDS_REREAD))
-					continue;
-				self->keyset[lf] = self->updated_keyset[i];
-				ReplaceCachedRows(self->backend_tuples + lf * num_fields, self->updated_tuples + i * num_fields, num_fields, 1);
-				self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
-			}
+			if (lidx > updated[i])
+				break;
+			lf = GIdx2KResIdx(updated[i], stmt, self);
+			/* in case the row is marked off */
+			if (0 == (self->keyset[lf].status & CURS_NEEDS_REREAD))
+				continue;
+			self->keyset[lf] = self->updated_keyset[i];
+			ReplaceCachedRows(self->backend_tuples + lf * num_fields, self->updated_tuples + i * num_fields, num_fields, 1);
+			self->keyset[lf].status &= (~CURS_NEEDS_REREAD);
 		}
 		/* reset CURS_NEEDS_REREAD bit */
 		for (i = 0; i < num_backend_rows; i++)
@@ -1341,6 +1841,7 @@ QR_read_tuples_from_pgres(QResultClass *self, PGresult **pgres)
 	int			nrows;
 	int			resStatus;
 	int		numTotalRows = 0;
+	BOOL		packed = (NULL != self->arena && self->arena->packed);
 
 	/* set the current row to read the fields into */
 	effective_cols = QR_NumPublicResultCols(self);
@@ -1373,6 +1874,7 @@ nextrow:
 	{
 		TupleField *this_tuplefield;
 		KeySet	*this_keyset = NULL;
+		size_t	row_bytes = 0;
 
 		if (!QR_prepare_for_tupledata(self))
 			return FALSE;
@@ -1405,9 +1907,12 @@ nextrow:
 				value = PQgetvalue(*pgres, rowno, field_lf);
 				if (field_lf >= effective_cols)
 					buffer = tidoidbuf;
-				else
+				else if (buffer = (packed ? arena_alloc(self, len + 1) : (char *) CC_malloc(QR_get_conn(self), len + 1)), NULL == buffer)
 				{
-					QR_MALLOC_return_with_error(buffer, char, len + 1, self, "Out of memory in allocating item buffer.", FALSE);
+					QR_set_rstatus(self, PORES_NO_MEMORY_ERROR);
+					QR_free_memory(self);
+					QR_set_messageref(self, "Out of memory in allocating item buffer.");
+					return FALSE;
 				}
 				memcpy(buffer, value, len);
 				buffer[len] = '\0';
@@ -1437,6 +1942,7 @@ nextrow:
 				{
 					this_tuplefield[field_lf].len = len;
 					this_tuplefield[field_lf].value = buffer;
+					row_bytes += len + 1;
 
 					/*
 					 * This can be used to set the longest length of the column
@@ -1457,6 +1963,8 @@ nextrow:
 		if (self->num_fields > 0)
 		{
 			QR_inc_num_cache(self);
+			if (NULL != self->spill)
+				QR_spill_check(self, row_bytes);
 		}
 		else if (QR_haskeyset(self))
 			self->num_cached_keys++;
@@ -1498,3 +2006,23 @@ QR_search_by_fieldname(const QResultClass *self, const char *name)
 
 	return -1;
 }
+
+/*
+ *	Return the position of the first element which isn't less than
+ *	index in the list sorted in ascending order.
+ */
+SQLLEN
+QR_search_index(const SQLLEN *list, SQLLEN count, SQLLEN index)
+{
+	SQLLEN	low = 0, high = count, mid;
+
+	while (low < high)
+	{
+		mid = low + (high - low) / 2;
+		if (list[mid] < index)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
@@ -50,6 +50,9 @@ enum
 	,FQR_NEEDS_SURVIVAL_CHECK = (1L << 3) /* check if the cursor is open */
 };
 
+typedef struct QRArena_ QRArena;
+typedef struct QRSpill_ QRSpill;
+
 struct QResultClass_
 {
 	ColumnInfoClass *fields;	/* the Column information */
@@ -95,23 +98,32 @@ struct QResultClass_
 	KeySet		*keyset;
 	SQLLEN		key_base;	/* relative position of rowset start in the current keyset cache */
 	UInt2		reload_count;
-	UInt2		rb_alloc;	/* count of allocated rollback info */
-	UInt2		rb_count;	/* count of rollback info */
+	UInt4		rb_alloc;	/* count of allocated rollback info */
+	UInt4		rb_count;	/* count of rollback info */
 	char		dataFilled;	/* Cache is filled with data ? */
 	Rollback	*rollback;
 	UInt4		ad_alloc;	/* count of allocated added info */
 	UInt4		ad_count;	/* count of newly added rows */
 	KeySet		*added_keyset;	/* added keyset info */
 	TupleField	*added_tuples;	/* added data by myself */
-	UInt2		dl_alloc;	/* count of allocated deleted info */
-	UInt2		dl_count;	/* count of deleted info */
-	SQLLEN		*deleted;	/* deleted index info */
+	UInt4		dl_alloc;	/* count of allocated deleted info */
+	UInt4		dl_count;	/* count of deleted info */
+	SQLLEN		*deleted;	/* deleted index info in ascending order */
 	KeySet		*deleted_keyset;	/* deleted keyset info */
-	UInt2		up_alloc;	/* count of allocated updated info */
-	UInt2		up_count;	/* count of updated info */
-	SQLLEN		*updated;	/* updated index info */
+	UInt4		up_alloc;	/* count of allocated updated info */
+	UInt4		up_count;	/* count of updated info */
+	SQLLEN		*updated;	/* updated index info in ascending order */
 	KeySet		*updated_keyset;	/* uddated keyset info */
 	TupleField	*updated_tuples;	/* uddated data by myself */
+	SQLLEN		*valid_tree;	/* Fenwick tree of the keys not deleted */
+	SQLLEN		vt_count;	/* count of keys in valid_tree */
+	SQLLEN		vt_alloc;	/* count of allocated valid_tree nodes */
+	ColumnConverter	*cvt_plan;	/* conversion plan for bound columns */
+	Int2		cvt_plan_count;	/* number of columns in the plan */
+	const ARDFields	*cvt_plan_ard;	/* the ARD the plan was built for */
+	UInt4		cvt_plan_generation;	/* ARD generation of the plan */
+	QRArena		*arena;		/* storage of the manually set values */
+	QRSpill		*spill;		/* values moved out of memory (ResultMemoryLimit) */
 };
 
 enum {
@@ -119,12 +131,14 @@ enum {
 	,FQR_WITHHOLD	= (1L << 1)
 	,FQR_HOLDPERMANENT = (1L << 2) /* the cursor is alive across transactions */
 	,FQR_SYNCHRONIZEKEYS = (1L<<3) /* synchronize the keyset range with that of cthe tuples cache */
+	,FQR_APPROWS = (1L << 4) /* rows of an application query, never moved to or replaced by another result */
 };
 
 #define	QR_haskeyset(self)		(0 != (self->flags & FQR_HASKEYSET))
 #define	QR_is_withhold(self)		(0 != (self->flags & FQR_WITHHOLD))
 #define	QR_is_permanent(self)		(0 != (self->flags & FQR_HOLDPERMANENT))
 #define	QR_synchronize_keys(self)	(0 != (self->flags & FQR_SYNCHRONIZEKEYS))
+#define	QR_has_app_rows(self)		(0 != (self->flags & FQR_APPROWS))
 #define QR_get_fields(self)		(self->fields)
 
 
@@ -163,6 +177,7 @@ enum {
 #define QR_set_aborted(self, aborted_)		( self->aborted = aborted_)
 #define QR_set_haskeyset(self)		(self->flags |= FQR_HASKEYSET)
 #define QR_set_synchronize_keys(self)	(self->flags |= FQR_SYNCHRONIZEKEYS)
+#define QR_set_app_rows(self)		(self->flags |= FQR_APPROWS)
 #define QR_set_no_cursor(self)		((self)->flags &= ~(FQR_WITHHOLD | FQR_HOLDPERMANENT), (self)->pstatus &= ~FQR_NEEDS_SURVIVAL_CHECK)
 #define QR_set_withhold(self)		(self->flags |= FQR_WITHHOLD)
 #define QR_set_permanent(self)		(self->flags |= FQR_HOLDPERMANENT)
@@ -223,6 +238,13 @@ do { \
 QResultClass	*QR_Constructor(void);
 void		QR_Destructor(QResultClass *self);
 TupleField	*QR_AddNew(QResultClass *self);
+QResultClass	*QR_duplicate(const QResultClass *self);
+void		QR_set_tuplefield_string(QResultClass *self, TupleField *tuple_field, const char *string);
+void		QR_set_tuplefield_int4(QResultClass *self, TupleField *tuple_field, Int4 value);
+#define QR_set_tuplefield_int2(self, FLD, VAL)	QR_set_tuplefield_int4(self, FLD, (Int2) (VAL))
+#define QR_set_nullfield_string(self, FLD, VAL)	((VAL) ? QR_set_tuplefield_string(self, FLD, (VAL)) : set_tuplefield_null(FLD))
+#define QR_set_nullfield_int2(self, FLD, VAL)	((VAL) != -1 ? QR_set_tuplefield_int2(self, FLD, (VAL)) : set_tuplefield_null(FLD))
+#define QR_set_nullfield_int4(self, FLD, VAL)	((VAL) != -1 ? QR_set_tuplefield_int4(self, FLD, (VAL)) : set_tuplefield_null(FLD))
 int		QR_next_tuple(QResultClass *self, StatementClass *);
 int			QR_close(QResultClass *self);
 void		QR_on_close_cursor(QResultClass *self);
@@ -238,6 +260,15 @@ void		QR_add_notice(QResultClass *self, const char *msg);
 
 void		QR_set_num_fields(QResultClass *self, int new_num_fields); /* catalog functions' result only */
 void		QR_set_fields(QResultClass *self, ColumnInfoClass *);
+#define	QR_clear_conversion_plan(self) \
+do { \
+	if ((self)->cvt_plan) \
+	{ \
+		free((self)->cvt_plan); \
+		(self)->cvt_plan = NULL; \
+	} \
+	(self)->cvt_plan_count = 0; \
+} while (0)
 
 void		QR_set_num_cached_rows(QResultClass *, SQLLEN);
 void		QR_set_rowstart_in_cache(QResultClass *, SQLLEN);
@@ -246,9 +277,10 @@ void		QR_set_cache_size(QResultClass *self, SQLLEN cache_size);
 void		QR_set_reqsize(QResultClass *self, Int4 reqsize);
 void		QR_set_position(QResultClass *self, SQLLEN pos);
 void		QR_set_cursor(QResultClass *self, const char *name);
-SQLLEN		getNthValid(const QResultClass *self, SQLLEN sta, UWORD orientation, SQLULEN nth, SQLLEN *nearest);
+SQLLEN		getNthValid(QResultClass *self, SQLLEN sta, UWORD orientation, SQLULEN nth, SQLLEN *nearest);
 SQLLEN		QR_move_cursor_to_last(QResultClass *self, StatementClass *stmt);
 BOOL		QR_get_last_bookmark(const QResultClass *self, Int4 index, KeySet *keyset);
+SQLLEN		QR_search_index(const SQLLEN *list, SQLLEN count, SQLLEN index);
 int			QR_search_by_fieldname(const QResultClass *self, const char *name);
 
 #define QR_MALLOC_return_with_error(t, tp, s, a, m, r) \
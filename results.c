@@ -1257,8 +1257,91 @@ PGAPI_Fetch(HSTMT hstmt)
 static RETCODE SQL_API
 SC_pos_reload_needed(StatementClass *stmt, SQLULEN req_size, UDWORD flag);
 
+#define	KEY_IS_DELETED(status) \
+	(0 != ((status) & (CURS_SELF_DELETING | CURS_SELF_DELETED | CURS_OTHER_DELETED)))
+
+/*
+ *	A Fenwick tree of the keys not deleted lets getNthValid() find the
+ *	n-th valid row of a result without a cursor in O(log n). It's built
+ *	lazily on the keyset and kept up to date by vt_sync() wherever a key
+ *	gets or loses the deleted status.
+ */
+static SQLLEN
+vt_prefix(const QResultClass *res, SQLLEN n)
+{
+	SQLLEN	sum = 0;
+
+	/* count of the valid keys among the first n ones */
+	for (; n > 0; n &= (n - 1))
+		sum += res->valid_tree[n];
+	return sum;
+}
+
+static BOOL
+vt_extend(QResultClass *res, SQLLEN num)
+{
+	SQLLEN	i, alloc;
+	SQLLEN	*tree;
+
+	if (num > res->vt_alloc)
+	{
+		for (alloc = (res->vt_alloc > 0 ? res->vt_alloc : 1024); alloc < num; alloc *= 2)
+			;
+		if (tree = (SQLLEN *) realloc(res->valid_tree, sizeof(SQLLEN) * (alloc + 1)), NULL == tree)
+		{
+			free(res->valid_tree);
+			res->valid_tree = NULL;
+			res->vt_count = res->vt_alloc = 0;
+			return FALSE;
+		}
+		res->valid_tree = tree;
+		res->vt_alloc = alloc;
+	}
+	/* the node i covers the keys (i - lowbit(i), i] */
+	for (i = res->vt_count + 1; i <= num; i++)
+		res->valid_tree[i] = (KEY_IS_DELETED(res->keyset[i - 1].status) ? 0 : 1)
+			+ vt_prefix(res, i - 1) - vt_prefix(res, i - (i & (-i)));
+	res->vt_count = num;
+	return TRUE;
+}
+
+static void
+vt_sync(QResultClass *res, SQLLEN kres_ridx)
+{
+	SQLLEN	i, delta;
+
+	if (kres_ridx < 0 || kres_ridx >= res->vt_count)
+		return;
+	delta = (KEY_IS_DELETED(res->keyset[kres_ridx].status) ? 0 : 1)
+		- (vt_prefix(res, kres_ridx + 1) - vt_prefix(res, kres_ridx));
+	if (0 == delta)
+		return;
+	for (i = kres_ridx + 1; i <= res->vt_count; i += (i & (-i)))
+		res->valid_tree[i] += delta;
+}
+
+/* the index of the rank-th (1-based) valid key */
+static SQLLEN
+vt_search(const QResultClass *res, SQLLEN rank)
+{
+	SQLLEN	pos = 0, step;
+
+	for (step = 1; step * 2 <= res->vt_count; step *= 2)
+		;
+	for (; step > 0; step /= 2)
+	{
+		if (pos + step <= res->vt_count &&
+		    res->valid_tree[pos + step] < rank)
+		{
+			pos += step;
+			rank -= res->valid_tree[pos];
+		}
+	}
+	return pos;
+}
+
 SQLLEN
-getNthValid(const QResultClass *res, SQLLEN sta, UWORD orientation,
+getNthValid(QResultClass *res, SQLLEN sta, UWORD orientation,
 			SQLULEN nth, SQLLEN *nearest)
 {
 	SQLLEN	i, num_tuples = QR_get_num_total_tuples(res), nearp;
@@ -1268,7 +1351,7 @@ getNthValid(const QResultClass *res, SQLLEN sta, UWORD orientation,
 	if (!QR_once_reached_eof(res))
 		num_tuples = INT_MAX;
 	/* Note that the parameter nth is 1-based */
-MYLOG(DETAIL_LOG_LEVEL, "get " FORMAT_ULEN "th Valid data from " FORMAT_LEN " to %s [dlt=%d]", nth, sta, orientation == SQL_FETCH_PRIOR ? "backward" : "forward", res->dl_count);
+MYLOG(DETAIL_LOG_LEVEL, "get " FORMAT_ULEN "th Valid data from " FORMAT_LEN " to %s [dlt=%u]", nth, sta, orientation == SQL_FETCH_PRIOR ? "backward" : "forward", res->dl_count);
 	if (0 == res->dl_count)
 	{
 		MYPRINTF(DETAIL_LOG_LEVEL, "\n");
@@ -1349,6 +1432,42 @@ MYLOG(DETAIL_LOG_LEVEL, "get " FORMAT_ULEN "th Valid data from " FORMAT_LEN " to
 				return nth;
 		}
 	}
+	else if (QR_once_reached_eof(res) &&
+			 num_tuples <= (SQLLEN) res->num_cached_keys &&
+			 (res->vt_count == num_tuples ||
+			  (res->vt_count < num_tuples && vt_extend(res, num_tuples))))
+	{
+		SQLLEN	rank;
+
+		if (SQL_FETCH_PRIOR == orientation)
+		{
+			if (sta >= num_tuples)
+				sta = num_tuples - 1;
+			count = (sta < 0 ? 0 : vt_prefix(res, sta + 1));
+			if (count >= nth)
+			{
+				rank = count - nth + 1;
+				*nearest = vt_search(res, rank);
+MYPRINTF(DETAIL_LOG_LEVEL, " nearest=" FORMAT_LEN "\n", *nearest);
+				return nth;
+			}
+			*nearest = -1;
+		}
+		else
+		{
+			if (sta < 0)
+				sta = 0;
+			rank = vt_prefix(res, sta >= num_tuples ? num_tuples : sta);
+			count = vt_prefix(res, num_tuples) - rank;
+			if (count >= nth)
+			{
+				*nearest = vt_search(res, rank + nth);
+MYPRINTF(DETAIL_LOG_LEVEL, " nearest=" FORMAT_LEN "\n", *nearest);
+				return nth;
+			}
+			*nearest = num_tuples;
+		}
+	}
 	else if (SQL_FETCH_PRIOR == orientation)
 	{
 		for (i = sta, keyset = res->keyset + sta;
@@ -1898,6 +2017,8 @@ MYLOG(DETAIL_LOG_LEVEL, "num_tuples=" FORMAT_LEN "\n", num_tuples);
 	truncated = error = FALSE;
 
 	currp = -1;
+	/* convert the column-wise bound columns after the rowset is fetched */
+	SC_begin_columnar_fetch(stmt, rowsetSize);
 	stmt->bind_row = 0;		/* set the binding location */
 	result = SC_fetch(stmt);
 	if (SQL_ERROR == result)
@@ -1978,6 +2099,7 @@ MYLOG(DETAIL_LOG_LEVEL, "just skipping deleted row " FORMAT_LEN "\n", currp);
 		stmt->bind_row = (SQLSETPOSIROW) i; /* set the binding location */
 		result = SC_fetch(stmt);
 	}
+	SC_end_columnar_fetch(stmt, i);
 	if (SQL_ERROR == result)
 		goto cleanup;
 
@@ -2019,6 +2141,7 @@ MYLOG(DETAIL_LOG_LEVEL, "pcrow=" FORMAT_LEN "\n", i);
 
 cleanup:
 #undef	return
+	SC_end_columnar_fetch(stmt, 0);
 	return result;
 }
 
@@ -2449,8 +2572,8 @@ MYLOG(DETAIL_LOG_LEVEL, "!!Commit Added=" FORMAT_ULEN "(%d)\n", QR_get_num_total
 static int
 AddDeleted(QResultClass *res, SQLULEN index, const KeySet *keyset)
 {
-	int	i;
-	Int2	dl_count, new_alloc;
+	SQLLEN	i;
+	UInt4	dl_count, new_alloc;
 	SQLLEN	*deleted;
 	KeySet	*deleted_keyset;
 	UWORD	status;
@@ -2483,11 +2606,9 @@ MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
 			res->dl_alloc = new_alloc;
 		}
 		/* sort deleted indexes in ascending order */
-		for (i = 0, deleted = res->deleted, deleted_keyset = res->deleted_keyset; i < dl_count; i++, deleted++, deleted_keyset++)
-		{
-			if (index < *deleted)
-				break;
-		}
+		i = QR_search_index(res->deleted, dl_count, (SQLLEN) index + 1);
+		deleted = res->deleted + i;
+		deleted_keyset = res->deleted_keyset + i;
 		memmove(deleted + 1, deleted, sizeof(SQLLEN) * (dl_count - i));
 		memmove(deleted_keyset + 1, deleted_keyset, sizeof(KeySet) * (dl_count - i));
 	}
@@ -2515,8 +2636,9 @@ MYLOG(DETAIL_LOG_LEVEL, "entering " FORMAT_ULEN "\n", index);
 static void
 RemoveDeleted(QResultClass *res, SQLLEN index)
 {
-	int	i, mv_count, rm_count = 0;
-	SQLLEN	pidx, midx;
+	int	k;
+	SQLLEN	i, j, mv_count, rm_count = 0;
+	SQLLEN	pidx, midx, idx;
 	SQLLEN	*deleted, num_read = QR_get_num_total_read(res);
 	KeySet	*deleted_keyset;
 
@@ -2534,24 +2656,30 @@ RemoveDeleted(QResultClass *res, SQLLEN index)
 		else
 			midx = index;
 	}
-	for (i = 0; i < res->dl_count; i++)
+	if (!res->deleted)
+		return;
+	for (k = 0; k < 2; k++)
 	{
-		if (pidx == res->deleted[i] ||
-		    midx == res->deleted[i])
+		idx = (0 == k ? midx : pidx);
+		if (1 == k && pidx == midx)
+			break;
+		i = QR_search_index(res->deleted, res->dl_count, idx);
+		for (j = i; j < res->dl_count && idx == res->deleted[j]; j++)
+			;
+		if (j == i)
+			continue;
+		mv_count = res->dl_count - j;
+		if (mv_count > 0)
 		{
-			mv_count = res->dl_count - i - 1;
-			if (mv_count > 0)
-			{
-				deleted = res->deleted + i;
-				deleted_keyset = res->deleted_keyset + i;
-				memmove(deleted, deleted + 1, mv_count * sizeof(SQLLEN));
-				memmove(deleted_keyset, deleted_keyset + 1, mv_count * sizeof(KeySet));
-			}
-			res->dl_count--;
-			rm_count++;
+			deleted = res->deleted + i;
+			deleted_keyset = res->deleted_keyset + i;
+			memmove(deleted, deleted + (j - i), mv_count * sizeof(SQLLEN));
+			memmove(deleted_keyset, deleted_keyset + (j - i), mv_count * sizeof(KeySet));
 		}
+		res->dl_count -= (UInt4) (j - i);
+		rm_count += j - i;
 	}
-	MYLOG(MIN_LOG_LEVEL, "removed count=%d,%d\n", rm_count, res->dl_count);
+	MYLOG(MIN_LOG_LEVEL, "removed count=" FORMAT_LEN ",%u\n", rm_count, res->dl_count);
 }
 
 static void
@@ -2592,9 +2720,9 @@ MYLOG(DETAIL_LOG_LEVEL, "Deleted=" FORMAT_LEN "(%d)\n", *deleted, i);
 }
 
 static BOOL
-enlargeUpdated(QResultClass *res, Int4 number, const StatementClass *stmt)
+enlargeUpdated(QResultClass *res, UInt4 number, const StatementClass *stmt)
 {
-	Int2	alloc;
+	UInt4	alloc;
 
 	alloc = res->up_alloc;
 	if (0 == alloc)
@@ -2624,11 +2752,10 @@ AddUpdated(StatementClass *stmt, SQLLEN index, const KeySet *keyset, const Tuple
 	KeySet	*updated_keyset;
 	TupleField	*updated_tuples = NULL,  *tuple;
 	/* SQLLEN	res_ridx; */
-	UInt2	up_count;
+	UInt4	up_count;
 	BOOL	is_in_trans;
-	SQLLEN	upd_idx, upd_add_idx;
+	SQLLEN	upd_idx, upd_add_idx, ins_idx;
 	Int2	num_fields;
-	int	i;
 	UWORD	status;
 
 MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
@@ -2651,6 +2778,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 	updated = res->updated;
 	is_in_trans = CC_is_in_trans(SC_get_conn(stmt));
 	updated_keyset = res->updated_keyset;
+	/* a new entry goes after the existing ones of the same index */
+	ins_idx = up_count > 0 ? QR_search_index(updated, up_count, index + 1) : 0;
 	status = keyset->status;
 	status &= (~KEYSET_INFO_PUBLIC);
 	status |= SQL_ROW_UPDATED;
@@ -2658,13 +2787,8 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 		status |= CURS_SELF_UPDATING;
 	else
 	{
-		for (i = up_count - 1; i >= 0; i--)
-		{
-			if (updated[i] == index)
-				break;
-		}
-		if (i >= 0)
-			upd_idx = i;
+		if (ins_idx > 0 && updated[ins_idx - 1] == index)
+			upd_idx = ins_idx - 1;
 		else
 		{
 			SQLLEN	num_totals = QR_get_num_total_tuples(res);
@@ -2691,7 +2815,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 		res->updated_keyset[upd_idx].status = status;
 		if (res->updated_tuples)
 		{
-			tuple = res->added_tuples + num_fields * upd_add_idx;
+			tuple = res->updated_tuples + num_fields * upd_idx;
 			ClearCachedRows(tuple, num_fields, 1);
 		}
 	}
@@ -2702,13 +2826,20 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 		updated = res->updated;
 		updated_keyset = res->updated_keyset;
 		updated_tuples = res->updated_tuples;
-		upd_idx = up_count;
-		updated[up_count] = index;
-		updated_keyset[up_count] = *keyset;
-		updated_keyset[up_count].status = status;
+		upd_idx = ins_idx;
+		if (upd_idx < up_count)
+		{
+			memmove(updated + upd_idx + 1, updated + upd_idx, sizeof(SQLLEN) * (up_count - upd_idx));
+			memmove(updated_keyset + upd_idx + 1, updated_keyset + upd_idx, sizeof(KeySet) * (up_count - upd_idx));
+			if (updated_tuples)
+				memmove(updated_tuples + num_fields * (upd_idx + 1), updated_tuples + num_fields * upd_idx, sizeof(TupleField) * num_fields * (up_count - upd_idx));
+		}
+		updated[upd_idx] = index;
+		updated_keyset[upd_idx] = *keyset;
+		updated_keyset[upd_idx].status = status;
 		if (updated_tuples)
 		{
-			tuple = updated_tuples + num_fields * up_count;
+			tuple = updated_tuples + num_fields * upd_idx;
 			pg_memset(tuple, 0, sizeof(TupleField) * num_fields);
 		}
 		res->up_count++;
@@ -2718,7 +2849,7 @@ MYLOG(DETAIL_LOG_LEVEL, "entering index=" FORMAT_LEN "\n", index);
 		ReplaceCachedRows(tuple, tuple_updated, num_fields, 1);
 	if (is_in_trans)
 		SC_get_conn(stmt)->result_uncommitted = 1;
-	MYLOG(MIN_LOG_LEVEL, "up_count=%d\n", res->up_count);
+	MYLOG(MIN_LOG_LEVEL, "up_count=%u\n", res->up_count);
 }
 
 static void
@@ -2734,8 +2865,8 @@ RemoveUpdatedAfterTheKey(QResultClass *res, SQLLEN index, const KeySet *keyset)
 	SQLLEN	*updated, num_read = QR_get_num_total_read(res);
 	KeySet	*updated_keyset;
 	TupleField	*updated_tuples = NULL;
-	SQLLEN	pidx, midx, mv_count;
-	int	i, num_fields = res->num_fields, rm_count = 0;
+	SQLLEN	pidx, midx, idx, mv_count, i;
+	int	k, num_fields = res->num_fields, rm_count = 0;
 
 	MYLOG(MIN_LOG_LEVEL, "entering " FORMAT_LEN ",(%u,%u)\n", index, keyset ? keyset->blocknum : 0, keyset ? keyset->offset : 0);
 	if (index < 0)
@@ -2751,17 +2882,28 @@ RemoveUpdatedAfterTheKey(QResultClass *res, SQLLEN index, const KeySet *keyset)
 		else
 			midx = index;
 	}
-	for (i = 0; i < res->up_count; i++)
+	if (!res->updated)
+		return;
+	/*
+	 * AddUpdated() puts a new entry after the existing ones of the same
+	 * index, so the entries of an index are in the order of the updates.
+	 * It only stores global (non-negative) indexes, so a row never has
+	 * entries under both midx and pidx and walking one run after the
+	 * other keeps the update order of the unsorted list.
+	 */
+	for (k = 0; k < 2; k++)
 	{
-		updated = res->updated + i;
-		if (pidx == *updated ||
-		    midx == *updated)
+		idx = (0 == k ? midx : pidx);
+		if (1 == k && pidx == midx)
+			break;
+		for (i = QR_search_index(res->updated, res->up_count, idx); i < res->up_count && idx == res->updated[i];)
 		{
+			updated = res->updated + i;
 			updated_keyset = res->updated_keyset + i;
 			if (keyset &&
 			    updated_keyset->blocknum == keyset->blocknum &&
 			    updated_keyset->offset == keyset->offset)
-				break;
+				goto done;
 			updated_tuples = NULL;
 			if (res->updated_tuples)
 			{
@@ -2780,7 +2922,8 @@ RemoveUpdatedAfterTheKey(QResultClass *res, SQLLEN index, const KeySet *keyset)
 			rm_count++;
 		}
 	}
-	MYLOG(MIN_LOG_LEVEL, "removed count=%d,%d\n", rm_count, res->up_count);
+done:
+	MYLOG(MIN_LOG_LEVEL, "removed count=%d,%u\n", rm_count, res->up_count);
 }
 
 static void
@@ -3021,6 +3164,8 @@ MYLOG(DETAIL_LOG_LEVEL, " index=" FORMAT_LEN " status=%hx", index, status);
 					res->num_cached_rows--;
 				}
 				res->num_cached_keys--;
+				if (res->vt_count > (SQLLEN) res->num_cached_keys)
+					res->vt_count = res->num_cached_keys;
 				if (!curs)
 					res->ad_count--;
 			}
@@ -3035,7 +3180,10 @@ MYPRINTF(DETAIL_LOG_LEVEL, " (%u, %u)", wkey->blocknum,  wkey->offset);
 MYPRINTF(DETAIL_LOG_LEVEL, "->(%u, %u)", wkey->blocknum, wkey->offset);
 				wkey->status &= ~KEYSET_INFO_PUBLIC;
 				if (SQL_DELETE == rollback[i].option)
+				{
 					wkey->status &= ~CURS_SELF_DELETING;
+					vt_sync(res, kres_ridx);
+				}
 				else if (SQL_UPDATE == rollback[i].option)
 					wkey->status &= ~CURS_SELF_UPDATING;
 				wkey->status |= CURS_NEEDS_REREAD;
@@ -3197,30 +3345,25 @@ cleanup:
 
 BOOL QR_get_last_bookmark(const QResultClass *res, Int4 index, KeySet *keyset)
 {
-	int	i;
+	SQLLEN	i;
 
 	if (res->dl_count > 0 && res->deleted)
 	{
-		for (i = 0; i < res->dl_count; i++)
+		i = QR_search_index(res->deleted, res->dl_count, index);
+		if (i < res->dl_count && res->deleted[i] == index)
 		{
-			if (res->deleted[i] == index)
-			{
-				*keyset = res->deleted_keyset[i];
-				return TRUE;
-			}
-			if (res->deleted[i] > index)
-				break;
+			*keyset = res->deleted_keyset[i];
+			return TRUE;
 		}
 	}
 	if (res->up_count > 0 && res->updated)
 	{
-		for (i = res->up_count - 1; i >= 0; i--)
+		/* the latest update of the row */
+		i = QR_search_index(res->updated, res->up_count, (SQLLEN) index + 1) - 1;
+		if (i >= 0 && res->updated[i] == index)
 		{
-			if (res->updated[i] == index)
-			{
-				*keyset = res->updated_keyset[i];
-				return TRUE;
-			}
+			*keyset = res->updated_keyset[i];
+			return TRUE;
 		}
 	}
 	return FALSE;
@@ -3383,175 +3526,144 @@ SC_pos_reload(StatementClass *stmt, SQLULEN global_ridx, UInt2 *count, Int4 logK
 }
 
 static	const int	pre_fetch_count = 32;
+/*
+ *	The key of a row to be reread by LoadFromKeyset() or deleted by
+ *	SC_pos_delete_rowset().
+ */
+typedef struct
+{
+	UInt4	blocknum;
+	UInt2	offset;
+	OID	oid;
+	SQLLEN	gidx;
+	SQLLEN	kres_ridx;
+} ReloadKey;
+
+static int
+reload_key_cmp(const void *a, const void *b)
+{
+	const ReloadKey	*ka = (const ReloadKey *) a, *kb = (const ReloadKey *) b;
+
+	if (ka->blocknum != kb->blocknum)
+		return ka->blocknum < kb->blocknum ? -1 : 1;
+	if (ka->offset != kb->offset)
+		return ka->offset < kb->offset ? -1 : 1;
+	return 0;
+}
+
+/*
+ *	Reread all the rows marked CURS_NEEDS_REREAD between the rowset start
+ *	and limitrow. The tids of the rows are passed as one tid[] parameter
+ *	to a statement prepared once per result, so this costs one round trip
+ *	however many rows are stale.
+ */
 static SQLLEN LoadFromKeyset(StatementClass *stmt, QResultClass * res, int rows_per_fetch, SQLLEN limitrow)
 {
 	CSTR	func = "LoadFromKeyset";
 	ConnectionClass	*conn = SC_get_conn(stmt);
-	SQLLEN	i;
-	int	j, rowc, rcnt = 0;
-	OID	oid;
-	UInt4	blocknum;
-	SQLLEN	kres_ridx;
-	UInt2	offset;
+	SQLLEN	i, j, kres_ridx, rowset_start = SC_get_rowset_start(stmt);
+	int	rcnt = 0;
 	PQExpBufferData	qval = {0};
-	int	keys_per_fetch = 10;
+	ReloadKey	*keys = NULL, *key, target;
+	QResultClass	*qres = NULL;
+	char	planname[32];
 
 #define	return	DONT_CALL_RETURN_FROM_HERE???
-	for (i = SC_get_rowset_start(stmt), kres_ridx = GIdx2KResIdx(i, stmt, res), rowc = 0;; i++, kres_ridx++)
+	if (limitrow <= rowset_start)
+		goto cleanup;
+	keys = (ReloadKey *) malloc(sizeof(ReloadKey) * (limitrow - rowset_start));
+	if (NULL == keys)
 	{
-		if (i >= limitrow)
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	for (i = rowset_start, kres_ridx = GIdx2KResIdx(i, stmt, res); i < limitrow; i++, kres_ridx++)
+	{
+		if (0 == (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+			continue;
+		key = keys + rcnt;
+		getTid(res, kres_ridx, &key->blocknum, &key->offset);
+		key->oid = getOid(res, kres_ridx);
+		key->gidx = i;
+		key->kres_ridx = kres_ridx;
+		rcnt++;
+	}
+	if (0 == rcnt)
+		goto cleanup;
+
+	SPRINTF_FIXED(planname, "_KEYSET_%p", res);
+	initPQExpBuffer(&qval);
+	if (0 == res->reload_count)
+	{
+		printfPQExpBuffer(&qval, "PREPARE \"%s\"(tid[]) as %s where ctid = ANY($1)", planname, stmt->load_statement);
+		if (PQExpBufferDataBroken(qval))
 		{
-			if (!rowc)
-				break;
-			if (res->reload_count > 0)
-			{
-				for (j = rowc; j < keys_per_fetch; j++)
-				{
-					appendPQExpBufferStr(&qval, j ? ",NULL" : "NULL");
-				}
-			}
-			rowc = -1; /* end of loop */
+			rcnt = -1;
+			SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+			goto cleanup;
 		}
-		if (rowc < 0 || rowc >= keys_per_fetch)
+		qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
+		if (!QR_command_maybe_successful(qres))
 		{
-			QResultClass	*qres;
-
-			appendPQExpBufferStr(&qval, ")");
-			if (PQExpBufferDataBroken(qval))
-			{
-				rcnt = -1;
-				SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-				goto cleanup;
-			}
-			qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
-			if (QR_command_maybe_successful(qres))
-			{
-				SQLLEN		j, k, l;
-				Int2		m;
-				TupleField	*tuple, *tuplew;
-				UInt4		bln;
-				UInt2		off;
-
-				for (j = 0; j < QR_get_num_total_read(qres); j++)
-				{
-					oid = getOid(qres, j);
-					getTid(qres, j, &blocknum, &offset);
-					for (k = SC_get_rowset_start(stmt); k < limitrow; k++)
-					{
-						getTid(res, k, &bln, &off);
-						if (oid == getOid(res, k) &&
-						    bln == blocknum &&
-						    off == offset)
-						{
-							l = GIdx2CacheIdx(k, stmt, res);
-							tuple = res->backend_tuples + res->num_fields * l;
-							tuplew = qres->backend_tuples + qres->num_fields * j;
-							for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
-							{
-								if (tuple->len > 0 && tuple->value)
-									free(tuple->value);
-								tuple->value = tuplew->value;
-								tuple->len = tuplew->len;
-								tuplew->value = NULL;
-								tuplew->len = -1;
-							}
-							res->keyset[k].status &= ~CURS_NEEDS_REREAD;
-							break;
-						}
-					}
-				}
-			}
-			else
-			{
-				SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
-				rcnt = -1;
-				QR_Destructor(qres);
-				break;
-			}
-			QR_Destructor(qres);
-			if (rowc < 0)
-				break;
-			rowc = 0;
+			SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
+			rcnt = -1;
+			SC_set_Result(stmt, qres);
+			qres = NULL;
+			goto cleanup;
 		}
-		if (!rowc)
-		{
-			if (PQExpBufferDataBroken(qval))
-			{
-				initPQExpBuffer(&qval);
+		QR_Destructor(qres);
+		qres = NULL;
+		/* the statement is deallocated with the result */
+		res->reload_count = 1;
+	}
+	printfPQExpBuffer(&qval, "EXECUTE \"%s\"('{", planname);
+	for (j = 0; j < rcnt; j++)
+		appendPQExpBuffer(&qval, j ? ",\"(%u,%u)\"" : "\"(%u,%u)\"", keys[j].blocknum, keys[j].offset);
+	appendPQExpBufferStr(&qval, "}')");
+	if (PQExpBufferDataBroken(qval))
+	{
+		rcnt = -1;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
+		goto cleanup;
+	}
+	qres = CC_send_query(conn, qval.data, NULL, CREATE_KEYSET | READ_ONLY_QUERY, stmt);
+	if (!QR_command_maybe_successful(qres))
+	{
+		SC_set_error(stmt, STMT_EXEC_ERROR, "Data Load Error", func);
+		rcnt = -1;
+		goto cleanup;
+	}
 
-				if (res->reload_count > 0)
-					keys_per_fetch = res->reload_count;
-				else
-				{
-					char	planname[32];
-					int	j;
-					QResultClass	*qres;
+	/* match the returned rows with the keys by their tids */
+	qsort(keys, rcnt, sizeof(ReloadKey), reload_key_cmp);
+	for (j = 0; j < (SQLLEN) QR_get_num_total_read(qres); j++)
+	{
+		TupleField	*tuple, *tuplew;
+		Int2		m;
 
-					if (rows_per_fetch >= pre_fetch_count * 2)
-						keys_per_fetch = pre_fetch_count;
-					else
-						keys_per_fetch = rows_per_fetch;
-					if (!keys_per_fetch)
-						keys_per_fetch = 2;
-					SPRINTF_FIXED(planname, "_KEYSET_%p", res);
-					printfPQExpBuffer(&qval, "PREPARE \"%s\"", planname);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						appendPQExpBufferStr(&qval, j ? ",tid" : "(tid");
-					}
-					appendPQExpBuffer(&qval, ") as %s where ctid in ", stmt->load_statement);
-					for (j = 0; j < keys_per_fetch; j++)
-					{
-						if (j == 0)
-							appendPQExpBufferStr(&qval, "($1");
-						else
-							appendPQExpBuffer(&qval, ",$%d", j + 1);
-					}
-					appendPQExpBufferStr(&qval, ")");
-					if (PQExpBufferDataBroken(qval))
-					{
-						rcnt = -1;
-						SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in LoadFromKeyset()", func);
-						goto cleanup;
-					}
-					qres = CC_send_query(conn, qval.data, NULL, READ_ONLY_QUERY, stmt);
-					if (QR_command_maybe_successful(qres))
-					{
-						res->reload_count = keys_per_fetch;
-					}
-					else
-					{
-						SC_set_error(stmt, STMT_EXEC_ERROR, "Prepare for Data Load Error", func);
-						rcnt = -1;
-						SC_set_Result(stmt, qres);
-						break;
-					}
-					QR_Destructor(qres);
-				}
-			}
-			if (res->reload_count > 0)
-			{
-				printfPQExpBuffer(&qval, "EXECUTE \"_KEYSET_%p\"(", res);
-			}
-			else
-			{
-				printfPQExpBuffer(&qval, "%s where ctid in (", stmt->load_statement);
-			}
-		}
-		if (rcnt >= 0 &&
-		    0 != (res->keyset[kres_ridx].status & CURS_NEEDS_REREAD))
+		getTid(qres, j, &target.blocknum, &target.offset);
+		key = (ReloadKey *) bsearch(&target, keys, rcnt, sizeof(ReloadKey), reload_key_cmp);
+		if (NULL == key || key->oid != getOid(qres, j))
+			continue;
+		tuple = res->backend_tuples + res->num_fields * GIdx2CacheIdx(key->gidx, stmt, res);
+		tuplew = qres->backend_tuples + qres->num_fields * j;
+		for (m = 0; m < res->num_fields; m++, tuple++, tuplew++)
 		{
-			getTid(res, kres_ridx, &blocknum, &offset);
-			if (rowc)
-				appendPQExpBuffer(&qval, ",'(%u,%u)'", blocknum, offset);
-			else
-				appendPQExpBuffer(&qval, "'(%u,%u)'", blocknum, offset);
-			rowc++;
-			rcnt++;
+			if (tuple->len > 0 && tuple->value)
+				free(tuple->value);
+			tuple->value = tuplew->value;
+			tuple->len = tuplew->len;
+			tuplew->value = NULL;
+			tuplew->len = -1;
 		}
+		res->keyset[key->kres_ridx].status &= ~CURS_NEEDS_REREAD;
 	}
 cleanup:
 #undef	return
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
 	if (!PQExpBufferDataBroken(qval))
 		termPQExpBuffer(&qval);
 	return rcnt;
@@ -3779,6 +3891,7 @@ SC_pos_reload_needed(StatementClass *stmt, SQLULEN req_size, UDWORD flag)
 			if (SQL_ROW_DELETED == (res->keyset[kres_ridx].status & KEYSET_INFO_PUBLIC))
 			{
 				res->keyset[kres_ridx].status |= CURS_OTHER_DELETED;
+				vt_sync(res, kres_ridx);
 			}
 			res->keyset[kres_ridx].status &= ~CURS_NEEDS_REREAD;
 		}
@@ -3791,12 +3904,90 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	Add a newly inserted row, in the layout of the load statement, to the
+ *	result. The values are moved out of tuple_new.
+ */
+static RETCODE
+pos_add_tuple(StatementClass *stmt, QResultClass *res, TupleField *tuple_new, int num_fields)
+{
+	int		i;
+	int		effective_fields = res->num_fields;
+	ssize_t		tuple_size;
+	SQLLEN		num_total_rows, num_cached_rows, kres_ridx;
+	BOOL		appendKey = FALSE, appendData = FALSE;
+	TupleField	*tuple_old;
+
+	num_total_rows = QR_get_num_total_tuples(res);
+
+	AddAdded(stmt, res, num_total_rows, tuple_new);
+	num_cached_rows = QR_get_num_cached_tuples(res);
+	kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
+	if (QR_haskeyset(res))
+	{	if (!QR_get_cursor(res))
+		{
+			appendKey = TRUE;
+			if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
+				appendData = TRUE;
+			else
+			{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+			}
+		}
+		else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
+		{
+			appendKey = TRUE;
+			appendData = TRUE;
+		}
+	}
+	if (appendKey)
+	{
+		if (res->num_cached_keys >= res->count_keyset_allocated)
+		{
+			if (!res->count_keyset_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_keyset_allocated * 2;
+			QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
+			res->count_keyset_allocated = tuple_size;
+		}
+		KeySetSet(tuple_new, num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
+		res->num_cached_keys++;
+	}
+	if (appendData)
+	{
+MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
+num_total_rows, num_cached_rows,
+QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
+		if (num_cached_rows >= res->count_backend_allocated)
+		{
+			if (!res->count_backend_allocated)
+				tuple_size = TUPLE_MALLOC_INC;
+			else
+				tuple_size = res->count_backend_allocated * 2;
+			QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
+			res->count_backend_allocated = tuple_size;
+		}
+		tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
+		for (i = 0; i < effective_fields; i++)
+		{
+			tuple_old[i].len = tuple_new[i].len;
+			tuple_new[i].len = -1;
+			tuple_old[i].value = tuple_new[i].value;
+			tuple_new[i].value = NULL;
+		}
+		res->num_cached_rows++;
+	}
+	return SQL_SUCCESS;
+}
+
 static RETCODE	SQL_API
 SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 			   const char *tidval)
 {
 	CSTR	func = "SC_pos_newload";
-	int			i;
 	QResultClass *res, *qres;
 	RETCODE		ret = SQL_ERROR;
 
@@ -3825,78 +4016,7 @@ SC_pos_newload(StatementClass *stmt, const UInt4 *oidint, BOOL tidRef,
 
 		QR_set_position(qres, 0);
 		if (count == 1)
-		{
-			int	effective_fields = res->num_fields;
-			ssize_t	tuple_size;
-			SQLLEN	num_total_rows, num_cached_rows, kres_ridx;
-			BOOL	appendKey = FALSE, appendData = FALSE;
-			TupleField *tuple_old, *tuple_new;
-
-			tuple_new = qres->tupleField;
-			num_total_rows = QR_get_num_total_tuples(res);
-
-			AddAdded(stmt, res, num_total_rows, tuple_new);
-			num_cached_rows = QR_get_num_cached_tuples(res);
-			kres_ridx = GIdx2KResIdx(num_total_rows, stmt, res);
-			if (QR_haskeyset(res))
-			{	if (!QR_get_cursor(res))
-				{
-					appendKey = TRUE;
-					if (num_total_rows == CacheIdx2GIdx(num_cached_rows, stmt, res))
-						appendData = TRUE;
-					else
-					{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " <> backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-					}
-				}
-				else if (kres_ridx >= 0 && kres_ridx < res->cache_size)
-				{
-					appendKey = TRUE;
-					appendData = TRUE;
-				}
-			}
-			if (appendKey)
-			{
-				if (res->num_cached_keys >= res->count_keyset_allocated)
-				{
-					if (!res->count_keyset_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_keyset_allocated * 2;
-					QR_REALLOC_return_with_error(res->keyset, KeySet, sizeof(KeySet) * tuple_size, res, "pos_newload failed", SQL_ERROR);
-					res->count_keyset_allocated = tuple_size;
-				}
-				KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, res->keyset + kres_ridx, TRUE);
-				res->num_cached_keys++;
-			}
-			if (appendData)
-			{
-MYLOG(DETAIL_LOG_LEVEL, "total " FORMAT_LEN " == backend " FORMAT_LEN " - base " FORMAT_LEN " + start " FORMAT_LEN " cursor_type=" FORMAT_UINTEGER "\n",
-num_total_rows, num_cached_rows,
-QR_get_rowstart_in_cache(res), SC_get_rowset_start(stmt), stmt->options.cursor_type);
-				if (num_cached_rows >= res->count_backend_allocated)
-				{
-					if (!res->count_backend_allocated)
-						tuple_size = TUPLE_MALLOC_INC;
-					else
-						tuple_size = res->count_backend_allocated * 2;
-					QR_REALLOC_return_with_error(res->backend_tuples, TupleField, res->num_fields * sizeof(TupleField) * tuple_size, res, "SC_pos_newload failed", SQL_ERROR);
-					res->count_backend_allocated = tuple_size;
-				}
-				tuple_old = res->backend_tuples + res->num_fields * num_cached_rows;
-				for (i = 0; i < effective_fields; i++)
-				{
-					tuple_old[i].len = tuple_new[i].len;
-					tuple_new[i].len = -1;
-					tuple_old[i].value = tuple_new[i].value;
-					tuple_new[i].value = NULL;
-				}
-				res->num_cached_rows++;
-			}
-			ret = SQL_SUCCESS;
-		}
+			ret = pos_add_tuple(stmt, res, qres->tupleField, qres->num_fields);
 		else if (0 == count)
 			ret = SQL_NO_DATA_FOUND;
 		else
@@ -4244,6 +4364,482 @@ cleanup:
 		termPQExpBuffer(&updstr);
 	return ret;
 }
+
+/*
+ *	Stuff for the bookmark rowsets updated or added with one statement.
+ */
+
+/* a statement can't have more parameters than an SQLSMALLINT counts */
+#define	ROWSET_MAX_PARAMS	32767
+
+/*
+ *	The select list of the load statement. RETURNING it gets the changed
+ *	rows in the layout of the result, keys included. A '?' in it would be
+ *	taken for a parameter marker, so such a list isn't used.
+ */
+static BOOL
+load_select_list(const StatementClass *stmt, const char **list, size_t *len)
+{
+	const char	*load_stmt = stmt->load_statement, *p, *from;
+
+	if (NULL == load_stmt || stmt->load_from_pos <= 0)
+		return FALSE;
+	from = load_stmt + stmt->load_from_pos;
+	for (p = load_stmt; isspace((UCHAR) *p); p++)
+		;
+	if (strnicmp(p, "select", 6) != 0 || !isspace((UCHAR) p[6]))
+		return FALSE;
+	for (p += 6; isspace((UCHAR) *p); p++)
+		;
+	if ((strnicmp(p, "distinct", 8) == 0 && !isalnum((UCHAR) p[8])) ||
+	    (strnicmp(p, "all", 3) == 0 && !isalnum((UCHAR) p[3])))
+		return FALSE;
+	if (p >= from || NULL != memchr(p, '?', from - p))
+		return FALSE;
+	*list = p;
+	*len = from - p;
+	return TRUE;
+}
+
+/*
+ *	Append the select list of the load statement as a RETURNING list. A
+ *	bare "*" item is qualified, else it would also expand the columns of
+ *	the other relations in the FROM list of an update.
+ */
+static void
+append_returning_list(PQExpBufferData *buf, const char *list, size_t len, const char *qualifier)
+{
+	const char	*p, *q, *r, *end = list + len, *item = list;
+	int		depth = 0;
+	char		quote = '\0';
+
+	for (p = list; p <= end; p++)
+	{
+		if (p < end && quote)
+		{
+			if (*p == quote)
+				quote = '\0';
+			continue;
+		}
+		if (p < end && ('\'' == *p || '"' == *p))
+			quote = *p;
+		else if (p < end && '(' == *p)
+			depth++;
+		else if (p < end && ')' == *p)
+			depth--;
+		else if (p == end || (',' == *p && 0 == depth))
+		{
+			/* the item is item .. p */
+			for (q = item; q < p && isspace((UCHAR) *q); q++)
+				;
+			for (r = q + 1; q < p && '*' == *q && r < p && isspace((UCHAR) *r); r++)
+				;
+			if (q < p && '*' == *q && r >= p)
+			{
+				appendBinaryPQExpBuffer(buf, item, q - item);
+				appendPQExpBuffer(buf, "%s.", qualifier);
+				item = q;
+			}
+			appendBinaryPQExpBuffer(buf, item, p - item + (p < end ? 1 : 0));
+			item = p + 1;
+		}
+	}
+}
+
+/*
+ *	The columns the rows irow .. irow + count - 1 of the rowset set.
+ *	Returns how many there are, or -1 when the rows can't go in one
+ *	statement: a value is supplied at execution time or the rows don't
+ *	set the same columns.
+ */
+static int
+rowset_bound_columns(StatementClass *stmt, SQLSETPOSIROW irow, SQLSETPOSIROW count, int *cols)
+{
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	BindInfoClass	*bindings = opts->bindings;
+	FIELD_INFO	**fi = irdflds->fi;
+	SQLULEN		offset = opts->row_offset_ptr ? *opts->row_offset_ptr : 0;
+	Int4		bind_size = opts->bind_size;
+	SQLSETPOSIROW	r;
+	SQLLEN		*used;
+	int		i, ncols = 0;
+	BOOL		set = FALSE;
+
+	for (i = 0; i < irdflds->nfields; i++)
+	{
+		if (NULL == bindings[i].used || !fi[i]->updatable)
+			continue;
+		for (r = irow; r < irow + count; r++)
+		{
+			used = LENADDR_SHIFT(bindings[i].used, offset);
+			if (bind_size > 0)
+				used = LENADDR_SHIFT(used, bind_size * r);
+			else
+				used = LENADDR_SHIFT(used, r * sizeof(SQLLEN));
+			if (SQL_DATA_AT_EXEC == *used || *used <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+				return -1;
+			if (r == irow)
+				set = (SQL_IGNORE != *used);
+			else if (set != (SQL_IGNORE != *used))
+				return -1;
+		}
+		if (set)
+			cols[ncols++] = i;
+	}
+	return ncols;
+}
+
+/*
+ *	Bind the columns of the rows irow .. irow + count - 1 to the parameters
+ *	of qstmt, row after row. The buffers are shifted to each row here, so
+ *	qstmt executes a single parameter row.
+ */
+static void
+bind_rowset_params(StatementClass *stmt, StatementClass *qstmt, SQLSETPOSIROW irow, SQLSETPOSIROW count, const int *cols, int ncols)
+{
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	BindInfoClass	*bindings = opts->bindings, *binding;
+	FIELD_INFO	**fi = SC_get_IRDF(stmt)->fi;
+	APDFields	*apdopts = SC_get_APDF(qstmt);
+	IPDFields	*ipdopts = SC_get_IPDF(qstmt);
+	int		unknown_sizes = conn->connInfo.drivers.unknown_sizes;
+	Int4		bind_size = opts->bind_size, ctypelen;
+	SQLSETPOSIROW	r;
+	int		i, j, col;
+	OID		fieldtype;
+	char		*buffer;
+	SQLLEN		*used;
+
+	apdopts->param_bind_type = opts->bind_size;
+	apdopts->param_offset_ptr = opts->row_offset_ptr;
+	extend_iparameter_bindings(ipdopts, (int) count * ncols);
+	for (r = irow, j = 0; r < irow + count; r++)
+	{
+		for (i = 0; i < ncols; i++)
+		{
+			col = cols[i];
+			binding = bindings + col;
+			buffer = binding->buffer;
+			if (bind_size > 0)
+			{
+				if (buffer)
+					buffer += bind_size * r;
+				used = LENADDR_SHIFT(binding->used, bind_size * r);
+			}
+			else
+			{
+				if (!buffer)
+					;
+				else if (ctypelen = ctype_length(binding->returntype), ctypelen > 0)
+					buffer += ctypelen * r;
+				else
+					buffer += binding->buflen * r;
+				used = LENADDR_SHIFT(binding->used, r * sizeof(SQLLEN));
+			}
+			/* fieldtype = QR_get_field_type(res, col); */
+			fieldtype = getEffectiveOid(conn, fi[col]);
+			PIC_set_pgtype(ipdopts->parameters[j], fieldtype);
+			PGAPI_BindParameter(qstmt,
+				(SQLUSMALLINT) ++j,
+				SQL_PARAM_INPUT,
+				binding->returntype,
+				pgtype_to_concise_type(stmt, fieldtype, col, unknown_sizes),
+				fi[col]->column_size > 0 ? fi[col]->column_size : pgtype_column_size(stmt, fieldtype, col, unknown_sizes),
+				(SQLSMALLINT) fi[col]->decimal_digits,
+				buffer,
+				binding->buflen,
+				used);
+		}
+	}
+	qstmt->exec_start_row = qstmt->exec_end_row = 0;
+}
+
+/*
+ *	The key of a row to be updated by SC_pos_update_rowset().
+ *	The ReloadKey must come first so that reload_key_cmp() can order it.
+ */
+typedef struct
+{
+	ReloadKey	key;
+	SQLSETPOSIROW	irow;
+	KeySet		old_keyset;
+	BOOL		updated;
+} UpdateKey;
+
+/*
+ *	Send the update of count rows of SC_pos_update_rowset().
+ */
+static RETCODE
+pos_update_rows(StatementClass *stmt, UpdateKey *keys, SQLSETPOSIROW count,
+		  const int *cols, int ncols, const char *list, size_t list_len)
+{
+	CSTR	func = "SC_pos_update_rowset";
+	QResultClass	*res = SC_get_Curres(stmt), *qres;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	FIELD_INFO	**fi = irdflds->fi;
+	TABLE_INFO	*ti = stmt->ti[0];
+	const char	*bestqual = GET_NAME(ti->bestqual);
+	PQExpBufferData		updstr = {0};
+	HSTMT		hstmt = NULL;
+	StatementClass	*qstmt;
+	RETCODE		ret;
+	SQLSETPOSIROW	i;
+	SQLLEN		j, kres_ridx, res_ridx;
+	int		k, num_fields;
+	UpdateKey	*ukey;
+	ReloadKey	target;
+	KeySet		keyset;
+	TupleField	*tuple_new;
+	char		table_fqn[256], qualifier[256];
+
+	initPQExpBuffer(&updstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	printfPQExpBuffer(&updstr, "update %s", ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)));
+	if (NAME_IS_VALID(ti->table_alias))
+	{
+		SPRINTF_FIXED(qualifier, "\"%s\"", GET_NAME(ti->table_alias));
+		appendPQExpBuffer(&updstr, " as %s", qualifier);
+	}
+	for (k = 0; k < ncols; k++)
+		appendPQExpBuffer(&updstr, "%s \"%s\" = \"_odbc_v\".\"_odbc_%d\"", k ? "," : " set", GET_NAME(fi[cols[k]]->column_name), k);
+	/* the empty first branch gives the new values the column types */
+	appendPQExpBufferStr(&updstr, " from (select ctid");
+	for (k = 0; k < ncols; k++)
+		appendPQExpBuffer(&updstr, ", \"%s\"", GET_NAME(fi[cols[k]]->column_name));
+	appendPQExpBuffer(&updstr, " from %s where false", table_fqn);
+	for (i = 0; i < count; i++)
+	{
+		appendPQExpBuffer(&updstr, " union all select '(%u,%u)'", keys[i].key.blocknum, keys[i].key.offset);
+		for (k = 0; k < ncols; k++)
+			appendPQExpBufferStr(&updstr, ", ?");
+	}
+	appendPQExpBufferStr(&updstr, ") as \"_odbc_v\"(\"_odbc_tid\"");
+	for (k = 0; k < ncols; k++)
+		appendPQExpBuffer(&updstr, ", \"_odbc_%d\"", k);
+	/* the list of the tids lets the server find the rows by a tid scan */
+	appendPQExpBufferStr(&updstr, ") where ctid = \"_odbc_v\".\"_odbc_tid\" and ctid = ANY('{");
+	for (i = 0; i < count; i++)
+		appendPQExpBuffer(&updstr, i ? ",\"(%u,%u)\"" : "\"(%u,%u)\"", keys[i].key.blocknum, keys[i].key.offset);
+	appendPQExpBufferStr(&updstr, "}'::tid[])");
+	if (bestqual)
+	{
+		/* each tid must still go with its own key value */
+		appendPQExpBufferStr(&updstr, " and (");
+		for (i = 0; i < count; i++)
+		{
+			appendPQExpBuffer(&updstr, "%s(ctid = '(%u,%u)' and ", i ? " or " : "", keys[i].key.blocknum, keys[i].key.offset);
+			appendPQExpBuffer(&updstr, bestqual, keys[i].key.oid);
+			appendPQExpBufferStr(&updstr, ")");
+		}
+		appendPQExpBufferStr(&updstr, ")");
+	}
+	appendPQExpBufferStr(&updstr, " returning ");
+	append_returning_list(&updstr, list, list_len, NAME_IS_VALID(ti->table_alias) ? qualifier : table_fqn);
+	appendPQExpBufferStr(&updstr, ", \"_odbc_v\".\"_odbc_tid\"");
+	if (PQExpBufferDataBroken(updstr))
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_update_rowset()", func);
+		goto cleanup;
+	}
+	MYLOG(MIN_LOG_LEVEL, "updstr=%s\n", updstr.data);
+	if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+		goto cleanup;
+	}
+	qstmt = (StatementClass *) hstmt;
+	SC_set_delegate(stmt, qstmt);
+	bind_rowset_params(stmt, qstmt, keys[0].irow, count, cols, ncols);
+	ret = PGAPI_ExecDirect(hstmt, (SQLCHAR *) updstr.data, SQL_NTS, 0);
+	qres = SC_get_Curres(qstmt);
+	if (!SQL_SUCCEEDED(ret) || !QR_command_maybe_successful(qres))
+	{
+		SC_error_copy(stmt, qstmt, TRUE);
+		if (SC_get_errornumber(stmt) == 0)
+			SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos update return error", func);
+		for (i = 0; i < count; i++)
+		{
+			if (irdflds->rowStatusArray)
+				irdflds->rowStatusArray[keys[i].irow] = SQL_ROW_ERROR;
+		}
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	ret = SQL_SUCCESS;
+
+	/*
+	 * match the returned rows with the keys by their old tids and do what
+	 * irow_update() and SC_pos_reload_with_key() do for a single row
+	 */
+	qsort(keys, count, sizeof(UpdateKey), reload_key_cmp);
+	num_fields = qres->num_fields - 1;
+	for (j = 0; j < (SQLLEN) QR_get_num_cached_tuples(qres); j++)
+	{
+		const char	*tidval = QR_get_value_backend_text(qres, j, num_fields);
+		int		status = 0;
+
+		if (NULL == tidval ||
+		    secure_sscanf(tidval, &status, "(%u,%hu)",
+				ARG_UINT(&target.blocknum), ARG_USHORT(&target.offset)) != 2)
+			continue;
+		ukey = (UpdateKey *) bsearch(&target, keys, count, sizeof(UpdateKey), reload_key_cmp);
+		if (NULL == ukey || ukey->updated)
+			continue;
+		ukey->updated = TRUE;
+		tuple_new = qres->backend_tuples + qres->num_fields * j;
+		kres_ridx = ukey->key.kres_ridx;
+		res_ridx = GIdx2CacheIdx(ukey->key.gidx, stmt, res);
+		KeySetSet(tuple_new, num_fields, res->num_key_fields, &keyset, TRUE);
+		AddUpdated(stmt, ukey->key.gidx, &keyset, tuple_new);
+		if (SQL_CURSOR_KEYSET_DRIVEN == stmt->options.cursor_type)
+			res->keyset[kres_ridx].status |= SQL_ROW_UPDATED;
+		KeySetSet(tuple_new, num_fields, res->num_key_fields, res->keyset + kres_ridx, FALSE);
+		MoveCachedRows(res->backend_tuples + res->num_fields * res_ridx, tuple_new, getNumResultCols(res), 1);
+		AddRollback(stmt, res, ukey->key.gidx, &ukey->old_keyset, SQL_UPDATE);
+	}
+	for (i = 0; i < count; i++)
+	{
+		ukey = keys + i;
+		if (ukey->updated)
+		{
+			if (CC_is_in_trans(conn))
+				res->keyset[ukey->key.kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATING);
+			else
+				res->keyset[ukey->key.kres_ridx].status |= (SQL_ROW_UPDATED  | CURS_SELF_UPDATED);
+			if (irdflds->rowStatusArray)
+				irdflds->rowStatusArray[ukey->irow] = SQL_ROW_UPDATED;
+		}
+		else
+		{
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before updates", func);
+			ret = SQL_SUCCESS_WITH_INFO;
+			if (stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+				SC_pos_reload(stmt, ukey->key.gidx, (UInt2 *) 0, 0);
+			if (irdflds->rowStatusArray)
+				irdflds->rowStatusArray[ukey->irow] = SQL_ROW_SUCCESS_WITH_INFO;
+		}
+	}
+
+cleanup:
+#undef	return
+	if (hstmt)
+		PGAPI_FreeStmt(hstmt, SQL_DROP);
+	if (!PQExpBufferDataBroken(updstr))
+		termPQExpBuffer(&updstr);
+	return ret;
+}
+
+/*
+ *	Update the rows of a bookmark rowset with one statement
+ *
+ *	"update .. from (<the new values of all the rows>) .. returning" sets
+ *	all the rows in one round trip. It returns the select list of the
+ *	load statement, so the new rows replace the cached ones the way
+ *	SC_pos_update() does after reloading a single row.
+ *	The rows are irow .. irow + count - 1 of the rowset and *processed
+ *	is the number of them handled. Nothing is done and *processed stays
+ *	0 when the rows can't go in one statement: a value is supplied at
+ *	execution time, the rows set different columns, a row isn't cached
+ *	or the table has subclasses. The caller then updates them one by one.
+ */
+RETCODE
+SC_pos_update_rowset(StatementClass *stmt, SQLSETPOSIROW irow, SQLSETPOSIROW count,
+		  const SQLULEN *global_ridx, SQLSETPOSIROW *processed)
+{
+	CSTR	func = "SC_pos_update_rowset";
+	QResultClass	*res;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	RETCODE		ret = SQL_SUCCESS, tret;
+	SQLSETPOSIROW	i, n, rows_per_stmt;
+	SQLLEN		kres_ridx, res_ridx;
+	TABLE_INFO	*ti;
+	const char	*bestitem, *list;
+	size_t		list_len;
+	UpdateKey	*keys = NULL, *ukey;
+	int		*cols = NULL, ncols;
+	BOOL		batch;
+
+	MYLOG(MIN_LOG_LEVEL, "entering irow=" FORMAT_POSIROW " count=" FORMAT_POSIROW "\n", irow, count);
+	*processed = 0;
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_update_rowset.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	bestitem = GET_NAME(ti->bestitem);
+	if (count < 2 || TI_has_subclass(ti) || PG_VERSION_LT(conn, 8.2) ||
+	    !load_select_list(stmt, &list, &list_len))
+		return SQL_SUCCESS;
+	cols = (int *) malloc(sizeof(int) * SC_get_IRDF(stmt)->nfields);
+	keys = (UpdateKey *) malloc(sizeof(UpdateKey) * count);
+	if (!cols || !keys)
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_update_rowset()", func);
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	ncols = rowset_bound_columns(stmt, irow, count, cols);
+	batch = (ncols > 0);
+	for (i = 0; batch && i < count; i++)
+	{
+		ukey = keys + i;
+		kres_ridx = GIdx2KResIdx(global_ridx[i], stmt, res);
+		res_ridx = GIdx2CacheIdx(global_ridx[i], stmt, res);
+		if (kres_ridx < 0 || kres_ridx >= res->num_cached_keys ||
+		    res_ridx < 0 || res_ridx >= QR_get_num_cached_tuples(res))
+		{
+			batch = FALSE;
+			break;
+		}
+		ukey->irow = irow + i;
+		ukey->updated = FALSE;
+		ukey->key.gidx = global_ridx[i];
+		ukey->key.kres_ridx = kres_ridx;
+		ukey->key.oid = getOid(res, kres_ridx);
+		getTid(res, kres_ridx, &ukey->key.blocknum, &ukey->key.offset);
+		ukey->old_keyset = res->keyset[kres_ridx];
+		if (0 == ukey->key.oid && bestitem && !strcmp(bestitem, OID_NAME))
+			batch = FALSE;
+	}
+	if (!batch)
+		goto cleanup;
+	rows_per_stmt = ROWSET_MAX_PARAMS / ncols;
+	if (0 == rows_per_stmt)
+		rows_per_stmt = 1;
+	for (i = 0; SQL_ERROR != ret && i < count; i += n)
+	{
+		n = count - i;
+		if (n > rows_per_stmt)
+			n = rows_per_stmt;
+		tret = pos_update_rows(stmt, keys + i, n, cols, ncols, list, list_len);
+		if (SQL_ERROR != tret)
+			*processed += n;
+		if (SQL_SUCCESS != tret)
+			ret = tret;
+	}
+
+cleanup:
+	if (cols)
+		free(cols);
+	if (keys)
+		free(keys);
+	return ret;
+}
+
 RETCODE
 SC_pos_delete(StatementClass *stmt,
 		  SQLSETPOSIROW irow, SQLULEN global_ridx, const KeySet *keyset)
@@ -4389,6 +4985,7 @@ SC_pos_delete(StatementClass *stmt,
 		}
 		else
 			res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETED);
+		vt_sync(res, kres_ridx);
 MYLOG(DETAIL_LOG_LEVEL, ".status[" FORMAT_ULEN "]=%x\n", global_ridx, res->keyset[kres_ridx].status);
 	}
 	if (irdflds->rowStatusArray)
@@ -4417,6 +5014,224 @@ cleanup:
 	return ret;
 }
 
+/*
+ *	The key of a row to be deleted by SC_pos_delete_rowset().
+ *	The ReloadKey must come first so that reload_key_cmp() can order it.
+ */
+typedef struct
+{
+	ReloadKey	key;
+	SQLSETPOSIROW	irow;
+	const KeySet	*keyset;
+	BOOL		idx_exist;
+	BOOL		deleted;
+} DeleteKey;
+
+/*
+ *	Delete the rows of a bookmark rowset with one statement
+ *
+ *	"delete .. where ctid = ANY(..) returning ctid" removes all the rows
+ *	in one round trip and the returned tids tell which of them were
+ *	actually deleted. The bookkeeping per row is the same as the one of
+ *	SC_pos_delete(). Falls back to calling SC_pos_delete() row by row
+ *	when the table has subclasses, the server can't return the tids or
+ *	a row can't be keyed by its tid.
+ *	The rows are irow .. irow + count - 1 of the rowset and *processed
+ *	is the number of them successfully handled.
+ */
+RETCODE
+SC_pos_delete_rowset(StatementClass *stmt, SQLSETPOSIROW irow, SQLSETPOSIROW count,
+		  const SQLULEN *global_ridx, const KeySet *keysets,
+		  SQLSETPOSIROW *processed)
+{
+	CSTR	func = "SC_pos_delete_rowset";
+	QResultClass *res, *qres = NULL;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	PQExpBufferData		dltstr = {0};
+	RETCODE		ret = SQL_SUCCESS;
+	SQLSETPOSIROW	i;
+	SQLLEN		j, kres_ridx;
+	UInt4		qflag;
+	TABLE_INFO	*ti;
+	const char	*bestitem, *bestqual;
+	DeleteKey	*keys = NULL, *dkey;
+	ReloadKey	target;
+	char		table_fqn[256];
+	BOOL		batch;
+
+	MYLOG(MIN_LOG_LEVEL, "entering irow=" FORMAT_POSIROW " count=" FORMAT_POSIROW "\n", irow, count);
+	*processed = 0;
+	if (!(res = SC_get_Curres(stmt)))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_delete_rowset.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	bestitem = GET_NAME(ti->bestitem);
+	bestqual = GET_NAME(ti->bestqual);
+	batch = (count > 1 && !TI_has_subclass(ti) && PG_VERSION_GE(conn, 8.2));
+	if (batch && NULL == (keys = (DeleteKey *) malloc(sizeof(DeleteKey) * count)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete_rowset()", func);
+		return SQL_ERROR;
+	}
+	for (i = 0; batch && i < count; i++)
+	{
+		dkey = keys + i;
+		dkey->irow = irow + i;
+		dkey->deleted = FALSE;
+		dkey->key.gidx = global_ridx[i];
+		kres_ridx = GIdx2KResIdx(global_ridx[i], stmt, res);
+		if (kres_ridx < 0 || kres_ridx >= res->num_cached_keys)
+		{
+			if (0 == keysets[i].offset)
+				batch = FALSE;
+			dkey->idx_exist = FALSE;
+			dkey->keyset = keysets + i;
+			dkey->key.kres_ridx = -1;
+			dkey->key.oid = keysets[i].oid;
+			dkey->key.blocknum = keysets[i].blocknum;
+			dkey->key.offset = keysets[i].offset;
+		}
+		else
+		{
+			dkey->idx_exist = TRUE;
+			dkey->keyset = res->keyset + kres_ridx;
+			dkey->key.kres_ridx = kres_ridx;
+			dkey->key.oid = getOid(res, kres_ridx);
+			getTid(res, kres_ridx, &dkey->key.blocknum, &dkey->key.offset);
+			if (0 == dkey->key.oid && bestitem && !strcmp(bestitem, OID_NAME))
+				batch = FALSE;
+		}
+	}
+	if (!batch)
+	{
+		if (keys)
+			free(keys);
+		for (i = 0; SQL_ERROR != ret && i < count; i++)
+		{
+			ret = SC_pos_delete(stmt, irow + i, global_ridx[i], keysets + i);
+			if (SQL_ERROR != ret)
+				(*processed)++;
+		}
+		return ret;
+	}
+
+	initPQExpBuffer(&dltstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	printfPQExpBuffer(&dltstr, "delete from %s where ctid = ANY('{",
+			 ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)));
+	for (i = 0; i < count; i++)
+		appendPQExpBuffer(&dltstr, i ? ",\"(%u,%u)\"" : "\"(%u,%u)\"", keys[i].key.blocknum, keys[i].key.offset);
+	appendPQExpBufferStr(&dltstr, "}'::tid[])");
+	if (bestqual)
+	{
+		/* each tid must still go with its own key value */
+		appendPQExpBufferStr(&dltstr, " and (");
+		for (i = 0; i < count; i++)
+		{
+			appendPQExpBuffer(&dltstr, "%s(ctid = '(%u,%u)' and ", i ? " or " : "", keys[i].key.blocknum, keys[i].key.offset);
+			appendPQExpBuffer(&dltstr, bestqual, keys[i].key.oid);
+			appendPQExpBufferStr(&dltstr, ")");
+		}
+		appendPQExpBufferStr(&dltstr, ")");
+	}
+	appendPQExpBufferStr(&dltstr, " returning ctid");
+	if (PQExpBufferDataBroken(dltstr))
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_delete_rowset()", func);
+		goto cleanup;
+	}
+	MYLOG(MIN_LOG_LEVEL, "dltstr=%s\n", dltstr.data);
+	qflag = 0;
+	if (stmt->external && !CC_is_in_trans(conn) &&
+		(!CC_does_autocommit(conn)))
+		qflag |= GO_INTO_TRANSACTION;
+	qres = CC_send_query(conn, dltstr.data, NULL, qflag, stmt);
+	if (!QR_command_maybe_successful(qres))
+	{
+		if (qres)
+		{
+			STRCPY_FIXED(res->sqlstate, qres->sqlstate);
+			res->message = qres->message;
+			qres->message = NULL;
+		}
+		SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos delete return error", func);
+		for (i = 0; i < count; i++)
+		{
+			if (irdflds->rowStatusArray)
+				irdflds->rowStatusArray[irow + i] = SQL_ROW_ERROR;
+		}
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+
+	/* match the returned tids with the keys */
+	qsort(keys, count, sizeof(DeleteKey), reload_key_cmp);
+	for (j = 0; j < (SQLLEN) QR_get_num_cached_tuples(qres); j++)
+	{
+		const char	*tidval = QR_get_value_backend_text(qres, j, 0);
+		int		status = 0;
+
+		if (NULL == tidval ||
+		    secure_sscanf(tidval, &status, "(%u,%hu)",
+				ARG_UINT(&target.blocknum), ARG_USHORT(&target.offset)) != 2)
+			continue;
+		dkey = (DeleteKey *) bsearch(&target, keys, count, sizeof(DeleteKey), reload_key_cmp);
+		if (NULL != dkey)
+			dkey->deleted = TRUE;
+	}
+	for (i = 0; i < count; i++)
+	{
+		dkey = keys + i;
+		if (dkey->deleted)
+		{
+			AddRollback(stmt, res, dkey->key.gidx, dkey->keyset, SQL_DELETE);
+			AddDeleted(res, dkey->key.gidx, dkey->keyset);
+			if (dkey->idx_exist)
+			{
+				kres_ridx = dkey->key.kres_ridx;
+				res->keyset[kres_ridx].status &= (~KEYSET_INFO_PUBLIC);
+				if (CC_is_in_trans(conn))
+					res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETING);
+				else
+					res->keyset[kres_ridx].status |= (SQL_ROW_DELETED | CURS_SELF_DELETED);
+				vt_sync(res, kres_ridx);
+MYLOG(DETAIL_LOG_LEVEL, ".status[" FORMAT_LEN "]=%x\n", dkey->key.gidx, res->keyset[kres_ridx].status);
+			}
+		}
+		else
+		{
+			SC_set_error(stmt, STMT_ROW_VERSION_CHANGED, "the content was changed before deletes", func);
+			ret = SQL_SUCCESS_WITH_INFO;
+			if (dkey->idx_exist && stmt->options.cursor_type == SQL_CURSOR_KEYSET_DRIVEN)
+				SC_pos_reload(stmt, dkey->key.gidx, (UInt2 *) 0, 0);
+		}
+		if (irdflds->rowStatusArray)
+			irdflds->rowStatusArray[dkey->irow] = SQL_ROW_DELETED;
+	}
+	*processed = count;
+
+cleanup:
+#undef	return
+	QR_Destructor(qres);
+	if (keys)
+		free(keys);
+	if (!PQExpBufferDataBroken(dltstr))
+		termPQExpBuffer(&dltstr);
+	return ret;
+}
+
 static RETCODE SQL_API
 irow_insert(RETCODE ret, StatementClass *stmt, StatementClass *istmt,
 			SQLLEN addpos)
@@ -4533,6 +5348,7 @@ pos_add_callback(RETCODE retcode, void *para)
 		if (kres_ridx >= 0 && kres_ridx < s->res->num_cached_keys)
 		{
 			s->res->keyset[kres_ridx].status = status;
+			vt_sync(s->res, kres_ridx);
 		}
 	}
 	if (s->irdflds->rowStatusArray)
@@ -4729,6 +5545,222 @@ cleanup:
 	return ret;
 }
 
+
+/*
+ *	Send the insert of the rows irow .. irow + count - 1 of
+ *	SC_pos_add_rowset().
+ */
+static RETCODE
+pos_add_rows(StatementClass *stmt, SQLSETPOSIROW irow, SQLSETPOSIROW count,
+		  const int *cols, int ncols, const char *list, size_t list_len)
+{
+	CSTR	func = "SC_pos_add_rowset";
+	QResultClass	*res = SC_get_Curres(stmt), *qres;
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	ARDFields	*opts = SC_get_ARDF(stmt);
+	IRDFields	*irdflds = SC_get_IRDF(stmt);
+	FIELD_INFO	**fi = irdflds->fi;
+	TABLE_INFO	*ti = stmt->ti[0];
+	BindInfoClass	*bookmark = opts->bookmark;
+	PQExpBufferData		addstr = {0};
+	HSTMT		hstmt = NULL;
+	StatementClass	*qstmt;
+	RETCODE		ret;
+	SQLSETPOSIROW	i, brow_save;
+	SQLLEN		addpos, global_ridx, kres_ridx;
+	int		k;
+	UWORD		status;
+	KeySet		keys;
+	TupleField	*tuple_new;
+	char		table_fqn[256], qualifier[256];
+
+	initPQExpBuffer(&addstr);
+#define	return	DONT_CALL_RETURN_FROM_HERE???
+	printfPQExpBuffer(&addstr, "insert into %s", ti_quote(stmt, 0, table_fqn, sizeof(table_fqn)));
+	if (NAME_IS_VALID(ti->table_alias))
+	{
+		SPRINTF_FIXED(qualifier, "\"%s\"", GET_NAME(ti->table_alias));
+		appendPQExpBuffer(&addstr, " as %s", qualifier);
+	}
+	for (k = 0; k < ncols; k++)
+		appendPQExpBuffer(&addstr, "%s\"%s\"", k ? ", " : " (", GET_NAME(fi[cols[k]]->column_name));
+	appendPQExpBufferStr(&addstr, ") values ");
+	for (i = 0; i < count; i++)
+	{
+		for (k = 0; k < ncols; k++)
+			appendPQExpBufferStr(&addstr, k ? ", ?" : (i ? ", (?" : "(?"));
+		appendPQExpBufferStr(&addstr, ")");
+	}
+	appendPQExpBufferStr(&addstr, " returning ");
+	append_returning_list(&addstr, list, list_len, NAME_IS_VALID(ti->table_alias) ? qualifier : table_fqn);
+	if (PQExpBufferDataBroken(addstr))
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_add_rowset()", func);
+		goto cleanup;
+	}
+	MYLOG(MIN_LOG_LEVEL, "addstr=%s\n", addstr.data);
+	if (PGAPI_AllocStmt(conn, &hstmt, 0) != SQL_SUCCESS)
+	{
+		ret = SQL_ERROR;
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "internal AllocStmt error", func);
+		goto cleanup;
+	}
+	qstmt = (StatementClass *) hstmt;
+	SC_set_delegate(stmt, qstmt);
+	bind_rowset_params(stmt, qstmt, irow, count, cols, ncols);
+	ret = PGAPI_ExecDirect(hstmt, (SQLCHAR *) addstr.data, SQL_NTS, 0);
+	qres = SC_get_Curres(qstmt);
+	if (!SQL_SUCCEEDED(ret) || !QR_command_maybe_successful(qres) ||
+	    QR_get_num_cached_tuples(qres) != (SQLLEN) count)
+	{
+		SC_error_copy(stmt, qstmt, TRUE);
+		if (SC_get_errornumber(stmt) == 0)
+			SC_set_error(stmt, STMT_ERROR_TAKEN_FROM_BACKEND, "SetPos insert return error", func);
+		for (i = 0; i < count; i++)
+		{
+			if (irdflds->rowStatusArray)
+				irdflds->rowStatusArray[irow + i] = SQL_ROW_ERROR;
+		}
+		ret = SQL_ERROR;
+		goto cleanup;
+	}
+	ret = SQL_SUCCESS;
+	SC_setInsertedTable(qstmt, ret);
+
+	/*
+	 * RETURNING gives the rows in the order of the values list. Do what
+	 * pos_add_callback() and irow_insert() do for a single row.
+	 */
+	for (i = 0; i < count; i++)
+	{
+		tuple_new = qres->backend_tuples + qres->num_fields * i;
+		KeySetSet(tuple_new, qres->num_fields, res->num_key_fields, &keys, TRUE);
+		if (QR_get_cursor(res))
+			addpos = -(SQLLEN)(res->ad_count + 1);
+		else
+			addpos = QR_get_num_total_tuples(res);
+		if (ret = pos_add_tuple(stmt, res, tuple_new, qres->num_fields), SQL_ERROR == ret)
+		{
+			for (; i < count; i++)
+			{
+				if (irdflds->rowStatusArray)
+					irdflds->rowStatusArray[irow + i] = SQL_ROW_ERROR;
+			}
+			break;
+		}
+		if (bookmark && bookmark->buffer)
+		{
+			brow_save = stmt->bind_row;
+			stmt->bind_row = irow + i;
+			SC_set_current_col(stmt, -1);
+			SC_Create_bookmark(stmt, bookmark, stmt->bind_row, addpos, &keys);
+			stmt->bind_row = brow_save;
+		}
+		if (res->keyset)
+		{
+			global_ridx = QR_get_num_total_tuples(res) - 1;
+			status = SQL_ROW_ADDED;
+			if (CC_is_in_trans(conn))
+				status |= CURS_SELF_ADDING;
+			else
+				status |= CURS_SELF_ADDED;
+			kres_ridx = GIdx2KResIdx(global_ridx, stmt, res);
+			if (kres_ridx >= 0 && kres_ridx < res->num_cached_keys)
+			{
+				res->keyset[kres_ridx].status = status;
+				vt_sync(res, kres_ridx);
+			}
+		}
+		if (irdflds->rowStatusArray)
+			irdflds->rowStatusArray[irow + i] = SQL_ROW_ADDED;
+	}
+
+cleanup:
+#undef	return
+	if (hstmt)
+		PGAPI_FreeStmt(hstmt, SQL_DROP);
+	if (!PQExpBufferDataBroken(addstr))
+		termPQExpBuffer(&addstr);
+	return ret;
+}
+
+/*
+ *	Add the rows of a rowset with one statement
+ *
+ *	A multi-row "insert .. returning" adds all the rows in one round trip.
+ *	It returns the select list of the load statement, so the new rows go
+ *	into the result the way SC_pos_add() puts a reloaded single row.
+ *	The rows are irow .. irow + count - 1 of the rowset and *processed
+ *	is the number of them handled. As with SC_pos_update_rowset(),
+ *	nothing is done when the rows can't go in one statement and the
+ *	caller then adds them one by one.
+ */
+RETCODE
+SC_pos_add_rowset(StatementClass *stmt, SQLSETPOSIROW irow, SQLSETPOSIROW count,
+		  SQLSETPOSIROW *processed)
+{
+	CSTR	func = "SC_pos_add_rowset";
+	ConnectionClass	*conn = SC_get_conn(stmt);
+	RETCODE		ret = SQL_SUCCESS, tret;
+	SQLSETPOSIROW	i, n, rows_per_stmt;
+	TABLE_INFO	*ti;
+	const char	*list;
+	size_t		list_len;
+	int		*cols = NULL, ncols;
+	int		func_cs_count = 0;
+
+	MYLOG(MIN_LOG_LEVEL, "entering irow=" FORMAT_POSIROW " count=" FORMAT_POSIROW "\n", irow, count);
+	*processed = 0;
+	if (!SC_get_Curres(stmt))
+	{
+		SC_set_error(stmt, STMT_INVALID_CURSOR_STATE_ERROR, "Null statement result in SC_pos_add_rowset.", func);
+		return SQL_ERROR;
+	}
+	if (SC_update_not_ready(stmt))
+		parse_statement(stmt, TRUE);	/* not preferable */
+	if (!SC_is_updatable(stmt))
+	{
+		stmt->options.scroll_concurrency = SQL_CONCUR_READ_ONLY;
+		SC_set_error(stmt, STMT_INVALID_OPTION_IDENTIFIER, "the statement is read-only", func);
+		return SQL_ERROR;
+	}
+	ti = stmt->ti[0];
+	/* "insert into .. as alias" needs 9.5 */
+	if (count < 2 || TI_has_subclass(ti) || PG_VERSION_LT(conn, 8.2) ||
+	    (NAME_IS_VALID(ti->table_alias) && PG_VERSION_LT(conn, 9.5)) ||
+	    !load_select_list(stmt, &list, &list_len))
+		return SQL_SUCCESS;
+	if (NULL == (cols = (int *) malloc(sizeof(int) * SC_get_IRDF(stmt)->nfields)))
+	{
+		SC_set_error(stmt, STMT_NO_MEMORY_ERROR, "Out of memory in SC_pos_add_rowset()", func);
+		return SQL_ERROR;
+	}
+	if (ncols = rowset_bound_columns(stmt, irow, count, cols), ncols <= 0)
+	{
+		free(cols);
+		return SQL_SUCCESS;
+	}
+	rows_per_stmt = ROWSET_MAX_PARAMS / ncols;
+	if (0 == rows_per_stmt)
+		rows_per_stmt = 1;
+	ENTER_INNER_CONN_CS(conn, func_cs_count);
+	for (i = 0; SQL_ERROR != ret && i < count; i += n)
+	{
+		n = count - i;
+		if (n > rows_per_stmt)
+			n = rows_per_stmt;
+		tret = pos_add_rows(stmt, irow + i, n, cols, ncols, list, list_len);
+		if (SQL_ERROR != tret)
+			*processed += n;
+		if (SQL_SUCCESS != tret)
+			ret = tret;
+	}
+	CLEANUP_FUNC_CONN_CS(func_cs_count, conn);
+	free(cols);
+	return ret;
+}
+
 /*
  *	Stuff for updatable cursors end.
  */
@@ -28,6 +28,7 @@
 #include "convert.h"
 #include "environ.h"
 #include "loadlib.h"
+#include "lobj.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -383,7 +384,7 @@ SC_Constructor(ConnectionClass *conn)
 {
 	StatementClass *rv;
 
-	rv = (StatementClass *) malloc(sizeof(StatementClass));
+	rv = (StatementClass *) OP_get(OP_STATEMENT, sizeof(StatementClass));
 	if (rv)
 	{
 		rv->hdbc = conn;
@@ -402,6 +403,8 @@ SC_Constructor(ConnectionClass *conn)
 		rv->multi_statement = -1; /* unknown */
 		rv->num_params = -1; /* unknown */
 		rv->processed_statements = NULL;
+		rv->commands = NULL;
+		rv->num_commands = 0;
 
 		rv->__error_message = NULL;
 		rv->__error_number = 0;
@@ -420,6 +423,9 @@ SC_Constructor(ConnectionClass *conn)
 		rv->from_pos = rv->load_from_pos = rv->where_pos = -1;
 		rv->last_fetch_count = rv->last_fetch_count_include_ommitted = 0;
 		rv->save_rowset_size = -1;
+		rv->columnar_rows = NULL;
+		rv->columnar_rows_allocated = 0;
+		rv->columnar_fetch = FALSE;
 
 		rv->data_at_exec = -1;
 		rv->current_exec_param = -1;
@@ -432,6 +438,8 @@ SC_Constructor(ConnectionClass *conn)
 		SC_init_parse_method(rv);
 
 		rv->lobj_fd = -1;
+		rv->lobj_buf = NULL;
+		rv->lobj_buflen = rv->lobj_bufpos = rv->lobj_bufend = 0;
 		INIT_NAME(rv->cursor_name);
 
 		/* Parse Stuff */
@@ -527,6 +535,7 @@ SC_Destructor(StatementClass *self)
 	DC_Destructor((DescriptorClass *) SC_get_IRDi(self));
 	DC_Destructor((DescriptorClass *) SC_get_IPDi(self));
 	GDATA_unbind_cols(SC_get_GDTI(self), TRUE);
+	SC_unlink_streamed_putdata(self);
 	PDATA_free_params(SC_get_PDTI(self), STMT_FREE_PARAMS_ALL);
 
 	if (self->__error_message)
@@ -536,11 +545,15 @@ SC_Destructor(StatementClass *self)
 	cancelNeedDataState(self);
 	if (self->callbacks)
 		free(self->callbacks);
+	if (self->columnar_rows)
+		free(self->columnar_rows);
+	if (self->lobj_buf)
+		free(self->lobj_buf);
 	if (!PQExpBufferDataBroken(self->stmt_deferred))
 		termPQExpBuffer(&self->stmt_deferred);
 
 	DELETE_STMT_CS(self);
-	free(self);
+	OP_put(OP_STATEMENT, self);
 
 	MYLOG(MIN_LOG_LEVEL, "leaving\n");
 
@@ -595,6 +608,48 @@ SC_set_ResultHold(StatementClass *self, QResultHold rhold)
 
 }
 
+/*
+ *	Drop the temporary large objects which PGAPI_PutData streamed
+ *	bytea values into, once the statement no longer needs them.
+ *	If the driver began a transaction for them which the statement
+ *	didn't end (e.g. the statement was cancelled or freed before
+ *	executed), end it too.
+ */
+void
+SC_unlink_streamed_putdata(StatementClass *self)
+{
+	ConnectionClass	*conn = SC_get_conn(self);
+	PutDataInfo	*pdata = SC_get_PDTI(self);
+	BOOL		alive = (NULL != conn && NULL != conn->pqconn && CONN_DOWN != conn->status);
+	int		i;
+
+	for (i = 0; i < pdata->allocated; i++)
+	{
+		if (!pdata->pdata[i].streamed)
+			continue;
+		/* an aborted transaction takes the large object with it */
+		if (alive &&
+		    !CC_is_in_error_trans(conn) &&
+		    odbc_lo_unlink(conn, pdata->pdata[i].lobj_oid) < 0)
+			MYLOG(MIN_LOG_LEVEL, "couldn't unlink the streamed large object %u\n", pdata->pdata[i].lobj_oid);
+		pdata->pdata[i].lobj_oid = 0;
+		pdata->pdata[i].streamed = FALSE;
+	}
+	if (!pdata->stream_trans)
+		return;
+	pdata->stream_trans = FALSE;
+	if (alive &&
+	    CC_is_in_trans(conn) &&
+	    CC_does_autocommit(conn) &&
+	    !CC_cursor_count(conn))
+	{
+		if (CC_is_in_error_trans(conn))
+			CC_abort(conn);
+		else
+			CC_commit(conn);
+	}
+}
+
 /*
  *	Free parameters and free the memory from the
  *	data-at-execution parameters that was allocated in SQLPutData.
@@ -602,6 +657,7 @@ SC_set_ResultHold(StatementClass *self, QResultHold rhold)
 void
 SC_free_params(StatementClass *self, char option)
 {
+	SC_unlink_streamed_putdata(self);
 	if (option != STMT_FREE_PARAMS_DATA_AT_EXEC_ONLY)
 	{
 		APD_free_params(SC_get_APDF(self), option);
@@ -772,6 +828,7 @@ SC_initialize_stmts(StatementClass *self, BOOL initializeOriginal)
 			pstmt = next_pstmt;
 		}
 		self->processed_statements = NULL;
+		SC_forget_query_commands(self);
 
 		self->prepare = NON_PREPARE_STATEMENT;
 		SC_set_prepared(self, NOT_YET_PREPARED);
@@ -950,6 +1007,7 @@ MYLOG(DETAIL_LOG_LEVEL, "statement=%p ommitted=0\n", self);
 	self->__error_number = 0;
 
 	self->lobj_fd = -1;
+	self->lobj_bufpos = self->lobj_bufend = 0;
 
 	SC_free_params(self, STMT_FREE_PARAMS_DATA_AT_EXEC_ONLY);
 	SC_initialize_stmts(self, FALSE);
@@ -967,14 +1025,48 @@ MYLOG(DETAIL_LOG_LEVEL, "statement=%p ommitted=0\n", self);
 	return TRUE;
 }
 
+/*
+ *	Append a command to the index being built by scan_query().
+ *	On allocation failure the index is dropped.
+ */
+static void
+add_query_command(QueryCommand **commands, int *num_commands, int *alloc_commands,
+		ssize_t start, ssize_t end, SQLSMALLINT num_params)
+{
+	QueryCommand	*cmd;
+
+	if (NULL == *commands)
+		return;
+	if (*num_commands >= *alloc_commands)
+	{
+		QueryCommand	*newcmds;
+
+		*alloc_commands *= 2;
+		if (newcmds = (QueryCommand *) realloc(*commands, sizeof(QueryCommand) * *alloc_commands), NULL == newcmds)
+		{
+			free(*commands);
+			*commands = NULL;
+			return;
+		}
+		*commands = newcmds;
+	}
+	cmd = *commands + (*num_commands)++;
+	cmd->start = start;
+	cmd->end = end;
+	cmd->num_params = num_params;
+}
+
 /*
  *	Scan the query wholly or partially (if the next_cmd param specified).
  *	Also count the number of parameters respectviely.
+ *	If commands is specified, the position and the number of parameters
+ *	of each command are collected in the scan of the whole query.
  */
-void
-SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
+static void
+scan_query(const char *query, const ConnectionClass *conn,
 		ssize_t *next_cmd, SQLSMALLINT * pcpar,
-		po_ind_t *multi_st, po_ind_t *proc_return)
+		po_ind_t *multi_st, po_ind_t *proc_return,
+		QueryCommand **commands, int *num_commands)
 {
 	const	char *tstr, *tag = NULL;
 	size_t	taglen = 0;
@@ -985,11 +1077,18 @@ SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
 		in_line_comment = FALSE, del_found = FALSE;
 	int	comment_level = 0;
 	po_ind_t multi = FALSE;
-	SQLSMALLINT	num_p;
+	SQLSMALLINT	num_p, cmd_num_p = 0;
+	ssize_t		cmd_start = 0, del_pos = -1;
+	int		alloc_commands = 4;
 	encoded_str	encstr;
 
 	MYLOG(MIN_LOG_LEVEL, "entering...\n");
 	num_p = 0;
+	if (commands)
+	{
+		*num_commands = 0;
+		*commands = (QueryCommand *) malloc(sizeof(QueryCommand) * alloc_commands);
+	}
 	if (proc_return)
 		*proc_return = 0;
 	if (next_cmd)
@@ -1014,13 +1113,18 @@ SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
 
 			continue;
 		}
-		if (!multi && del_found)
+		if (del_found && IS_NOT_SPACE(tchar))
 		{
-			if (IS_NOT_SPACE(tchar))
+			/* the next command starts */
+			multi = TRUE;
+			if (next_cmd)
+				break;
+			del_found = FALSE;
+			if (commands)
 			{
-				multi = TRUE;
-				if (next_cmd)
-					break;
+				add_query_command(commands, num_commands, &alloc_commands, cmd_start, del_pos, num_p - cmd_num_p);
+				cmd_start = del_pos + 1;
+				cmd_num_p = num_p;
 			}
 		}
 		if (in_ident_keyword)
@@ -1095,6 +1199,7 @@ SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
 			else if (tchar == ';')
 			{
 				del_found = TRUE;
+				del_pos = encstr.pos;
 				if (next_cmd)
 					*next_cmd = encstr.pos;
 			}
@@ -1141,6 +1246,8 @@ SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
 				bchar = tchar;
 		}
 	}
+	if (commands)
+		add_query_command(commands, num_commands, &alloc_commands, cmd_start, del_found ? del_pos : -1, num_p - cmd_num_p);
 	if (pcpar)
 		*pcpar = num_p;
 	if (multi_st)
@@ -1149,6 +1256,42 @@ SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
 	MYLOG(MIN_LOG_LEVEL, "leaving...num_p=%d multi=%d\n", num_p, multi);
 }
 
+void
+SC_scanQueryAndCountParams(const char *query, const ConnectionClass *conn,
+		ssize_t *next_cmd, SQLSMALLINT * pcpar,
+		po_ind_t *multi_st, po_ind_t *proc_return)
+{
+	scan_query(query, conn, next_cmd, pcpar, multi_st, proc_return, NULL, NULL);
+}
+
+/*
+ *	Scan the whole query once, counting the parameters like
+ *	SC_scanQueryAndCountParams() and splitting it into the commands.
+ *	Returns the number of the commands stored in *commands (to be freed
+ *	by the caller), or -1 with *commands set to NULL if out of memory.
+ */
+int
+SC_scanQueryCommands(const char *query, const ConnectionClass *conn,
+		SQLSMALLINT *pcpar, po_ind_t *multi_st,
+		po_ind_t *proc_return, QueryCommand **commands)
+{
+	int	num_commands;
+
+	scan_query(query, conn, NULL, pcpar, multi_st, proc_return, commands, &num_commands);
+	if (NULL == *commands)
+		return -1;
+	return num_commands;
+}
+
+void
+SC_forget_query_commands(StatementClass *self)
+{
+	if (self->commands)
+		free(self->commands);
+	self->commands = NULL;
+	self->num_commands = 0;
+}
+
 /*
  * Describe the result set a statement will produce (for
  * SQLPrepare/SQLDescribeCol)
@@ -1700,6 +1843,7 @@ SC_fetch(StatementClass *self)
 	BindInfoClass	*bookmark;
 	BOOL		useCursor;
 	KeySet		*keyset = NULL;
+	ColumnConverter	*plan;
 
 	/* TupleField *tupleField; */
 
@@ -1806,6 +1950,9 @@ MYLOG(DETAIL_LOG_LEVEL, "stmt=%p ommitted++\n", self);
 	gdata = SC_get_GDTI(self);
 	if (gdata->allocated != opts->allocated)
 		extend_getdata_info(gdata, opts->allocated, TRUE);
+	plan = SC_get_conversion_plan(self, res);
+	if (self->columnar_fetch)
+		self->columnar_rows[self->bind_row] = GIdx2CacheIdx(self->currTuple, self, res);
 	for (lf = 0; lf < num_cols; lf++)
 	{
 		MYLOG(MIN_LOG_LEVEL, "fetch: cols=%d, lf=%d, opts = %p, opts->bindings = %p, buffer[] = %p\n", num_cols, lf, opts, opts->bindings, opts->bindings[lf].buffer);
@@ -1837,7 +1984,17 @@ MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 
 			MYLOG(MIN_LOG_LEVEL, "value = '%s'\n", (value == NULL) ? "<NULL>" : value);
 
-			retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf);
+			if (NULL != value && NULL != plan &&
+			    lf < res->cvt_plan_count &&
+			    CVT_PLAN_applicable(plan + lf, opts->bindings + lf))
+			{
+				if (self->columnar_fetch)
+					retval = COPY_OK;	/* SC_end_columnar_fetch() does it */
+				else
+					retval = copy_and_convert_field_plan(self, plan + lf, value, lf);
+			}
+			else
+				retval = copy_and_convert_field_bindinfo(self, type, atttypmod, value, lf);
 
 			MYLOG(MIN_LOG_LEVEL, "copy_and_convert: retval = %d\n", retval);
 
@@ -1890,6 +2047,87 @@ MYLOG(DETAIL_LOG_LEVEL, "curt=" FORMAT_LEN "\n", curt);
 }
 
 
+/*
+ *	Start a columnar fetch of the rowset if it's worth it, i.e.
+ *	the binding is column-wise and some bound columns have a
+ *	conversion plan. Only the results cached entirely are
+ *	handled so that the cache index of each row stays valid
+ *	until SC_end_columnar_fetch() is called.
+ */
+BOOL
+SC_begin_columnar_fetch(StatementClass *self, SQLLEN rowsetSize)
+{
+	QResultClass	*res = SC_get_Curres(self);
+	ARDFields	*opts = SC_get_ARDF(self);
+	ColumnConverter	*plan;
+	SQLLEN		i;
+	BOOL		applicable = FALSE;
+
+	self->columnar_fetch = FALSE;
+	if (rowsetSize <= 1 || NULL == res ||
+	    opts->bind_size > 0 ||
+	    NULL == opts->bindings ||
+	    SQL_RD_OFF == self->options.retrieve_data ||
+	    QR_haskeyset(res) ||
+	    (SC_is_fetchcursor(self) && NULL != QR_get_cursor(res)))
+		return FALSE;
+	if (plan = SC_get_conversion_plan(self, res), NULL == plan)
+		return FALSE;
+	for (i = 0; i < res->cvt_plan_count; i++)
+	{
+		if (NULL != opts->bindings[i].buffer &&
+		    CVT_PLAN_applicable(plan + i, opts->bindings + i))
+		{
+			applicable = TRUE;
+			break;
+		}
+	}
+	if (!applicable)
+		return FALSE;
+	if (self->columnar_rows_allocated < rowsetSize)
+	{
+		SQLLEN	*rows = (SQLLEN *) realloc(self->columnar_rows, sizeof(SQLLEN) * rowsetSize);
+
+		if (NULL == rows)
+			return FALSE;
+		self->columnar_rows = rows;
+		self->columnar_rows_allocated = rowsetSize;
+	}
+	for (i = 0; i < rowsetSize; i++)
+		self->columnar_rows[i] = -1;
+	self->columnar_fetch = TRUE;
+	MYLOG(MIN_LOG_LEVEL, "columnar fetch of " FORMAT_LEN " rows\n", rowsetSize);
+
+	return TRUE;
+}
+
+/*
+ *	Convert the deferred columns of the first nrows rows of the rowset.
+ */
+void
+SC_end_columnar_fetch(StatementClass *self, SQLLEN nrows)
+{
+	QResultClass	*res = SC_get_Curres(self);
+	ARDFields	*opts = SC_get_ARDF(self);
+	ColumnConverter	*plan;
+	int		lf;
+
+	if (!self->columnar_fetch)
+		return;
+	self->columnar_fetch = FALSE;
+	if (nrows <= 0 || NULL == res || NULL == opts->bindings)
+		return;
+	if (plan = res->cvt_plan, NULL == plan)
+		return;
+	for (lf = 0; lf < res->cvt_plan_count && lf < opts->allocated; lf++)
+	{
+		if (NULL != opts->bindings[lf].buffer &&
+		    CVT_PLAN_applicable(plan + lf, opts->bindings + lf))
+			copy_and_convert_column_plan(self, plan + lf, lf, self->columnar_rows, nrows);
+	}
+}
+
+
 #include "dlg_specific.h"
 RETCODE
 SC_execute(StatementClass *self)
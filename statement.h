@@ -202,11 +202,23 @@ struct ProcessedStmt
 };
 typedef struct ProcessedStmt ProcessedStmt;
 
+/*
+ * QueryCommand is the position of one command of a (multi-command) query
+ * and the number of parameter markers in it, see SC_scanQueryCommands().
+ */
+typedef struct
+{
+	ssize_t		start;		/* offset of the command */
+	ssize_t		end;		/* offset of the ';' ending it or -1 */
+	SQLSMALLINT	num_params;
+} QueryCommand;
+
 /********	Statement Handle	***********/
 struct StatementClass_
 {
 	ConnectionClass *hdbc;		/* pointer to ConnectionClass this
 								 * statement belongs to */
+	int			conn_slot;	/* index in hdbc->stmts */
 	QResultHold rhold;
 	QResultClass *curres;		/* the current result in the chain */
 	QResultClass *parsed;		/* parsed result before exec */
@@ -243,6 +255,10 @@ struct StatementClass_
 	SQLLEN		last_fetch_count;	/* number of rows retrieved in
 						 * last fetch/extended fetch */
 	int		lobj_fd;		/* fd of the current large object */
+	char	   *lobj_buf;		/* data read ahead from the large object */
+	Int4		lobj_buflen;	/* allocated length of lobj_buf */
+	Int4		lobj_bufpos;	/* next byte of lobj_buf to return */
+	Int4		lobj_bufend;	/* end of the data in lobj_buf */
 
 	char	   *statement;		/* if non--null pointer to the SQL
 					 * statement that has been executed */
@@ -252,6 +268,9 @@ struct StatementClass_
 	 * values in UseServerSidePrepare=0 mode.
 	 */
 	ProcessedStmt *processed_statements;
+	/* the commands of statement, NULL if not scanned yet */
+	QueryCommand	*commands;
+	int		num_commands;
 
 	TABLE_INFO	**ti;
 	Int2		ntab;
@@ -299,6 +318,14 @@ struct StatementClass_
 	ssize_t		load_from_pos;
 	ssize_t		where_pos;
 	SQLLEN		last_fetch_count_include_ommitted;
+	/*
+	 * columnar fetch: the cache index of each row of the rowset.
+	 * The columns having a conversion plan are converted column
+	 * by column once the whole rowset has been fetched.
+	 */
+	SQLLEN		*columnar_rows;
+	SQLLEN		columnar_rows_allocated;
+	po_ind_t	columnar_fetch;
 	time_t		stmt_time;
 	struct tm	localtime;
 	//	for batch execution
@@ -527,17 +554,23 @@ void		SC_inc_rowset_start(StatementClass *self, SQLLEN);
 RETCODE		SC_initialize_stmts(StatementClass *self, BOOL);
 RETCODE		SC_execute(StatementClass *self);
 RETCODE		SC_fetch(StatementClass *self);
+BOOL		SC_begin_columnar_fetch(StatementClass *self, SQLLEN rowsetSize);
+void		SC_end_columnar_fetch(StatementClass *self, SQLLEN nrows);
 void		SC_free_params(StatementClass *self, char option);
+void		SC_unlink_streamed_putdata(StatementClass *self);
 void		SC_log_error(const char *func, const char *desc, const StatementClass *self);
 time_t		SC_get_time(StatementClass *self);
 struct tm	*SC_get_localtime(StatementClass *self);
 SQLLEN		SC_get_int4_bookmark(StatementClass *self);
 RETCODE		SC_pos_reload(StatementClass *self, SQLULEN index, UInt2 *, Int4);
 RETCODE		SC_pos_update(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index, const KeySet *keyset);
+RETCODE		SC_pos_update_rowset(StatementClass *self, SQLSETPOSIROW irow, SQLSETPOSIROW count, const SQLULEN *global_ridx, SQLSETPOSIROW *processed);
 RETCODE		SC_pos_delete(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index, const KeySet *keyset);
+RETCODE		SC_pos_delete_rowset(StatementClass *self, SQLSETPOSIROW irow, SQLSETPOSIROW count, const SQLULEN *global_ridx, const KeySet *keysets, SQLSETPOSIROW *processed);
 RETCODE		SC_pos_refresh(StatementClass *self, SQLSETPOSIROW irow, SQLULEN index);
 RETCODE		SC_pos_fetch(StatementClass *self, const PG_BM *pg_bm);
 RETCODE		SC_pos_add(StatementClass *self, SQLSETPOSIROW irow);
+RETCODE		SC_pos_add_rowset(StatementClass *self, SQLSETPOSIROW irow, SQLSETPOSIROW count, SQLSETPOSIROW *processed);
 RETCODE		SC_fetch_by_bookmark(StatementClass *self);
 int		SC_Create_bookmark(StatementClass *stmt, BindInfoClass *bookmark, Int4 row_pos, Int4 currTuple, const KeySet *keyset);
 PG_BM		SC_Resolve_bookmark(const ARDFields *opts, Int4 idx);
@@ -546,6 +579,12 @@ void		SC_setInsertedTable(StatementClass *, RETCODE);
 void		SC_scanQueryAndCountParams(const char *, const ConnectionClass *,
 			ssize_t *next_cmd, SQLSMALLINT *num_params,
 			po_ind_t *multi, po_ind_t *proc_return);
+int		SC_scanQueryCommands(const char *, const ConnectionClass *,
+			SQLSMALLINT *num_params, po_ind_t *multi,
+			po_ind_t *proc_return, QueryCommand **commands);
+void		SC_forget_query_commands(StatementClass *self);
+void		SC_countQueryParams(StatementClass *self, SQLSMALLINT *num_params,
+			po_ind_t *multi, po_ind_t *proc_return);
 
 BOOL	SC_IsExecuting(const StatementClass *self);
 BOOL	SC_SetExecuting(StatementClass *self, BOOL on);
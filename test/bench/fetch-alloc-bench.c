@@ -0,0 +1,125 @@
+/*
+ * Benchmark the memory allocator on a fetch-heavy workload.
+ *
+ * Every executed query reads all of its rows into the result cache of the
+ * driver, which allocates each fetched value, and frees them again when
+ * the cursor is closed. So the timings mostly depend on malloc() and
+ * free(). To compare the C library allocator with mimalloc, build the
+ * driver once as usual and once configured --with-mimalloc, and run this
+ * program against the test DSN with each of them (MIMALLOC_VERBOSE=1
+ * shows whether mimalloc is in use).
+ *
+ * This is not part of the regression suite: it prints timings, which vary
+ * from run to run. Build it with "make bench" and run it as
+ * exe/fetch-alloc-bench [rows [loops]]. The defaults are one hundred
+ * thousand rows and twenty loops.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef WIN32
+#include <time.h>
+#endif
+
+#include "../src/common.h"
+
+static double
+now_ms(void)
+{
+#ifdef WIN32
+	return (double) GetTickCount64();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+/* Execute the query, fetch all the rows and return their number */
+static SQLLEN
+fetch_all(HSTMT hstmt, const char *sql)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id;
+	char		name[64], descr[256];
+	SQLLEN		ind_id, ind_name, ind_descr;
+	SQLLEN		total = 0;
+
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, &id, 0, &ind_id);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_CHAR, name, sizeof(name), &ind_name);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 3, SQL_C_CHAR, descr, sizeof(descr), &ind_descr);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	while (rc = SQLFetch(hstmt), SQL_SUCCEEDED(rc))
+		total++;
+	if (rc != SQL_NO_DATA)
+	{
+		print_diag("SQLFetch failed", SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	return total;
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	long		nrows = 100000, nloops = 20, i;
+	SQLLEN		total = 0;
+	char		sql[512];
+	double		start, elapsed, best = 0;
+
+	if (argc > 1)
+		nrows = atol(argv[1]);
+	if (argc > 2)
+		nloops = atol(argv[2]);
+	if (nrows < 1 || nloops < 1)
+	{
+		fprintf(stderr, "usage: %s [rows [loops]]\n", argv[0]);
+		exit(1);
+	}
+
+	/* read the whole result at once, the way most applications do */
+	test_connect_ext("UseDeclareFetch=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/* values of varying sizes, so that several size classes are used */
+	snprintf(sql, sizeof(sql),
+			 "SELECT g, 'name ' || g, pg_catalog.repeat('x', g %% 200) "
+			 "FROM pg_catalog.generate_series(1, %ld) g", nrows);
+
+	start = now_ms();
+	for (i = 0; i < nloops; i++)
+	{
+		double	loop_start = now_ms();
+
+		total += fetch_all(hstmt, sql);
+		elapsed = now_ms() - loop_start;
+		if (0 == i || elapsed < best)
+			best = elapsed;
+	}
+	elapsed = now_ms() - start;
+	printf("fetch: %ld rows in %.0f ms, %.0f ms per loop, best %.0f ms\n", (long) total, elapsed, elapsed / nloops, best);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * Benchmark scrolling and editing through a large keyset-driven cursor.
+ *
+ * This is not part of the regression suite: it prints timings, which vary
+ * from run to run. Build it with "make bench" and run it against the test
+ * DSN as exe/keyset-cursor-bench [rows [edits]]. The defaults are one
+ * million rows and ten thousand edits.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef WIN32
+#include <time.h>
+#endif
+
+#include "../src/common.h"
+
+#define ROWSET_SIZE	100
+
+static double
+now_ms(void)
+{
+#ifdef WIN32
+	return (double) GetTickCount64();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
+
+static void
+exec_direct(HSTMT hstmt, const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* Fetch the whole cursor forward and return the number of rows seen */
+static SQLLEN
+scroll_all(HSTMT hstmt, SQLULEN *fetched)
+{
+	SQLRETURN	rc;
+	SQLLEN		total = 0;
+
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_FIRST, 0);
+	while (SQL_SUCCEEDED(rc))
+	{
+		total += *fetched;
+		rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	}
+	if (rc != SQL_NO_DATA)
+	{
+		print_diag("SQLFetchScroll failed", SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+	return total;
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLLEN		nrows = 1000000, nedits = 10000, i, total, pos;
+	SQLINTEGER	ids[ROWSET_SIZE], vals[ROWSET_SIZE];
+	SQLLEN		ind_ids[ROWSET_SIZE], ind_vals[ROWSET_SIZE];
+	SQLUSMALLINT	status[ROWSET_SIZE];
+	SQLULEN		fetched;
+	char		sql[256];
+	double		start;
+
+	if (argc > 1)
+		nrows = atol(argv[1]);
+	if (argc > 2)
+		nedits = atol(argv[2]);
+	if (nedits < 1 || nrows < nedits + ROWSET_SIZE)
+	{
+		fprintf(stderr, "usage: %s [rows [edits(<= rows - %d)]]\n", argv[0], ROWSET_SIZE);
+		exit(1);
+	}
+
+	test_connect_ext("UpdatableCursors=1;UseDeclareFetch=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	exec_direct(hstmt, "CREATE TEMPORARY TABLE keyset_bench(id int4 primary key, val int4)");
+	snprintf(sql, sizeof(sql), "INSERT INTO keyset_bench SELECT g, g FROM pg_catalog.generate_series(1, %ld) g", (long) nrows);
+	exec_direct(hstmt, sql);
+
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_AUTOCOMMIT, (SQLPOINTER) SQL_AUTOCOMMIT_OFF, 0);
+	CHECK_CONN_RESULT(rc, "SQLSetConnectAttr failed", conn);
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) SQL_CURSOR_KEYSET_DRIVEN, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CONCURRENCY, (SQLPOINTER) SQL_CONCUR_ROWVER, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) ROWSET_SIZE, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, (SQLPOINTER) status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, (SQLPOINTER) &fetched, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_SLONG, ids, 0, ind_ids);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_SLONG, vals, 0, ind_vals);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+
+	start = now_ms();
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, val FROM keyset_bench ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	printf("open: %ld rows in %.0f ms\n", (long) nrows, now_ms() - start);
+
+	start = now_ms();
+	total = scroll_all(hstmt, &fetched);
+	printf("scroll: %ld rows in %.0f ms\n", (long) total, now_ms() - start);
+
+	/*
+	 * Spread the edits over the cursor: update the first row and delete
+	 * the second one of rowsets at evenly spaced positions.
+	 */
+	start = now_ms();
+	for (i = 0; i < nedits; i++)
+	{
+		pos = 1 + (nrows - ROWSET_SIZE) / nedits * i;
+		rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, pos);
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+		vals[0] = -vals[0];
+		rc = SQLSetPos(hstmt, 1, SQL_UPDATE, SQL_LOCK_NO_CHANGE);
+		CHECK_STMT_RESULT(rc, "SQLSetPos update failed", hstmt);
+		rc = SQLSetPos(hstmt, 2, SQL_DELETE, SQL_LOCK_NO_CHANGE);
+		CHECK_STMT_RESULT(rc, "SQLSetPos delete failed", hstmt);
+	}
+	printf("edit: %ld updates and deletes in %.0f ms\n", (long) nedits, now_ms() - start);
+
+	start = now_ms();
+	total = scroll_all(hstmt, &fetched);
+	printf("scroll after edits: %ld rows in %.0f ms\n", (long) total, now_ms() - start);
+
+	start = now_ms();
+	for (i = 0; i < nedits; i++)
+	{
+		pos = 1 + (nrows - nedits - ROWSET_SIZE) / nedits * (nedits - i - 1);
+		rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, pos);
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	}
+	printf("absolute: %ld positionings in %.0f ms\n", (long) nedits, now_ms() - start);
+
+	start = now_ms();
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_COMMIT);
+	CHECK_CONN_RESULT(rc, "SQLEndTran failed", conn);
+	printf("commit: %.0f ms\n", now_ms() - start);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -31,6 +31,29 @@ printCurrentRow(HSTMT hstmt)
 	printf("\n");
 }
 
+static const char *
+row_status_str(SQLUSMALLINT status)
+{
+	switch (status)
+	{
+		case SQL_ROW_SUCCESS:
+			return "SUCCESS";
+		case SQL_ROW_SUCCESS_WITH_INFO:
+			return "SUCCESS_WITH_INFO";
+		case SQL_ROW_ERROR:
+			return "ERROR";
+		case SQL_ROW_DELETED:
+			return "DELETED";
+		case SQL_ROW_UPDATED:
+			return "UPDATED";
+		case SQL_ROW_ADDED:
+			return "ADDED";
+		case SQL_ROW_NOROW:
+			return "NOROW";
+	}
+	return "???";
+}
+
 #define	BOOKMARK_SIZE	14
 
 int main(int argc, char **argv)
@@ -52,6 +75,16 @@ int main(int argc, char **argv)
 	SQLLEN		indColvalues1[3];
 	SQLLEN		indColvalues2[3];
 
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	char		rowset_bookmarks[4][BOOKMARK_SIZE];
+	SQLLEN		rowset_bookmark_inds[4];
+	SQLINTEGER	rowset_values1[4];
+	SQLINTEGER	rowset_values2[4];
+	SQLLEN		rowset_inds1[4];
+	SQLLEN		rowset_inds2[4];
+	SQLUSMALLINT	row_status[4];
+	SQLLEN		row_count;
+
 	memset(bookmark, 0x7F, sizeof(bookmark));
 	memset(saved_bookmarks, 0xF7, sizeof(saved_bookmarks));
 
@@ -187,6 +220,132 @@ int main(int argc, char **argv)
 	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
 	print_result(hstmt);
 
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** Delete a rowset containing deleted and changed rows ****/
+	printf("\nDeleting a rowset by bookmarks\n");
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt2);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+
+	rc = SQLBindCol(hstmt, 0, SQL_C_VARBOOKMARK, rowset_bookmarks, sizeof(bookmark), rowset_bookmark_inds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, rowset_values1, 0, rowset_inds1);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_LONG, rowset_values2, 0, rowset_inds2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 4, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, row_status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	for (i = 0; i < 4; i++)
+		printf("row %d: %d - %d %s\n", i + 1, rowset_values1[i], rowset_values2[i], row_status_str(row_status[i]));
+
+	/* the 2nd row is already deleted through the cursor */
+	rc = SQLSetPos(hstmt, 2, SQL_DELETE, SQL_LOCK_NO_CHANGE);
+	CHECK_STMT_RESULT(rc, "SQLSetPos DELETE failed", hstmt);
+	/* and the 3rd one is changed behind the cursor */
+	rc = SQLExecDirect(hstmt2, (SQLCHAR *) "UPDATE bulkoperations_test SET i = i + 1000 WHERE orig = 3", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+
+	rc = SQLBulkOperations(hstmt, SQL_DELETE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	printf("SQLBulkOperations returned %s\n", SQL_SUCCESS == rc ? "SQL_SUCCESS" : "SQL_SUCCESS_WITH_INFO");
+	for (i = 0; i < 4; i++)
+		printf("row %d: %s\n", i + 1, row_status_str(row_status[i]));
+	rc = SQLGetDiagField(SQL_HANDLE_STMT, hstmt, 0, SQL_DIAG_ROW_COUNT, &row_count, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetDiagField failed", hstmt);
+	printf("row count: %d\n", (int) row_count);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** Update and add whole rowsets ****/
+	printf("\nUpdating and adding a rowset by bookmarks\n");
+	rc = SQLBindCol(hstmt, 0, SQL_C_VARBOOKMARK, rowset_bookmarks, sizeof(bookmark), rowset_bookmark_inds);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 1, SQL_C_LONG, rowset_values1, 0, rowset_inds1);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLBindCol(hstmt, 2, SQL_C_LONG, rowset_values2, 0, rowset_inds2);
+	CHECK_STMT_RESULT(rc, "SQLBindCol failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 4, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, row_status, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+
+	/* set the 1st column of every row and leave the 2nd one alone */
+	for (i = 0; i < 4; i++)
+	{
+		rowset_values1[i] += 10000;
+		rowset_inds2[i] = SQL_IGNORE;
+	}
+	rc = SQLBulkOperations(hstmt, SQL_UPDATE_BY_BOOKMARK);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	for (i = 0; i < 4; i++)
+		printf("row %d: %s\n", i + 1, row_status_str(row_status[i]));
+	rc = SQLGetDiagField(SQL_HANDLE_STMT, hstmt, 0, SQL_DIAG_ROW_COUNT, &row_count, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetDiagField failed", hstmt);
+	printf("row count: %d\n", (int) row_count);
+
+	/* the cached rows show the new values */
+	rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, 1);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	for (i = 0; i < 4; i++)
+		printf("row %d: %d - %d\n", i + 1, rowset_values1[i], rowset_values2[i]);
+
+	for (i = 0; i < 4; i++)
+	{
+		rowset_values1[i] = 2001 + i;
+		rowset_values2[i] = 3001 + i;
+		rowset_inds1[i] = rowset_inds2[i] = 0;
+	}
+	rc = SQLBulkOperations(hstmt, SQL_ADD);
+	CHECK_STMT_RESULT(rc, "SQLBulkOperations failed", hstmt);
+	for (i = 0; i < 4; i++)
+		printf("row %d: %s\n", i + 1, row_status_str(row_status[i]));
+	rc = SQLGetDiagField(SQL_HANDLE_STMT, hstmt, 0, SQL_DIAG_ROW_COUNT, &row_count, 0, NULL);
+	CHECK_STMT_RESULT(rc, "SQLGetDiagField failed", hstmt);
+	printf("row count: %d\n", (int) row_count);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_UNBIND);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT * FROM bulkoperations_test ORDER BY orig", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt2);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt2);
+
 	/* Clean up */
 	test_disconnect();
 
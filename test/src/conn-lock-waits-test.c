@@ -0,0 +1,205 @@
+/*
+ * Test the connection lock wait counters
+ * (SQL_ATTR_PGOPT_CONN_LOCK_WAITS and SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC).
+ *
+ * The holder thread runs a query which blocks on an advisory lock taken
+ * by a second connection, so it holds the lock of the main connection
+ * until the main thread lets it go. The waiter thread runs another
+ * query on the main connection meanwhile, which has to wait for the
+ * connection lock. The counters are read while the connection is busy,
+ * which they must not wait for.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#ifdef WIN32
+#include <process.h>
+#define	sleep_msec(msec)	Sleep(msec)
+typedef HANDLE	thread_t;
+#else
+#include <pthread.h>
+#include <unistd.h>
+#define	sleep_msec(msec)	usleep((msec) * 1000)
+typedef pthread_t	thread_t;
+#endif
+
+#define SQL_ATTR_PGOPT_CONN_LOCK_WAITS		65552
+#define SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC	65553
+
+static HSTMT	holder_hstmt = SQL_NULL_HSTMT;
+static HSTMT	waiter_hstmt = SQL_NULL_HSTMT;
+static volatile int	waiter_started = 0;
+
+#ifdef WIN32
+static unsigned __stdcall
+#else
+static void *
+#endif
+run_holder(void *arg)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(holder_hstmt, (SQLCHAR *) "SELECT pg_advisory_lock(4343), pg_advisory_unlock(4343)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect in the holder thread failed", holder_hstmt);
+	return 0;
+}
+
+#ifdef WIN32
+static unsigned __stdcall
+#else
+static void *
+#endif
+run_waiter(void *arg)
+{
+	SQLRETURN	rc;
+
+	waiter_started = 1;
+	rc = SQLExecDirect(waiter_hstmt, (SQLCHAR *) "SELECT 1", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect in the waiter thread failed", waiter_hstmt);
+	return 0;
+}
+
+static thread_t
+start_thread(void *(*func)(void *))
+{
+#ifdef WIN32
+	return (HANDLE) _beginthreadex(NULL, 0, (unsigned (__stdcall *)(void *)) func, NULL, 0, NULL);
+#else
+	pthread_t	thread;
+
+	pthread_create(&thread, NULL, func, NULL);
+	return thread;
+#endif
+}
+
+static void
+join_thread(thread_t thread)
+{
+#ifdef WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+}
+
+static void
+run_sql(HSTMT hstmt, const char *sql)
+{
+	SQLRETURN	rc;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+/* Wait until the holder thread is blocked on the advisory lock */
+static void
+wait_for_holder(HSTMT hstmt2)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	waiting = 0;
+
+	while (0 == waiting)
+	{
+		rc = SQLExecDirect(hstmt2, (SQLCHAR *) "SELECT count(*) FROM pg_locks WHERE locktype = 'advisory' AND objid = 4343 AND NOT granted", SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt2);
+		rc = SQLFetch(hstmt2);
+		CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt2);
+		rc = SQLGetData(hstmt2, 1, SQL_C_SLONG, &waiting, 0, NULL);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt2);
+		rc = SQLFreeStmt(hstmt2, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt2);
+		if (0 == waiting)
+			sleep_msec(10);
+	}
+}
+
+static void
+get_lock_waits(SQLUINTEGER *waits, SQLBIGINT *wait_usec)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	len;
+
+	rc = SQLGetConnectAttr(conn, SQL_ATTR_PGOPT_CONN_LOCK_WAITS, waits, 0, NULL);
+	CHECK_CONN_RESULT(rc, "SQLGetConnectAttr failed", conn);
+	rc = SQLGetConnectAttr(conn, SQL_ATTR_PGOPT_CONN_LOCK_WAIT_USEC, wait_usec, 0, &len);
+	CHECK_CONN_RESULT(rc, "SQLGetConnectAttr failed", conn);
+	if (len != sizeof(SQLBIGINT))
+		printf("unexpected length %d of the wait time\n", (int) len);
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HDBC		hdbc2 = SQL_NULL_HDBC;
+	HSTMT		hstmt2 = SQL_NULL_HSTMT;
+	SQLUINTEGER	waits;
+	SQLBIGINT	wait_usec;
+	char		dsn[1024];
+	thread_t	holder, waiter;
+
+	test_connect();
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &holder_hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &waiter_hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+
+	/* the second connection, which takes the advisory lock */
+	snprintf(dsn, sizeof(dsn), "DSN=%s", get_test_dsn());
+	rc = SQLAllocHandle(SQL_HANDLE_DBC, env, &hdbc2);
+	CHECK_CONN_RESULT(rc, "SQLAllocHandle failed", conn);
+	rc = SQLDriverConnect(hdbc2, NULL, (SQLCHAR *) dsn, SQL_NTS,
+						  NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+	CHECK_CONN_RESULT(rc, "SQLDriverConnect failed", hdbc2);
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, hdbc2, &hstmt2);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", hdbc2);
+
+	get_lock_waits(&waits, &wait_usec);
+	printf("lock waits before: %u, wait time is %s\n", (unsigned int) waits, 0 == wait_usec ? "zero" : "not zero");
+
+	/* the counters are read only */
+	rc = SQLSetConnectAttr(conn, SQL_ATTR_PGOPT_CONN_LOCK_WAITS, (SQLPOINTER) 10, 0);
+	printf("setting the lock waits %s\n", SQL_SUCCEEDED(rc) ? "succeeded" : "failed");
+
+	run_sql(hstmt2, "SELECT pg_advisory_lock(4343)");
+	holder = start_thread(run_holder);
+	wait_for_holder(hstmt2);
+
+	/* the holder thread has the connection now */
+	get_lock_waits(&waits, &wait_usec);
+	printf("lock waits while the connection is busy: %u\n", (unsigned int) waits);
+
+	waiter = start_thread(run_waiter);
+	while (!waiter_started)
+		sleep_msec(10);
+	/* give it the time to block on the connection lock */
+	sleep_msec(200);
+	run_sql(hstmt2, "SELECT pg_advisory_unlock(4343)");
+	join_thread(holder);
+	join_thread(waiter);
+	print_result(waiter_hstmt);
+
+	get_lock_waits(&waits, &wait_usec);
+	printf("lock waits after: %s, wait time is %s\n", waits > 0 ? "counted" : "not counted", wait_usec > 0 ? "not zero" : "zero");
+
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, holder_hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", holder_hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, waiter_hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", waiter_hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt2);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt2);
+	rc = SQLDisconnect(hdbc2);
+	CHECK_CONN_RESULT(rc, "SQLDisconnect failed", hdbc2);
+	rc = SQLFreeHandle(SQL_HANDLE_DBC, hdbc2);
+	CHECK_CONN_RESULT(rc, "SQLFreeHandle failed", hdbc2);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -13,6 +13,8 @@
 #define	BLOCK	4
 
 static HSTMT	hstmte = SQL_NULL_HSTMT;
+static SQLINTEGER	id[BLOCK];
+static SQLULEN	rowsFetched;
 
 static SQLRETURN delete_loop(HSTMT hstmt)
 {
@@ -46,6 +48,25 @@ static SQLRETURN delete_loop(HSTMT hstmt)
 	return	SQL_SUCCESS;
 }
 
+/* Fetch a rowset and print the ids in it */
+static void fetch_and_print(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, const char *label)
+{
+	SQLRETURN	rc;
+	SQLULEN		k;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	if (SQL_NO_DATA == rc)
+	{
+		printf("%s: no data\n", label);
+		return;
+	}
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("%s:", label);
+	for (k = 0; k < rowsFetched; k++)
+		printf(" %d", (int) id[k]);
+	printf("\n");
+}
+
 int main(int argc, char **argv)
 {
 	int		rc;
@@ -54,8 +75,6 @@ int main(int argc, char **argv)
 	int		count = TOTAL;
 	char		query[100];
 	SQLLEN		rowArraySize = BLOCK;
-	SQLULEN		rowsFetched;
-	SQLINTEGER	id[BLOCK];
 	SQLLEN		cbLen[BLOCK];
 
 	/****
@@ -151,6 +170,46 @@ int main(int argc, char **argv)
 	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
 	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 
+	/*
+	 * Delete every third row through the cursor and check which rows the
+	 * scrolling fetches land on. The deleted rows stay in the keyset and
+	 * have to be skipped.
+	 */
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "select * from tmptable where id < 40 order by id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "select failed", hstmt);
+	/* backwards, so that the rows to delete keep their positions */
+	for (i = 39; i >= 0; i -= 3)
+	{
+		rc = SQLFetchScroll(hstmt, SQL_FETCH_ABSOLUTE, i + 1);
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+		if (id[0] != i)
+			printf("absolute %d fetched %d\n", i + 1, id[0]);
+		rc = SQLSetPos(hstmt, 1, SQL_DELETE, SQL_LCK_NO_CHANGE);
+		CHECK_STMT_RESULT(rc, "SQLSetPos delete failed", hstmt);
+	}
+	printf("deleted the rows 39, 36, ..., 0\n");
+
+	/* from the start */
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 10, "absolute 10");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, 5, "relative 5");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 1, "absolute 1");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_NEXT, 0, "next");
+	/* and from the end */
+	fetch_and_print(hstmt, SQL_FETCH_LAST, 0, "last");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, -7, "relative -7");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, -3, "absolute -3");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, -26, "absolute -26");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 26, "absolute 26");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 27, "absolute 27");
+
+	rc = SQLEndTran(SQL_HANDLE_DBC, conn, SQL_ROLLBACK);
+	CHECK_STMT_RESULT(rc, "SQLEndTran failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
 	/* Clean up */
 	test_disconnect();
 
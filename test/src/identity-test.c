@@ -52,6 +52,40 @@ test_identity_col(const char *createsql, const char *insertsql, const char *veri
 	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 }
 
+/*
+ * @@identity has to follow the table inserted into last, even when the
+ * same "SELECT @@IDENTITY" statement is executed again.
+ */
+static void
+test_identity_two_tables(void)
+{
+	static const char *sqls[] = {
+		"INSERT INTO identa (t) VALUES ('a1')",
+		"INSERT INTO identb (t) VALUES ('b1'), ('b2'), ('b3')",
+		"INSERT INTO identa (t) VALUES ('a2')",
+		NULL
+	};
+	SQLRETURN	rc;
+	int		i;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE identa (id serial primary key, t text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed while creating temp table", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE identb (id serial primary key, t text)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed while creating temp table", hstmt);
+
+	for (i = 0; NULL != sqls[i]; i++)
+	{
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) sqls[i], SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+		rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT @@IDENTITY AS last_insert", SQL_NTS);
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+		print_result(hstmt);
+
+		rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+		CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	}
+}
 
 int main(int argc, char **argv)
 {
@@ -97,6 +131,8 @@ int main(int argc, char **argv)
 		"INSERT INTO \"tmp table\" (t) VALUES ('space in table name')",
 		"SELECT * FROM \"tmp table\"");
 
+	test_identity_two_tables();
+
 	/* Clean up */
 	test_disconnect();
 
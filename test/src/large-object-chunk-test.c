@@ -0,0 +1,119 @@
+/*
+ * Test reading and writing a large object bigger than one
+ * LargeObjectChunkSize chunk. It's read back in pieces bigger and smaller
+ * than a chunk; the latter are served from the read-ahead chunk buffer.
+ */
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	LO_LENGTH	10500	/* 10 full chunks and a partial one */
+#define	BIG_PIECE	4096
+#define	SMALL_PIECE	384		/* not a divisor of the chunk size */
+
+static unsigned char data[LO_LENGTH], buf[LO_LENGTH * 2];
+
+static void
+read_in_pieces(HSTMT hstmt, SQLLEN piece_size)
+{
+	int			rc;
+	SQLLEN		ind, got, total;
+	int			pieces;
+
+	printf("reading it back in pieces of %d bytes...\n", (int) piece_size);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, large_data FROM lo_test_tab WHERE id = 2", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	memset(buf, 0, sizeof(buf));
+	total = 0;
+	got = 0;
+	pieces = 0;
+	while (rc = SQLGetData(hstmt, 2, SQL_C_BINARY, buf + total, piece_size, &ind), SQL_SUCCEEDED(rc))
+	{
+		got = (SQL_NO_TOTAL == ind || ind > piece_size) ? piece_size : ind;
+		pieces++;
+		total += got;
+		if (total > LO_LENGTH)
+			break;
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("got %d pieces, the last one of %d bytes\n", pieces, (int) got);
+	printf("%s\n", LO_LENGTH == total && memcmp(buf, data, LO_LENGTH) == 0 ? "data matches" : "data differs");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
+int main(int argc, char **argv)
+{
+	int rc;
+	HSTMT hstmt = SQL_NULL_HSTMT;
+	SQLLEN cbParam1;
+	SQLLEN ind;
+	int i;
+
+	for (i = 0; i < LO_LENGTH; i++)
+		data[i] = (unsigned char) (i % 251);
+
+	test_connect_ext("LargeObjectChunkSize=1000");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	/**** Insert a Large Object */
+	printf("inserting large object...\n");
+	rc = SQLPrepare(hstmt, (SQLCHAR *) "INSERT INTO lo_test_tab VALUES (2, ?)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLPrepare failed", hstmt);
+
+	cbParam1 = LO_LENGTH;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_BINARY,	/* value type */
+						  SQL_LONGVARBINARY,	/* param type */
+						  LO_LENGTH,	/* column size */
+						  0,			/* dec digits */
+						  data,			/* param value ptr */
+						  0,			/* buffer len */
+						  &cbParam1		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	rc = SQLExecute(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLExecute failed", hstmt);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** Read it back at once ****/
+	printf("reading it back at once...\n");
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, large_data FROM lo_test_tab WHERE id = 2", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	rc = SQLGetData(hstmt, 2, SQL_C_BINARY, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("got %d bytes, %s\n", (int) ind,
+		   LO_LENGTH == ind && memcmp(buf, data, LO_LENGTH) == 0 ? "data matches" : "data differs");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/**** Read it back in pieces bigger and smaller than a chunk ****/
+	read_in_pieces(hstmt, BIG_PIECE);
+	read_in_pieces(hstmt, SMALL_PIECE);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
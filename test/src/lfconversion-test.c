@@ -8,6 +8,64 @@
 
 #include "common.h"
 
+/* Print a fetched string with the CRs and LFs made visible */
+static void
+print_escaped(const char *str)
+{
+	for (; *str; str++)
+	{
+		if ('\r' == *str)
+			printf("\\r");
+		else if ('\n' == *str)
+			printf("\\n");
+		else
+			putchar(*str);
+	}
+}
+
+/* Fetch a string column in pieces of bufsize - 1 bytes */
+static void
+print_pieces(HSTMT hstmt, SQLUSMALLINT colno, SQLLEN bufsize)
+{
+	SQLRETURN	rc;
+	SQLLEN		ind;
+	char		buf[100];
+
+	while (SQL_SUCCEEDED(rc = SQLGetData(hstmt, colno, SQL_C_CHAR, buf, bufsize, &ind)))
+	{
+		printf("  piece \"");
+		print_escaped(buf);
+		printf("\", SQLGetData claims %d%s\n", (int) ind,
+			   SQL_SUCCESS_WITH_INFO == rc ? ", truncated" : "");
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+}
+
+/* Send a parameter and show the CRs and LFs the server got */
+static void
+send_param(HSTMT hstmt, const char *value)
+{
+	SQLRETURN	rc;
+	char		buf[100];
+	SQLLEN		ind;
+
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR,
+						  20, 0, (SQLPOINTER) value, SQL_NTS, NULL);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT replace(replace(?::text, chr(13), '<CR>'), chr(10), '<LF>')", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("sent \"");
+	print_escaped(value);
+	printf("\", the server got \"%s\"\n", buf);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+}
+
 int main(int argc, char **argv)
 {
 	SQLRETURN rc;
@@ -105,6 +163,43 @@ int main(int argc, char **argv)
 	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
 	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
 
+	/*
+	 * Check the converted strings themselves: only the LFs without a CR
+	 * before them get one, wherever they are.
+	 */
+	printf("reading strings with and without linefeeds...\n");
+	sql = "SELECT 'bare' || chr(10) || 'lf', 'crlf' || chr(13) || chr(10) || 'kept', "
+		"chr(10) || 'leading', 'no linefeed', "
+		"'line1' || chr(10) || 'line2' || chr(13) || chr(10) || 'line3' || chr(10)";
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+
+	for (i = 1; i <= 4; i++)
+	{
+		rc = SQLGetData(hstmt, i, SQL_C_CHAR, buf, sizeof(buf), &ccharlen);
+		CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+		printf("\"");
+		print_escaped(buf);
+		printf("\", SQLGetData claims %d\n", (int) ccharlen);
+	}
+
+	/* the pieces split the added CR from its LF */
+	printf("reading in pieces of 6 bytes...\n");
+	print_pieces(hstmt, 5, 7);
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* and the other way round, CR+LF -> LF */
+	printf("\nsending parameters...\n");
+	send_param(hstmt, "crlf\r\nsqueezed");
+	send_param(hstmt, "bare\nlf");
+	send_param(hstmt, "bare\rcr");
+	send_param(hstmt, "no linefeed");
+
 	/* Clean up */
 	test_disconnect();
 
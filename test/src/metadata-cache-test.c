@@ -0,0 +1,106 @@
+/*
+ * Test the process-wide cache of table column information
+ * (MetadataCacheTTL).
+ *
+ * The nullability reported for a parsed statement comes from the column
+ * information, so a stale cache entry shows up as a wrong nullability.
+ * The TTL is long enough never to expire during the test: the entries
+ * must be invalidated by the changes of the table themselves.
+ * The main connection stays open so that the driver, and the cache with
+ * it, isn't unloaded between the lookups of the other connections.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+#define	CONN_OPTIONS	"Parse=1;MetadataCacheTTL=3600"
+
+static void
+run_sql(const char *sql)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", conn);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+}
+
+/*
+ * Print the result set metadata of the table seen by a new connection,
+ * which doesn't have the per-connection column information yet.
+ */
+static void
+print_table_meta(void)
+{
+	SQLRETURN	rc;
+	HDBC		hdbc = SQL_NULL_HDBC;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	char		dsn[1024];
+
+	snprintf(dsn, sizeof(dsn), "DSN=%s;%s", get_test_dsn(), CONN_OPTIONS);
+	rc = SQLAllocHandle(SQL_HANDLE_DBC, env, &hdbc);
+	CHECK_CONN_RESULT(rc, "SQLAllocHandle failed", conn);
+	rc = SQLDriverConnect(hdbc, NULL, (SQLCHAR *) dsn, SQL_NTS,
+						  NULL, 0, NULL, SQL_DRIVER_NOPROMPT);
+	CHECK_CONN_RESULT(rc, "SQLDriverConnect failed", hdbc);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt);
+	CHECK_CONN_RESULT(rc, "failed to allocate stmt handle", hdbc);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, t FROM metadata_cache_test", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result_meta(hstmt);
+	rc = SQLFreeHandle(SQL_HANDLE_STMT, hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFreeHandle failed", hstmt);
+
+	rc = SQLDisconnect(hdbc);
+	CHECK_CONN_RESULT(rc, "SQLDisconnect failed", hdbc);
+	rc = SQLFreeHandle(SQL_HANDLE_DBC, hdbc);
+	CHECK_CONN_RESULT(rc, "SQLFreeHandle failed", hdbc);
+}
+
+int main(int argc, char **argv)
+{
+	test_connect_ext(CONN_OPTIONS);
+
+	run_sql("DROP TABLE IF EXISTS metadata_cache_test");
+	run_sql("CREATE TABLE metadata_cache_test (id int4 NOT NULL, t varchar(20))");
+
+	printf("-- first lookup\n");
+	print_table_meta();
+
+	printf("-- second lookup\n");
+	print_table_meta();
+
+	/* schema changes the driver doesn't see the command of */
+	run_sql("DO $$ BEGIN ALTER TABLE metadata_cache_test ALTER COLUMN t SET NOT NULL; END $$");
+
+	printf("-- after SET NOT NULL, t is not nullable\n");
+	print_table_meta();
+
+	run_sql("DO $$ BEGIN ALTER TABLE metadata_cache_test ALTER COLUMN t TYPE varchar(30); END $$");
+
+	printf("-- after ALTER COLUMN TYPE, t is varchar(30)\n");
+	print_table_meta();
+
+	run_sql("DO $$ BEGIN DROP TABLE metadata_cache_test; CREATE TABLE metadata_cache_test (id int4, t varchar(20) NOT NULL); END $$");
+
+	printf("-- after re-creating the table, id is nullable\n");
+	print_table_meta();
+
+	run_sql("ALTER TABLE metadata_cache_test ALTER COLUMN t DROP NOT NULL");
+
+	printf("-- after ALTER TABLE, t is nullable\n");
+	print_table_meta();
+
+	run_sql("DROP TABLE metadata_cache_test");
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
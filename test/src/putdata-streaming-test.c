@@ -0,0 +1,161 @@
+/*
+ * Test streaming bytea data-at-execution parameters through a temporary
+ * large object (PutDataStreaming).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	DATA_LENGTH	9000
+#define	PIECE_SIZE	3000
+
+static unsigned char data[DATA_LENGTH];
+
+static int
+count_large_objects(HSTMT hstmt)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	count = -1;
+	SQLLEN		ind;
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT count(*) FROM pg_catalog.pg_largeobject_metadata", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, &count, sizeof(count), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	return (int) count;
+}
+
+/* Executes the insert and returns after the first SQLParamData */
+static void
+start_insert(HSTMT hstmt, int id, SQLLEN *cbParam)
+{
+	SQLRETURN	rc;
+	PTR			paramid = NULL;
+	char		sql[100];
+
+	*cbParam = SQL_DATA_AT_EXEC;
+	rc = SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT,
+						  SQL_C_BINARY,	/* value type */
+						  SQL_VARBINARY, /* param type */
+						  DATA_LENGTH,	/* column size */
+						  0,			/* dec digits */
+						  (void *) 1,	/* param value ptr. For a data-at-exec
+										 * param, this is a "parameter id" */
+						  0,			/* buffer len */
+						  cbParam		/* StrLen_or_IndPtr */);
+	CHECK_STMT_RESULT(rc, "SQLBindParameter failed", hstmt);
+
+	snprintf(sql, sizeof(sql), "INSERT INTO putdata_stream_tab VALUES (%d, ?)", id);
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) sql, SQL_NTS);
+	if (rc != SQL_NEED_DATA)
+		CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLParamData(hstmt, &paramid);
+	if (rc != SQL_NEED_DATA || paramid != (void *) 1)
+	{
+		print_diag("SQLParamData didn't ask for the parameter", SQL_HANDLE_STMT, hstmt);
+		exit(1);
+	}
+}
+
+/*
+ * With UseServerSidePrepare=0 the values are streamed. With server-side
+ * prepare the parameters are bound, so the values are buffered instead.
+ * Either way the data must arrive intact and no large object is left.
+ */
+static void
+run_tests(char *options)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	static unsigned char buf[DATA_LENGTH * 2];
+	SQLLEN		cbParam, ind;
+	PTR			paramid;
+	int			i, lo_count;
+
+	printf("testing with %s\n", options);
+	test_connect_ext(options);
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "CREATE TEMPORARY TABLE putdata_stream_tab (id int4, b bytea)", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	lo_count = count_large_objects(hstmt);
+
+	/**** Stream a value in pieces ****/
+	printf("streaming a bytea value...\n");
+	start_insert(hstmt, 1, &cbParam);
+	for (i = 0; i < DATA_LENGTH; i += PIECE_SIZE)
+	{
+		rc = SQLPutData(hstmt, data + i, PIECE_SIZE);
+		CHECK_STMT_RESULT(rc, "SQLPutData failed", hstmt);
+	}
+	paramid = NULL;
+	rc = SQLParamData(hstmt, &paramid);
+	CHECK_STMT_RESULT(rc, "SQLParamData failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT b FROM putdata_stream_tab WHERE id = 1", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	rc = SQLFetch(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLFetch failed", hstmt);
+	rc = SQLGetData(hstmt, 1, SQL_C_BINARY, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	printf("got %d bytes, %s\n", (int) ind,
+		   DATA_LENGTH == ind && memcmp(buf, data, DATA_LENGTH) == 0 ? "data matches" : "data differs");
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	printf("large objects left: %d\n", count_large_objects(hstmt) - lo_count);
+
+	/**** Cancel in the middle of a value ****/
+	printf("cancelling a streamed value...\n");
+	start_insert(hstmt, 2, &cbParam);
+	rc = SQLPutData(hstmt, data, PIECE_SIZE);
+	CHECK_STMT_RESULT(rc, "SQLPutData failed", hstmt);
+	rc = SQLCancel(hstmt);
+	CHECK_STMT_RESULT(rc, "SQLCancel failed", hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_RESET_PARAMS);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT id, length(b) FROM putdata_stream_tab ORDER BY id", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+	print_result(hstmt);
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	printf("large objects left: %d\n", count_large_objects(hstmt) - lo_count);
+
+	/* Clean up */
+	test_disconnect();
+}
+
+int main(int argc, char **argv)
+{
+	int			i;
+
+	for (i = 0; i < DATA_LENGTH; i++)
+		data[i] = (unsigned char) (i % 253);
+
+	run_tests("PutDataStreaming=1;UseServerSidePrepare=0");
+	run_tests("PutDataStreaming=1;UseServerSidePrepare=1");
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * Test a result bigger than ResultMemoryLimit, whose values are moved
+ * to a temporary file, and scroll back over it with SQLFetchScroll.
+ * SQL_ATTR_PGOPT_SPILLED_BYTES tells whether the values really went to
+ * the file. Nothing spills on Windows, see result-memory-limit_1.out.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common.h"
+
+#define	NUM_ROWS	5000
+#define	VALUE_LEN	1000	/* 5000 rows of 1000 bytes pass the 1MB limit */
+
+#define SQL_ATTR_PGOPT_SPILLED_BYTES	65554
+
+static SQLBIGINT
+get_spilled_bytes(void)
+{
+	SQLRETURN	rc;
+	SQLBIGINT	spilled = -1;
+
+	rc = SQLGetConnectAttr(conn, SQL_ATTR_PGOPT_SPILLED_BYTES, &spilled, 0, NULL);
+	CHECK_CONN_RESULT(rc, "SQLGetConnectAttr failed", conn);
+	return spilled;
+}
+
+static int
+check_row(HSTMT hstmt, SQLINTEGER *id)
+{
+	SQLRETURN	rc;
+	static char	buf[VALUE_LEN + 1];
+	SQLLEN		ind;
+	int			i;
+
+	rc = SQLGetData(hstmt, 1, SQL_C_SLONG, id, sizeof(*id), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	rc = SQLGetData(hstmt, 2, SQL_C_CHAR, buf, sizeof(buf), &ind);
+	CHECK_STMT_RESULT(rc, "SQLGetData failed", hstmt);
+	if (VALUE_LEN != ind)
+		return 0;
+	for (i = 0; i < VALUE_LEN; i++)
+	{
+		if (buf[i] != 'A' + *id % 26)
+			return 0;
+	}
+	return 1;
+}
+
+static void
+fetch_and_print(HSTMT hstmt, SQLSMALLINT orientation, SQLLEN offset, const char *label)
+{
+	SQLRETURN	rc;
+	SQLINTEGER	id;
+	int			ok;
+
+	rc = SQLFetchScroll(hstmt, orientation, offset);
+	CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	ok = check_row(hstmt, &id);
+	printf("%s: row %d, %s\n", label, (int) id, ok ? "value matches" : "value differs");
+}
+
+int main(int argc, char **argv)
+{
+	SQLRETURN	rc;
+	HSTMT		hstmt = SQL_NULL_HSTMT;
+	SQLINTEGER	id;
+	SQLBIGINT	spilled;
+	int			nrows = 0, nbad = 0;
+
+	test_connect_ext("ResultMemoryLimit=1;UseDeclareFetch=0");
+
+	rc = SQLAllocHandle(SQL_HANDLE_STMT, conn, &hstmt);
+	if (!SQL_SUCCEEDED(rc))
+	{
+		print_diag("failed to allocate stmt handle", SQL_HANDLE_DBC, conn);
+		exit(1);
+	}
+
+	rc = SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+						(SQLPOINTER) SQL_CURSOR_STATIC, 0);
+	CHECK_STMT_RESULT(rc, "SQLSetStmtAttr failed", hstmt);
+
+	printf("spilled bytes before the query: %d\n", (int) get_spilled_bytes());
+	rc = SQLExecDirect(hstmt, (SQLCHAR *) "SELECT g, repeat(chr(65 + g % 26), 1000) FROM generate_series(1, 5000) g ORDER BY g", SQL_NTS);
+	CHECK_STMT_RESULT(rc, "SQLExecDirect failed", hstmt);
+
+	/* only about 1MB of the 5MB of values may stay in memory */
+	spilled = get_spilled_bytes();
+	printf("values spilled to the file: %s\n",
+		   spilled >= (SQLBIGINT) NUM_ROWS * VALUE_LEN / 2 ? "yes" : "no");
+
+	/* read everything forward */
+	while (SQL_SUCCEEDED(rc = SQLFetchScroll(hstmt, SQL_FETCH_NEXT, 0)))
+	{
+		nrows++;
+		if (!check_row(hstmt, &id) || id != nrows)
+			nbad++;
+	}
+	if (SQL_NO_DATA != rc)
+		CHECK_STMT_RESULT(rc, "SQLFetchScroll failed", hstmt);
+	printf("read %d rows forward, %d differ\n", nrows, nbad);
+
+	/* and scroll back over the values in the temporary file */
+	fetch_and_print(hstmt, SQL_FETCH_FIRST, 0, "first");
+	fetch_and_print(hstmt, SQL_FETCH_ABSOLUTE, 2500, "absolute 2500");
+	fetch_and_print(hstmt, SQL_FETCH_PRIOR, 0, "prior");
+	fetch_and_print(hstmt, SQL_FETCH_RELATIVE, -1000, "relative -1000");
+	fetch_and_print(hstmt, SQL_FETCH_LAST, 0, "last");
+
+	rc = SQLFreeStmt(hstmt, SQL_CLOSE);
+	CHECK_STMT_RESULT(rc, "SQLFreeStmt failed", hstmt);
+
+	/* Clean up */
+	test_disconnect();
+
+	return 0;
+}
@@ -282,6 +282,8 @@ MYPRINTF(DETAIL_LOG_LEVEL, " string=%s", utf8str);
 		bufcount = 0;
 	if (ilen < 0)
 		ilen = strlen(utf8str);
+	if (lfconv && NULL == memchr(utf8str, PG_LINEFEED, ilen))
+		lfconv = FALSE;
 	for (i = 0, ocount = 0, str = (SQLCHAR *) utf8str; i < ilen && *str;)
 	{
 		if ((*str & 0x80) == 0)
@@ -555,6 +557,8 @@ MYLOG(99, " string=%s\n", utf8str);
 		bufcount = 0;
 	if (ilen < 0)
 		ilen = strlen(utf8str);
+	if (lfconv && NULL == memchr(utf8str, PG_LINEFEED, ilen))
+		lfconv = FALSE;
 	for (i = 0, ocount = 0, str = (SQLCHAR *) utf8str; i < ilen && *str;)
 	{
 		if ((*str & 0x80) == 0)
@@ -904,6 +908,8 @@ SQLLEN	mbstoc16_lf(char16_t *c16dt, const char *c8dt, size_t n, BOOL lf_conv)
 	mbstate_t	mbst = initial_state;
 
 MYLOG(MIN_LOG_LEVEL, " c16dt=%p size=" FORMAT_SIZE_T "\n", c16dt, n);
+	if (lf_conv && NULL == strchr(c8dt, PG_LINEFEED))
+		lf_conv = FALSE;
 	for (i = 0, cdt = c8dt; i < n || (!c16dt); i++)
 	{
 		if (lf_conv && PG_LINEFEED == *cdt && i > 0 && PG_CARRIAGE_RETURN != cdt[-1])